@@ -0,0 +1,104 @@
+#include "benchmark.hpp"
+
+namespace
+{
+    // Nearest rank, samples are sorted
+    float getPercentile(const std::vector<float>& samples, float percentile)
+    {
+        const auto rank = static_cast<std::size_t>(std::ceil(percentile / 100.0f * samples.size()));
+        return samples[std::clamp<std::size_t>(rank, 1, samples.size()) - 1];
+    }
+
+    void writeString(std::ostream& os, std::string_view string)
+    {
+        os << '"';
+        for (const auto c : string)
+        {
+            if (c == '"' || c == '\\')
+                os << '\\';
+            os << c;
+        }
+        os << '"';
+    }
+
+    void writeStatistics(std::ostream& os, const Statistics& statistics)
+    {
+        os << "{\"samples\":" << statistics.numSamples << ",\"mean\":" << statistics.mean
+           << ",\"min\":" << statistics.min << ",\"max\":" << statistics.max << ",\"p50\":" << statistics.p50
+           << ",\"p90\":" << statistics.p90 << ",\"p95\":" << statistics.p95 << ",\"p99\":" << statistics.p99 << '}';
+    }
+} // namespace
+
+Statistics Statistics::compute(std::vector<float> samples)
+{
+    std::erase_if(samples, [](float sample) { return sample < 0.0f; });
+    if (samples.empty())
+        return {};
+
+    std::sort(samples.begin(), samples.end());
+
+    return {
+        .numSamples = static_cast<uint32_t>(samples.size()),
+        .mean       = std::accumulate(samples.begin(), samples.end(), 0.0f) / samples.size(),
+        .min        = samples.front(),
+        .max        = samples.back(),
+        .p50        = getPercentile(samples, 50.0f),
+        .p90        = getPercentile(samples, 90.0f),
+        .p95        = getPercentile(samples, 95.0f),
+        .p99        = getPercentile(samples, 99.0f),
+    };
+}
+
+void BenchmarkReport::writeJSON(std::ostream& os) const
+{
+    os << "{\"label\":";
+    writeString(os, label);
+    os << ",\"gl\":{\"vendor\":";
+    writeString(os, glVendor);
+    os << ",\"renderer\":";
+    writeString(os, glRenderer);
+    os << ",\"version\":";
+    writeString(os, glVersion);
+    os << "},\"sceneLoadMs\":" << sceneLoadTime;
+
+    os << ",\"micro\":[";
+    for (std::size_t i = 0; i < microBenchmarks.size(); ++i)
+    {
+        const auto& result = microBenchmarks[i];
+        os << (i > 0 ? "," : "") << "\n{\"name\":";
+        writeString(os, result.name);
+        os << ",\"ms\":";
+        writeStatistics(os, result.time);
+        os << '}';
+    }
+
+    os << "],\"scenes\":[";
+    for (std::size_t i = 0; i < sceneBenchmarks.size(); ++i)
+    {
+        const auto& result = sceneBenchmarks[i];
+        os << (i > 0 ? "," : "") << "\n{\"path\":";
+        writeString(os, result.path);
+        os << ",\"frames\":" << result.numFrames << ",\"frameMs\":";
+        writeStatistics(os, result.frameTime);
+        os << ",\"cpuMs\":";
+        writeStatistics(os, result.cpuTime);
+        os << ",\"gpuMs\":";
+        writeStatistics(os, result.gpuTime);
+        os << ",\"drawCalls\":" << result.numDrawCalls << ",\"dispatches\":" << result.numDispatches
+           << ",\"uploadedBytes\":" << result.uploadedBytes
+           << ",\"transientAllocations\":" << result.numTransientAllocations << ",\"passes\":[";
+        for (std::size_t p = 0; p < result.passes.size(); ++p)
+        {
+            const auto& pass = result.passes[p];
+            os << (p > 0 ? "," : "") << "{\"name\":";
+            writeString(os, pass.name);
+            os << ",\"cpuMs\":";
+            writeStatistics(os, pass.cpuTime);
+            os << ",\"gpuMs\":";
+            writeStatistics(os, pass.gpuTime);
+            os << '}';
+        }
+        os << "]}";
+    }
+    os << "]}\n";
+}
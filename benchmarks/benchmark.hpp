@@ -0,0 +1,96 @@
+#pragma once
+
+#include "vgfw.hpp"
+
+// Summary of a set of samples, in milliseconds
+struct Statistics
+{
+    uint32_t numSamples {0};
+
+    float mean {0.0f};
+    float min {0.0f};
+    float max {0.0f};
+    float p50 {0.0f};
+    float p90 {0.0f};
+    float p95 {0.0f};
+    float p99 {0.0f};
+
+    // Negative samples (unknown GPU times) are left out
+    static Statistics compute(std::vector<float> samples);
+};
+
+struct MicroBenchmarkResult
+{
+    std::string name;
+    Statistics  time;
+};
+
+struct PassResult
+{
+    std::string name;
+    Statistics  cpuTime;
+    Statistics  gpuTime;
+};
+
+struct SceneBenchmarkResult
+{
+    std::string path;
+    uint32_t    numFrames {0};
+
+    Statistics frameTime; // Wall clock, from the start of a frame to present returning
+    Statistics cpuTime;   // Between renderer::beginFrame and endFrame
+    Statistics gpuTime;
+
+    std::vector<PassResult> passes; // In the order they ran
+
+    // Per frame averages
+    float numDrawCalls {0.0f};
+    float numDispatches {0.0f};
+    float uploadedBytes {0.0f};
+    float numTransientAllocations {0.0f};
+};
+
+struct BenchmarkReport
+{
+    std::string label; // E.g. the commit, for comparing reports
+    std::string glVendor;
+    std::string glRenderer;
+    std::string glVersion;
+
+    float sceneLoadTime {-1.0f}; // Milliseconds, < 0 when the scene benchmarks did not run
+
+    std::vector<MicroBenchmarkResult> microBenchmarks;
+    std::vector<SceneBenchmarkResult> sceneBenchmarks;
+
+    void writeJSON(std::ostream&) const;
+};
+
+// Times fn numIterations times, after numWarmups untimed runs. setup runs untimed before each, GL work still in
+// flight is finished before the clock starts
+template<typename Setup, typename Fn>
+Statistics measure(uint32_t numWarmups, uint32_t numIterations, Setup&& setup, Fn&& fn)
+{
+    using Milliseconds = std::chrono::duration<float, std::milli>;
+
+    std::vector<float> samples;
+    samples.reserve(numIterations);
+    for (uint32_t i = 0; i < numWarmups + numIterations; ++i)
+    {
+        setup();
+        glFinish();
+
+        const auto begin = vgfw::time::Clock::now();
+        fn();
+        const auto end = vgfw::time::Clock::now();
+
+        if (i >= numWarmups)
+            samples.push_back(Milliseconds {end - begin}.count());
+    }
+    return Statistics::compute(std::move(samples));
+}
+
+template<typename Fn>
+Statistics measure(uint32_t numWarmups, uint32_t numIterations, Fn&& fn)
+{
+    return measure(numWarmups, numIterations, [] {}, std::forward<Fn>(fn));
+}
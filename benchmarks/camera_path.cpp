@@ -0,0 +1,86 @@
+#include "camera_path.hpp"
+
+#define GLM_ENABLE_EXPERIMENTAL
+#include <glm/gtx/spline.hpp>
+
+CameraKey CameraPath::sample(float t) const
+{
+    assert(!keys.empty());
+    if (keys.size() == 1)
+        return keys.front();
+
+    const auto numSegments = static_cast<uint32_t>(keys.size() - 1);
+    const auto position    = std::clamp(t, 0.0f, 1.0f) * numSegments;
+    const auto segment     = std::min(static_cast<uint32_t>(position), numSegments - 1);
+    const auto s           = position - segment;
+
+    // The end keys are repeated, so the path starts and stops on them
+    const auto& k0 = keys[segment > 0 ? segment - 1 : 0];
+    const auto& k1 = keys[segment];
+    const auto& k2 = keys[segment + 1];
+    const auto& k3 = keys[std::min(segment + 2, numSegments)];
+
+    const auto angles = glm::catmullRom(glm::vec2 {k0.yaw, k0.pitch},
+                                        glm::vec2 {k1.yaw, k1.pitch},
+                                        glm::vec2 {k2.yaw, k2.pitch},
+                                        glm::vec2 {k3.yaw, k3.pitch},
+                                        s);
+    return {
+        .position = glm::catmullRom(k0.position, k1.position, k2.position, k3.position, s),
+        .yaw      = angles.x,
+        .pitch    = angles.y,
+    };
+}
+
+void CameraPath::apply(float t, Camera& camera, const std::shared_ptr<vgfw::window::Window>& window) const
+{
+    const auto key       = sample(t);
+    camera.data.position = key.position;
+    camera.yaw           = key.yaw;
+    camera.pitch         = key.pitch;
+    camera.updateData(window);
+}
+
+const std::vector<CameraPath>& getSponzaCameraPaths()
+{
+    // clang-format off
+    static const std::vector<CameraPath> paths {
+        {
+            .name = "atrium",
+            .keys = {
+                {.position = {-1150, 200, -45}, .yaw = 90},
+                {.position = {-400, 250, 0}, .yaw = 80, .pitch = -10},
+                {.position = {400, 300, 0}, .yaw = 100, .pitch = -20},
+                {.position = {1100, 200, -45}, .yaw = 270},
+            },
+        },
+        {
+            .name = "colonnades",
+            .keys = {
+                {.position = {-1100, 150, 420}, .yaw = 90},
+                {.position = {1000, 150, 420}, .yaw = 90},
+                {.position = {1100, 150, -480}, .yaw = 270, .pitch = 5},
+                {.position = {-1100, 150, -480}, .yaw = 270},
+            },
+        },
+        {
+            .name = "upper_gallery",
+            .keys = {
+                {.position = {-1100, 650, 430}, .yaw = 90, .pitch = 10},
+                {.position = {0, 650, 430}, .yaw = 150, .pitch = 15},
+                {.position = {1000, 650, 430}, .yaw = 200, .pitch = 10},
+                {.position = {1000, 700, -450}, .yaw = 300, .pitch = 20},
+            },
+        },
+        {
+            .name = "overview",
+            .keys = {
+                {.position = {-1300, 1100, 0}, .yaw = 90, .pitch = 35},
+                {.position = {0, 1300, -300}, .yaw = 45, .pitch = 60},
+                {.position = {1300, 1100, 0}, .yaw = 270, .pitch = 35},
+            },
+        },
+    };
+    // clang-format on
+    return paths;
+}
@@ -0,0 +1,24 @@
+#pragma once
+
+#include "camera.hpp"
+
+struct CameraKey
+{
+    glm::vec3 position;
+    float     yaw {0.0f}; // Degrees, as Camera
+    float     pitch {0.0f};
+};
+
+// Scripted camera motion, sampled by frame rather than by time so that every run sees the same views
+struct CameraPath
+{
+    std::string            name;
+    std::vector<CameraKey> keys; // Evenly spaced over the path, Catmull-Rom in between
+
+    // t is in [0, 1]
+    CameraKey sample(float t) const;
+    void      apply(float t, Camera& camera, const std::shared_ptr<vgfw::window::Window>& window) const;
+};
+
+// Walks through the atrium, along both colonnades and around the upper gallery
+const std::vector<CameraPath>& getSponzaCameraPaths();
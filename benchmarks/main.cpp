@@ -0,0 +1,193 @@
+#define VGFW_IMPLEMENTATION
+#include "vgfw.hpp"
+
+#include "micro_benchmarks.hpp"
+#include "scene_benchmark.hpp"
+
+#include <charconv>
+#include <iomanip>
+
+namespace
+{
+    struct Options
+    {
+        uint32_t numFrames {600};
+        uint32_t numWarmupFrames {60};
+        uint32_t width {1920};
+        uint32_t height {1080};
+
+        std::filesystem::path modelPath {"assets/models/Sponza/glTF/Sponza.gltf"};
+        std::filesystem::path outputPath {"benchmark_results.json"};
+        std::string           label;
+        std::string           filter;
+
+        bool runMicroBenchmarks {true};
+        bool runSceneBenchmarks {true};
+    };
+
+    void printUsage()
+    {
+        std::cout << "Usage: benchmarks [options]\n"
+                     "  --frames <n>       Measured frames per camera path (600)\n"
+                     "  --warmup <n>       Frames rendered before measuring (60)\n"
+                     "  --width <n>        Resolution of the hidden window (1920)\n"
+                     "  --height <n>       (1080)\n"
+                     "  --model <path>     Model of the scene benchmarks (Sponza)\n"
+                     "  --output <path>    JSON report (benchmark_results.json)\n"
+                     "  --label <text>     Stored in the report, e.g. the commit\n"
+                     "  --filter <text>    Only the benchmarks and camera paths with it in their name\n"
+                     "  --no-micro         Skip the micro benchmarks\n"
+                     "  --no-scenes        Skip the scene benchmarks\n";
+    }
+
+    bool parseNumber(std::string_view text, uint32_t& value)
+    {
+        const auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), value);
+        return error == std::errc {} && end == text.data() + text.size();
+    }
+
+    // @return false on an unknown option or a missing value
+    bool parseOptions(int argc, char* argv[], Options& options)
+    {
+        for (int i = 1; i < argc; ++i)
+        {
+            const std::string_view option {argv[i]};
+            if (option == "--no-micro")
+            {
+                options.runMicroBenchmarks = false;
+                continue;
+            }
+            if (option == "--no-scenes")
+            {
+                options.runSceneBenchmarks = false;
+                continue;
+            }
+
+            if (i + 1 == argc)
+                return false;
+            const std::string_view value {argv[++i]};
+
+            if (option == "--frames")
+            {
+                if (!parseNumber(value, options.numFrames))
+                    return false;
+            }
+            else if (option == "--warmup")
+            {
+                if (!parseNumber(value, options.numWarmupFrames))
+                    return false;
+            }
+            else if (option == "--width")
+            {
+                if (!parseNumber(value, options.width))
+                    return false;
+            }
+            else if (option == "--height")
+            {
+                if (!parseNumber(value, options.height))
+                    return false;
+            }
+            else if (option == "--model")
+                options.modelPath = value;
+            else if (option == "--output")
+                options.outputPath = value;
+            else if (option == "--label")
+                options.label = value;
+            else if (option == "--filter")
+                options.filter = value;
+            else
+                return false;
+        }
+        return options.numFrames > 0 && options.width > 0 && options.height > 0;
+    }
+
+    void printStatistics(std::string_view name, const Statistics& statistics)
+    {
+        std::cout << std::left << std::setw(56) << name << std::right << std::fixed << std::setprecision(3)
+                  << std::setw(10) << statistics.mean << std::setw(10) << statistics.p50 << std::setw(10)
+                  << statistics.p95 << std::setw(10) << statistics.p99 << '\n';
+    }
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    Options options {};
+    if (!parseOptions(argc, argv, options))
+    {
+        printUsage();
+        return -1;
+    }
+
+    // Init VGFW
+    if (!vgfw::init())
+    {
+        std::cerr << "Failed to initialize VGFW" << std::endl;
+        return -1;
+    }
+
+    // A hidden window, frames are presented without vsync so nothing waits for the display
+    auto window = vgfw::window::create(
+        {.title = "benchmarks", .width = options.width, .height = options.height, .isVisible = false});
+
+    // Programs come from the cache after the first run, startup is not what is measured
+    vgfw::renderer::init({.window = window, .programCacheDirectory = "shader_cache"});
+
+    auto& rc = vgfw::renderer::getRenderContext();
+
+    BenchmarkReport report {
+        .label      = options.label,
+        .glVendor   = reinterpret_cast<const char*>(glGetString(GL_VENDOR)),
+        .glRenderer = reinterpret_cast<const char*>(glGetString(GL_RENDERER)),
+        .glVersion  = reinterpret_cast<const char*>(glGetString(GL_VERSION)),
+    };
+
+    std::cout << std::left << std::setw(56) << "Benchmark (ms)" << std::right << std::setw(10) << "mean"
+              << std::setw(10) << "p50" << std::setw(10) << "p95" << std::setw(10) << "p99" << '\n';
+
+    if (options.runMicroBenchmarks)
+    {
+        runMicroBenchmarks(rc, options.modelPath, options.filter, report.microBenchmarks);
+        for (const auto& result : report.microBenchmarks)
+            printStatistics(result.name, result.time);
+    }
+
+    bool failed = false;
+
+    if (options.runSceneBenchmarks)
+    {
+        SceneBenchmark sceneBenchmark(window, rc);
+        if (!sceneBenchmark.load(options.modelPath))
+        {
+            std::cerr << "Failed to load " << options.modelPath << std::endl;
+            failed = true;
+        }
+        else
+        {
+            report.sceneLoadTime = sceneBenchmark.getLoadTime();
+            std::cout << "Scene load: " << report.sceneLoadTime << " ms\n";
+        }
+
+        for (const auto& path : getSponzaCameraPaths())
+        {
+            if (failed || (!options.filter.empty() && path.name.find(options.filter) == std::string::npos))
+                continue;
+
+            const auto& result = report.sceneBenchmarks.emplace_back(
+                sceneBenchmark.run(path, options.numWarmupFrames, options.numFrames));
+
+            printStatistics(result.path + " frame", result.frameTime);
+            printStatistics(result.path + " GPU", result.gpuTime);
+            for (const auto& pass : result.passes)
+                printStatistics(result.path + " GPU " + pass.name, pass.gpuTime);
+        }
+    }
+
+    std::ofstream file {options.outputPath};
+    report.writeJSON(file);
+    std::cout << "Report written to " << options.outputPath << std::endl;
+
+    // Cleanup
+    vgfw::shutdown();
+
+    return failed || !file ? -1 : 0;
+}
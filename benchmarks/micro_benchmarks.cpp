@@ -0,0 +1,257 @@
+#include "micro_benchmarks.hpp"
+
+#include <glm/gtc/constants.hpp>
+
+namespace
+{
+    using namespace vgfw;
+
+    bool matches(std::string_view name, std::string_view filter)
+    {
+        return filter.empty() || name.find(filter) != std::string_view::npos;
+    }
+
+    // An empty frame between iterations, so that uploads go through a recycled staging ring as they do when loading
+    void recycleFrame()
+    {
+        renderer::beginFrame();
+        renderer::endFrame();
+    }
+
+    // UV sphere with the attributes of an OBJ primitive, numSegments around and half as many from pole to pole
+    resource::MeshPrimitive createSphere(uint32_t numSegments)
+    {
+        const auto numRings = numSegments / 2;
+
+        resource::MeshPrimitive meshPrimitive {.name = "Sphere"};
+        auto&                   record = meshPrimitive.record;
+        for (uint32_t ring = 0; ring <= numRings; ++ring)
+        {
+            const auto v     = static_cast<float>(ring) / numRings;
+            const auto theta = v * glm::pi<float>();
+            for (uint32_t segment = 0; segment <= numSegments; ++segment)
+            {
+                const auto u   = static_cast<float>(segment) / numSegments;
+                const auto phi = u * glm::two_pi<float>();
+
+                const glm::vec3 normal {
+                    std::sin(theta) * std::cos(phi), std::cos(theta), std::sin(theta) * std::sin(phi)};
+                record.positions.push_back(normal);
+                record.normals.push_back(normal);
+                record.texcoords.push_back({u, v});
+            }
+        }
+        meshPrimitive.vertexCount = static_cast<uint32_t>(record.positions.size());
+
+        for (uint32_t ring = 0; ring < numRings; ++ring)
+        {
+            for (uint32_t segment = 0; segment < numSegments; ++segment)
+            {
+                const auto i0 = ring * (numSegments + 1) + segment;
+                const auto i1 = i0 + numSegments + 1;
+                meshPrimitive.indices.insert(meshPrimitive.indices.end(), {i0, i1, i0 + 1, i0 + 1, i1, i1 + 1});
+            }
+        }
+        return meshPrimitive;
+    }
+
+    void setSphereAttributes(renderer::VertexFormat::Builder& vertexFormatBuilder)
+    {
+        using Location = renderer::AttributeLocation;
+        using Type     = renderer::VertexAttribute::Type;
+        vertexFormatBuilder.setAttribute(Location::ePosition, {.vertType = Type::eFloat3, .offset = 0})
+            .setAttribute(Location::eNormal_Color, {.vertType = Type::eFloat3, .offset = 12})
+            .setAttribute(Location::eTexCoords, {.vertType = Type::eFloat2, .offset = 24});
+    }
+
+    void benchmarkMeshPrimitiveBuild(renderer::RenderContext&           rc,
+                                     std::string_view                   filter,
+                                     std::vector<MicroBenchmarkResult>& results)
+    {
+        // 256 x 128 quads, 33k vertices
+        const auto sphere = createSphere(256);
+
+        // Plain upload, then with every load time pass of the deferred example
+        resource::Model processingModel {
+            .meshOptimization = {.enabled = true},
+            .meshQuantization = {.enabled = true},
+            .meshLods         = {.enabled = true},
+        };
+        const std::pair<std::string, resource::Model*> variants[] = {
+            {"MeshPrimitive::build", nullptr},
+            {"MeshPrimitive::build (optimize, LODs, quantize)", &processingModel},
+        };
+
+        for (const auto& [name, ownerModel] : variants)
+        {
+            if (!matches(name, filter))
+                continue;
+
+            // The copy, and destroying the previous buffers, are not timed
+            std::optional<resource::MeshPrimitive> meshPrimitive;
+
+            const auto setup = [&] {
+                recycleFrame();
+                meshPrimitive             = sphere;
+                meshPrimitive->ownerModel = ownerModel;
+            };
+            const auto build = [&] {
+                renderer::VertexFormat::Builder vertexFormatBuilder {};
+                setSphereAttributes(vertexFormatBuilder);
+                meshPrimitive->build(vertexFormatBuilder, rc);
+            };
+            results.push_back({.name = name, .time = measure(2, 20, setup, build)});
+        }
+    }
+
+    void benchmarkLoadModel(renderer::RenderContext&           rc,
+                            const std::filesystem::path&       modelPath,
+                            std::string_view                   filter,
+                            std::vector<MicroBenchmarkResult>& results)
+    {
+        std::optional<resource::Model> model;
+
+        // Textures are decoded again on every load, none is left in the texture manager
+        const auto setup = [&] {
+            recycleFrame();
+            model.reset();
+            io::getTextureManager().clear(rc);
+            model.emplace(resource::Model {
+                .geometryArena    = std::make_shared<renderer::GeometryArena>(rc),
+                .meshOptimization = {.enabled = true},
+                .meshQuantization = {.enabled = true},
+                .meshLods         = {.enabled = true},
+            });
+        };
+        const auto load = [&] {
+            if (!io::loadModel(modelPath, *model, rc))
+                throw std::runtime_error("Failed to load " + modelPath.string());
+        };
+
+        if (matches("io::loadModel", filter))
+        {
+            io::setModelCacheDirectory({});
+            results.push_back({.name = "io::loadModel", .time = measure(1, 3, setup, load)});
+        }
+
+        // The warmup bakes the model, the timed loads map it
+        if (matches("io::loadModel (baked)", filter))
+        {
+            const auto cacheDirectory = std::filesystem::temp_directory_path() / "vgfw_benchmark_model_cache";
+            std::filesystem::remove_all(cacheDirectory);
+
+            io::setModelCacheDirectory(cacheDirectory);
+            results.push_back({.name = "io::loadModel (baked)", .time = measure(1, 5, setup, load)});
+            io::setModelCacheDirectory({});
+
+            std::filesystem::remove_all(cacheDirectory);
+        }
+
+        model.reset();
+        io::getTextureManager().clear(rc);
+    }
+
+    void benchmarkTransientResources(renderer::RenderContext&           rc,
+                                     std::string_view                   filter,
+                                     std::vector<MicroBenchmarkResult>& results)
+    {
+        using renderer::PixelFormat;
+        using namespace renderer::framegraph;
+
+        // What the deferred example acquires at 1080p: G-Buffer, scene color, Hi-Z and a few buffers
+        constexpr renderer::Extent2D kExtent {.width = 1920, .height = 1080};
+        const FrameGraphTexture::Desc textureDescs[] = {
+            {.extent = kExtent, .format = PixelFormat::eRGBA16F},
+            {.extent = kExtent, .format = PixelFormat::eRGBA16F},
+            {.extent = kExtent, .format = PixelFormat::eRGBA8_UNorm},
+            {.extent = kExtent, .format = PixelFormat::eRGB8_UNorm},
+            {.extent = kExtent, .format = PixelFormat::eRGBA8_UNorm},
+            {.extent = kExtent, .format = PixelFormat::eDepth32F},
+            {.extent = kExtent, .format = PixelFormat::eRGBA16F},
+            {.extent = kExtent, .format = PixelFormat::eRGBA8_UNorm},
+            {.extent = {.width = 1024, .height = 512}, .numMipLevels = 11, .format = PixelFormat::eR32F},
+        };
+        const FrameGraphBuffer::Desc bufferDescs[] = {
+            {.size = GLsizeiptr {64} << 10},
+            {.size = GLsizeiptr {1} << 20},
+            {.size = GLsizeiptr {4} << 20},
+        };
+
+        std::vector<renderer::Texture*> textures;
+        std::vector<renderer::Buffer*>  buffers;
+
+        const auto acquireAndRelease = [&](TransientResources& resources) {
+            for (const auto& desc : textureDescs)
+                textures.push_back(resources.acquireTexture(desc));
+            for (const auto& desc : bufferDescs)
+                buffers.push_back(resources.acquireBuffer(desc));
+
+            for (uint32_t i = 0; i < std::size(textureDescs); ++i)
+                resources.releaseTexture(textureDescs[i], textures[i]);
+            for (uint32_t i = 0; i < std::size(bufferDescs); ++i)
+                resources.releaseBuffer(bufferDescs[i], buffers[i]);
+
+            textures.clear();
+            buffers.clear();
+            resources.update(1.0f / 60.0f);
+        };
+
+        // Every acquisition served from the pools, as in a steady frame
+        if (matches("TransientResources acquire/release", filter))
+        {
+            TransientResources resources {rc};
+            results.push_back({
+                .name = "TransientResources acquire/release",
+                .time = measure(10, 1000, [&] { acquireAndRelease(resources); }),
+            });
+        }
+
+        // Every acquisition allocates, as after a resize
+        if (matches("TransientResources acquire/release (cold)", filter))
+        {
+            std::optional<TransientResources> resources;
+            results.push_back({
+                .name = "TransientResources acquire/release (cold)",
+                .time = measure(2, 20, [&] { resources.emplace(rc); }, [&] { acquireAndRelease(*resources); }),
+            });
+        }
+    }
+
+    void benchmarkBuildCascades(std::string_view filter, std::vector<MicroBenchmarkResult>& results)
+    {
+        // A single call is below the clock resolution
+        constexpr uint32_t kNumCalls = 100;
+
+        const auto name = "shadow::buildCascades (" + std::to_string(kNumCalls) + " calls)";
+        if (!matches(name, filter))
+            return;
+
+        const auto projection = glm::perspective(glm::radians(60.0f), 16.0f / 9.0f, 1.0f, 10000.0f);
+        const auto view       = glm::lookAt(glm::vec3 {-1150, 200, -45}, glm::vec3 {0, 200, -45}, glm::vec3 {0, 1, 0});
+        const auto lightDirection = glm::normalize(glm::vec3 {1.0f, -1.0f, 0.0f});
+
+        // Keeps the calls from being optimized away
+        volatile float sink {0.0f};
+
+        const auto buildCascades = [&] {
+            for (uint32_t i = 0; i < kNumCalls; ++i)
+            {
+                const auto cascades = renderer::shadow::buildCascades(
+                    1.0f, 10000.0f, projection * view, lightDirection, 4, 0.75f, 2048);
+                sink = cascades.back().splitDepth;
+            }
+        };
+        results.push_back({.name = name, .time = measure(100, 1000, buildCascades)});
+    }
+} // namespace
+
+void runMicroBenchmarks(vgfw::renderer::RenderContext&     rc,
+                        const std::filesystem::path&       modelPath,
+                        std::string_view                   filter,
+                        std::vector<MicroBenchmarkResult>& results)
+{
+    benchmarkBuildCascades(filter, results);
+    benchmarkTransientResources(rc, filter, results);
+    benchmarkMeshPrimitiveBuild(rc, filter, results);
+    benchmarkLoadModel(rc, modelPath, filter, results);
+}
@@ -0,0 +1,10 @@
+#pragma once
+
+#include "benchmark.hpp"
+
+// Appends the results of the micro benchmarks with filter in their name (all when it is empty). The model is loaded
+// by the io::loadModel ones, cold and from the baked model cache
+void runMicroBenchmarks(vgfw::renderer::RenderContext&     rc,
+                        const std::filesystem::path&       modelPath,
+                        std::string_view                   filter,
+                        std::vector<MicroBenchmarkResult>& results);
@@ -0,0 +1,256 @@
+#include "scene_benchmark.hpp"
+
+#include "uniforms/camera_uniform.hpp"
+#include "uniforms/light_uniform.hpp"
+#include "uniforms/shadow_uniform.hpp"
+
+namespace
+{
+    // Idle transients age as if at 60 Hz, so that pool evictions do not depend on the speed of the machine
+    constexpr float kFrameDelta = 1.0f / 60.0f;
+
+    constexpr uint32_t kNumLocalLights = 256;
+
+    using Milliseconds = std::chrono::duration<float, std::milli>;
+} // namespace
+
+SceneBenchmark::SceneBenchmark(const std::shared_ptr<vgfw::window::Window>& window,
+                               vgfw::renderer::RenderContext&               rc) :
+    m_Window {window}, m_RenderContext {rc},
+    m_TransientResources {rc, {.maxPooledBytes = GLsizeiptr {512} << 20}}, m_ScenePasses {rc}
+{}
+
+bool SceneBenchmark::load(const std::filesystem::path& modelPath)
+{
+    auto& rc = m_RenderContext;
+
+    m_DrawCommands.reset();
+
+    const auto begin = vgfw::time::Clock::now();
+
+    m_Model = {
+        .geometryArena    = std::make_shared<vgfw::renderer::GeometryArena>(rc),
+        .meshOptimization = {.enabled = true},
+        .meshQuantization = {.enabled = true},
+        .meshLods         = {.enabled = true},
+    };
+    vgfw::io::ModelLoader modelLoader {};
+
+    // Frames keep going while loading, as in the example, the staging ring is recycled by them
+    auto loaded = modelLoader.loadModelAsync(modelPath, m_Model);
+    while (loaded.wait_for(std::chrono::seconds {0}) != std::future_status::ready)
+    {
+        m_Window->onTick();
+        modelLoader.update(rc);
+
+        vgfw::renderer::beginFrame();
+        vgfw::renderer::endFrame();
+        vgfw::renderer::present();
+    }
+    if (!loaded.get())
+        return false;
+
+    glFinish();
+    m_LoadTime = Milliseconds {vgfw::time::Clock::now() - begin}.count();
+
+    if (vgfw::renderer::RenderContext::hasShaderDrawParameters())
+    {
+        m_DrawCommands.emplace(rc).build(m_Model);
+    }
+
+    m_Bounds = {};
+    m_Bounds.reserve(m_Model.meshPrimitives.size());
+
+    auto sceneAABB = m_Model.meshPrimitives.front().aabb.transform(m_Model.meshPrimitives.front().modelMatrix);
+    for (const auto& meshPrimitive : m_Model.meshPrimitives)
+    {
+        const auto aabb = meshPrimitive.aabb.transform(meshPrimitive.modelMatrix);
+        m_Bounds.add(aabb);
+        sceneAABB.merge(aabb);
+    }
+
+    m_EnableGpuCulling = m_DrawCommands && m_DrawCommands->getNumCommands() > 0 &&
+                         vgfw::renderer::RenderContext::hasIndirectCount();
+    m_EnableShadows = vgfw::renderer::RenderContext::hasVertexShaderLayer();
+
+    // The lights of the example, the first ones of its full set
+    m_LocalLights = scatterLocalLights(sceneAABB, LightCullingPass::kMaxLights);
+    m_LocalLights.resize(std::min<std::size_t>(kNumLocalLights, m_LocalLights.size()));
+
+    m_RetainedGraph.invalidate();
+    return true;
+}
+
+float SceneBenchmark::getLoadTime() const { return m_LoadTime; }
+
+SceneBenchmarkResult SceneBenchmark::run(const CameraPath& path, uint32_t numWarmupFrames, uint32_t numFrames)
+{
+    const auto& profiler = m_RenderContext.getProfiler();
+
+    Camera camera {};
+
+    // Pools, programs and streamed textures settle at the start of the path
+    path.apply(0.0f, camera, m_Window);
+    for (uint32_t i = 0; i < numWarmupFrames; ++i)
+        renderFrame(camera);
+    glFinish();
+
+    const auto firstFrame = profiler.getFrameIndex();
+    const auto endFrame   = firstFrame + numFrames;
+
+    std::vector<float> frameTimes, cpuTimes, gpuTimes;
+    frameTimes.reserve(numFrames);
+    cpuTimes.reserve(numFrames);
+    gpuTimes.reserve(numFrames);
+
+    struct PassSamples
+    {
+        std::string        name;
+        std::vector<float> cpuTimes, gpuTimes;
+    };
+    std::vector<PassSamples> passSamples;
+
+    SceneBenchmarkResult result {.path = path.name, .numFrames = numFrames};
+
+    // The profiler reads back one frame per frame, a few frames late
+    uint64_t   nextFrame = firstFrame;
+    const auto collect   = [&] {
+        const auto* frame = profiler.getLastFrame();
+        if (!frame || frame->index < nextFrame || frame->index >= endFrame)
+            return;
+        nextFrame = frame->index + 1;
+
+        cpuTimes.push_back(frame->cpuTime);
+        gpuTimes.push_back(frame->gpuTime);
+        for (const auto& scope : frame->scopes)
+        {
+            auto it = std::find_if(passSamples.begin(), passSamples.end(), [&scope](const PassSamples& samples) {
+                return samples.name == scope.name;
+            });
+            if (it == passSamples.end())
+            {
+                passSamples.push_back({.name = scope.name});
+                it = std::prev(passSamples.end());
+            }
+            it->cpuTimes.push_back(scope.cpuTime);
+            it->gpuTimes.push_back(scope.gpuTime);
+        }
+
+        result.numDrawCalls += frame->counters.numDrawCalls;
+        result.numDispatches += frame->counters.numDispatches;
+        result.uploadedBytes += frame->counters.uploadedBytes;
+        result.numTransientAllocations += frame->counters.numTransientAllocations;
+    };
+
+    for (uint32_t i = 0; i < numFrames; ++i)
+    {
+        path.apply(numFrames > 1 ? static_cast<float>(i) / (numFrames - 1) : 0.0f, camera, m_Window);
+        frameTimes.push_back(renderFrame(camera));
+        collect();
+    }
+
+    // Empty frames read back the last ones
+    glFinish();
+    for (uint32_t i = 0; i < vgfw::renderer::FrameProfiler::kNumFrames; ++i)
+    {
+        vgfw::renderer::beginFrame();
+        vgfw::renderer::endFrame();
+        collect();
+    }
+
+    result.frameTime = Statistics::compute(std::move(frameTimes));
+    result.cpuTime   = Statistics::compute(cpuTimes);
+    result.gpuTime   = Statistics::compute(std::move(gpuTimes));
+    for (auto& samples : passSamples)
+    {
+        result.passes.push_back({
+            .name    = std::move(samples.name),
+            .cpuTime = Statistics::compute(std::move(samples.cpuTimes)),
+            .gpuTime = Statistics::compute(std::move(samples.gpuTimes)),
+        });
+    }
+
+    if (!cpuTimes.empty())
+    {
+        const auto numCollected = static_cast<float>(cpuTimes.size());
+        result.numDrawCalls /= numCollected;
+        result.numDispatches /= numCollected;
+        result.uploadedBytes /= numCollected;
+        result.numTransientAllocations /= numCollected;
+    }
+    return result;
+}
+
+float SceneBenchmark::renderFrame(const Camera& camera)
+{
+    auto& rc = m_RenderContext;
+
+    const auto begin = vgfw::time::Clock::now();
+
+    m_Window->onTick();
+
+    const auto viewProjection = camera.data.projection * camera.data.view;
+
+    m_VisiblePrimitives.clear();
+    if (!m_DrawCommands)
+    {
+        vgfw::culling::cull(
+            vgfw::culling::Frustum::fromViewProjection(viewProjection), m_Bounds, m_VisiblePrimitives);
+    }
+
+    const vgfw::resource::LodSelection lodSelection {
+        .cameraPosition  = camera.data.position,
+        .projectionScale = m_Window->getHeight() * camera.data.projection[1][1] * 0.5f,
+    };
+    m_ScenePasses.setLodSelection(lodSelection);
+
+    // The example defaults, without shadows when it does not support them either
+    ShadowSettings shadowSettings {};
+    if (!m_EnableShadows)
+        shadowSettings.numCascades = 0;
+
+    vgfw::renderer::beginFrame();
+
+    if (m_DrawCommands)
+    {
+        m_DrawCommands->selectLods(lodSelection);
+    }
+
+    // The example defaults too, with occlusion culling wherever GPU culling works
+    const SceneGraphSettings graphSettings {
+        .resolution             = {.width = m_Window->getWidth(), .height = m_Window->getHeight()},
+        .enableGpuCulling       = m_EnableGpuCulling,
+        .enableOcclusionCulling = m_EnableGpuCulling,
+        .numCascades            = shadowSettings.numCascades,
+        .shadowMapSize          = shadowSettings.shadowMapSize,
+    };
+
+    const bool rebuildGraph = m_RetainedGraph.begin(ScenePasses::getGraphKey(graphSettings));
+    auto&      blackboard   = m_RetainedGraph.getBlackboard();
+
+    uploadCameraUniform(rc, blackboard, camera);
+    uploadLightUniform(rc, blackboard, m_Light, m_LocalLights);
+    uploadShadowUniform(rc, blackboard, camera, m_Light, shadowSettings);
+
+    if (rebuildGraph)
+    {
+        m_ScenePasses.addToGraph(m_RetainedGraph.getGraph(),
+                                 blackboard,
+                                 graphSettings,
+                                 m_Model.meshPrimitives,
+                                 m_Bounds,
+                                 m_VisiblePrimitives,
+                                 m_DrawCommands ? &*m_DrawCommands : nullptr);
+        m_RetainedGraph.compile();
+    }
+
+    m_RetainedGraph.execute(&rc, &m_TransientResources);
+
+    m_TransientResources.update(kFrameDelta);
+    vgfw::io::getTextureManager().update(rc);
+
+    vgfw::renderer::endFrame();
+    vgfw::renderer::present();
+
+    return Milliseconds {vgfw::time::Clock::now() - begin}.count();
+}
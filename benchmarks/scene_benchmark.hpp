@@ -0,0 +1,46 @@
+#pragma once
+
+#include "benchmark.hpp"
+#include "camera_path.hpp"
+#include "light.hpp"
+#include "retained_frame_graph.hpp"
+#include "scene_setup.hpp"
+
+// Renders a model with the frame graph of the deferred example, the same passes and settings, along camera paths
+class SceneBenchmark
+{
+public:
+    SceneBenchmark(const std::shared_ptr<vgfw::window::Window>&, vgfw::renderer::RenderContext&);
+
+    // @return false when the model fails to load
+    bool load(const std::filesystem::path& modelPath);
+    // Milliseconds, from the start of the load until the last upload
+    float getLoadTime() const;
+
+    SceneBenchmarkResult run(const CameraPath&, uint32_t numWarmupFrames, uint32_t numFrames);
+
+private:
+    // @return wall clock milliseconds, until present returns
+    float renderFrame(const Camera&);
+
+private:
+    std::shared_ptr<vgfw::window::Window> m_Window;
+    vgfw::renderer::RenderContext&        m_RenderContext;
+
+    vgfw::renderer::framegraph::TransientResources m_TransientResources;
+
+    ScenePasses m_ScenePasses;
+
+    vgfw::resource::Model                             m_Model;
+    std::optional<vgfw::resource::DrawCommandBuilder> m_DrawCommands;
+    vgfw::culling::BoundsList                         m_Bounds;
+    std::vector<uint32_t>                             m_VisiblePrimitives;
+    bool                                              m_EnableGpuCulling {false};
+    bool                                              m_EnableShadows {false};
+    float                                             m_LoadTime {-1.0f};
+
+    DirectionalLight        m_Light {};
+    std::vector<LocalLight> m_LocalLights;
+
+    RetainedFrameGraph m_RetainedGraph;
+};
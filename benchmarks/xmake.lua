@@ -0,0 +1,32 @@
+add_requires("shaderc", {configs = {binaryonly = true}})
+
+-- target defination, name: benchmarks
+target("benchmarks")
+    -- set target kind: executable
+    set_kind("binary")
+
+    -- the scene benchmarks render with the passes of the deferred framegraph example
+    add_includedirs(".", "$(projectdir)/examples/06-deferred-framegraph")
+
+    -- set values
+    set_values("asset_files", "assets/models/Sponza/**")
+    set_values("shader_root", "$(projectdir)/examples/06-deferred-framegraph/shaders")
+
+    -- add rules
+    add_rules("copy_assets", "preprocess_shaders")
+
+    -- add source files
+    add_files("*.cpp")
+    add_files("$(projectdir)/examples/06-deferred-framegraph/**.cpp|main.cpp")
+
+    -- add shaders
+    add_files("$(projectdir)/examples/06-deferred-framegraph/shaders/**")
+
+    -- add deps
+    add_deps("vgfw")
+
+    -- add packages
+    add_packages("shaderc")
+
+    -- set target directory
+    set_targetdir("$(buildir)/$(plat)/$(arch)/$(mode)/benchmarks")
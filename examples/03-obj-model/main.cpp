@@ -86,7 +86,7 @@ int main()
     auto& rc = vgfw::renderer::getRenderContext();
 
     // Load model
-    vgfw::resource::Model spotModel {};
+    vgfw::resource::Model spotModel {.meshOptimization = {.enabled = true}};
     if (!vgfw::io::loadModel("assets/models/spot/spot.obj", spotModel, rc))
     {
         return -1;
@@ -115,7 +115,7 @@ int main()
                                 .build();
 
     // Load texture
-    auto* spotTexture = vgfw::io::loadTexture("assets/models/spot/spot_texture.png", rc);
+    auto spotTexture = vgfw::io::loadTexture("assets/models/spot/spot_texture.png", rc);
 
     // Start time
     auto startTime = std::chrono::high_resolution_clock::now();
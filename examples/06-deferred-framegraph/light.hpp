@@ -2,9 +2,35 @@
 
 #include <glm/glm.hpp>
 
+#include <algorithm>
+#include <cmath>
+
 struct DirectionalLight
 {
     glm::vec3 direction = glm::normalize(glm::vec3(1.0f, -1.0f, 0.0f));
     float     intensity = 0.5f;
     glm::vec3 color     = {1, 1, 1};
-};
\ No newline at end of file
+};
+
+// Point or spot light, mirrors LocalLight in shaders/lib/light.glsl (std430)
+struct LocalLight
+{
+    glm::vec3 position  = {0, 0, 0};
+    float     radius    = 100.0f; // No contribution past this distance
+    glm::vec3 color     = {1, 1, 1};
+    float     intensity = 1.0f;
+    glm::vec3 direction = {0, -1, 0}; // Spot lights only
+    // Cone falloff is saturate(cos(angle) * spotScale + spotOffset), a point light keeps 0 and 1
+    float spotScale  = 0.0f;
+    float spotOffset = 1.0f;
+    float padding[3] {};
+
+    // Turns the light into a spot light, angles are in radians from the direction
+    void setCone(float innerAngle, float outerAngle)
+    {
+        const auto cosOuter = std::cos(outerAngle);
+        spotScale           = 1.0f / std::max(std::cos(innerAngle) - cosOuter, 1e-4f);
+        spotOffset          = -cosOuter * spotScale;
+    }
+};
+static_assert(sizeof(LocalLight) == 64);
@@ -1,17 +1,14 @@
 #define VGFW_IMPLEMENTATION
 #include "vgfw.hpp"
 
-#include "render_target.hpp"
+#include "retained_frame_graph.hpp"
+#include "scene_setup.hpp"
 
 #include "uniforms/camera_uniform.hpp"
 #include "uniforms/light_uniform.hpp"
+#include "uniforms/shadow_uniform.hpp"
 
-#include "pass_resource/scene_color_data.hpp"
-
-#include "passes/deferred_lighting_pass.hpp"
-#include "passes/final_composition_pass.hpp"
-#include "passes/gbuffer_pass.hpp"
-#include "passes/tonemapping_pass.hpp"
+#include "pass_resource/shadow_data.hpp"
 
 int main()
 {
@@ -26,23 +23,103 @@ int main()
     auto window = vgfw::window::create({.title = "06-deferred-framegraph"});
 
     // Init renderer
-    vgfw::renderer::init({.window = window});
+    vgfw::renderer::init({.window = window, .programCacheDirectory = "shader_cache"});
 
     // Get render context
     auto& rc = vgfw::renderer::getRenderContext();
 
-    // Create transient resources
-    vgfw::renderer::framegraph::TransientResources transientResources(rc);
+    // Create transient resources, idle ones beyond the budget go first (e.g. render targets of a previous size)
+    vgfw::renderer::framegraph::TransientResources transientResources(rc, {.maxPooledBytes = GLsizeiptr {512} << 20});
+
+    // Define render passes, their programs keep compiling while the model loads
+    ScenePasses scenePasses(rc);
+
+    // Load model, decoding runs on worker threads while we present a loading screen. Later runs map the baked copy
+    vgfw::io::setModelCacheDirectory("model_cache");
+    // Block compressed textures start small and stream in their large mips once they are drawn
+    vgfw::io::getTextureManager().setPolicy({.maxUnusedBytes = GLsizeiptr {256} << 20, .streamingBaseSize = 256});
+    vgfw::resource::Model sponza {
+        .geometryArena    = std::make_shared<vgfw::renderer::GeometryArena>(rc),
+        .meshOptimization = {.enabled = true},
+        .meshQuantization = {.enabled = true},
+        .meshLods         = {.enabled = true},
+    };
+    vgfw::io::ModelLoader modelLoader {};
+
+    auto sponzaLoaded = modelLoader.loadModelAsync("assets/models/Sponza/glTF/Sponza.gltf", sponza);
+    while (sponzaLoaded.wait_for(std::chrono::seconds {0}) != std::future_status::ready)
+    {
+        window->onTick();
+        if (window->shouldClose())
+        {
+            return 0;
+        }
+
+        modelLoader.update(rc);
+
+        vgfw::renderer::beginFrame();
+
+        rc.beginRendering({.extent = {.width = window->getWidth(), .height = window->getHeight()}},
+                          glm::vec4 {0.0f, 0.0f, 0.0f, 1.0f});
+
+        ImGui::Begin("Loading");
+        ImGui::Text("Loading Sponza...");
+        ImGui::ProgressBar(modelLoader.getProgress());
+        ImGui::End();
 
-    // Load model
-    vgfw::resource::Model sponza {};
-    if (!vgfw::io::loadModel("assets/models/Sponza/glTF/Sponza.gltf", sponza, rc))
+        vgfw::renderer::endFrame();
+
+        vgfw::renderer::present();
+    }
+
+    if (!sponzaLoaded.get())
     {
         return -1;
     }
 
+    // Record the whole model into indirect draw batches, when gl_DrawID is available
+    std::optional<vgfw::resource::DrawCommandBuilder> sponzaDrawCommands;
+    if (vgfw::renderer::RenderContext::hasShaderDrawParameters())
+    {
+        sponzaDrawCommands.emplace(rc).build(sponza);
+    }
+
+    // World space bounds of the primitives, for frustum culling
+    vgfw::culling::BoundsList sponzaBounds;
+    sponzaBounds.reserve(sponza.meshPrimitives.size());
+
+    auto sceneAABB = sponza.meshPrimitives.front().aabb.transform(sponza.meshPrimitives.front().modelMatrix);
+    for (const auto& meshPrimitive : sponza.meshPrimitives)
+    {
+        const auto aabb = meshPrimitive.aabb.transform(meshPrimitive.modelMatrix);
+        sponzaBounds.add(aabb);
+        sceneAABB.merge(aabb);
+    }
+    std::vector<uint32_t> visiblePrimitives;
+
+    // GPU culling needs the indirect path and a GPU-side draw count
+    const bool supportGpuCulling = sponzaDrawCommands && sponzaDrawCommands->getNumCommands() > 0 &&
+                                   vgfw::renderer::RenderContext::hasIndirectCount();
+    bool enableGpuCulling       = supportGpuCulling;
+    bool enableOcclusionCulling = supportGpuCulling;
+
     DirectionalLight light {};
 
+    // All cascades are rendered in one layered pass, which needs the vertex shader to pick the layer
+    const bool supportShadows = vgfw::renderer::RenderContext::hasVertexShaderLayer();
+    if (!supportShadows)
+    {
+        VGFW_WARN("Shadows are disabled, neither GL_ARB_shader_viewport_layer_array nor GL_AMD_vertex_shader_layer "
+                  "is supported");
+    }
+    bool enableShadows = supportShadows;
+    int  numCascades   = static_cast<int>(ShadowData::kMaxCascades);
+
+    // Scatter point and spot lights over the scene, binned into clusters by LightCullingPass
+    constexpr int kMaxLocalLights = LightCullingPass::kMaxLights;
+    const auto    localLights     = scatterLocalLights(sceneAABB, kMaxLocalLights);
+    int           numLocalLights  = 256;
+
     // Camera properties
     Camera camera {};
     camera.data.position = {-1150, 200, -45};
@@ -54,15 +131,20 @@ int main()
 
     vgfw::time::TimePoint lastTime = vgfw::time::Clock::now();
 
-    // Define render passes
-    GBufferPass          gBufferPass(rc);
-    DeferredLightingPass deferredLightingPass(rc);
-    TonemappingPass      tonemappingPass(rc);
-    FinalCompositionPass finalCompositionPass(rc);
-
     // Define render target
     RenderTarget renderTarget = RenderTarget::eFinal;
 
+    bool enableCompactGBuffer = false;
+
+    // Positive values switch to coarser LODs closer to the camera
+    float lodBias = 0.0f;
+
+    bool showProfiler = true;
+
+    // The graph is only set up and compiled again when its topology changes
+    RetainedFrameGraph retainedGraph;
+    bool               retainFrameGraph = true;
+
     // Main loop
     while (!window->shouldClose())
     {
@@ -78,42 +160,137 @@ int main()
 
         camera.update(window, dt);
 
-        FrameGraph           fg;
-        FrameGraphBlackboard blackboard;
+        const auto viewProjection = camera.data.projection * camera.data.view;
 
-        uploadCameraUniform(fg, blackboard, camera.data);
-        uploadLightUniform(fg, blackboard, light);
+        // Only the per-primitive path uses the CPU visible list
+        visiblePrimitives.clear();
+        if (!sponzaDrawCommands)
+        {
+            vgfw::culling::cull(
+                vgfw::culling::Frustum::fromViewProjection(viewProjection), sponzaBounds, visiblePrimitives);
+        }
 
-        // GBuffer pass
-        gBufferPass.addToGraph(
-            fg, blackboard, {.width = window->getWidth(), .height = window->getHeight()}, sponza.meshPrimitives);
+        // Read by the GBuffer pass, the indirect commands are rewritten once here
+        const vgfw::resource::LodSelection lodSelection {
+            .cameraPosition  = camera.data.position,
+            .projectionScale = window->getHeight() * camera.data.projection[1][1] * 0.5f,
+            .bias            = lodBias,
+        };
+        scenePasses.setLodSelection(lodSelection);
 
-        // Deferred Lighting pass
-        auto& sceneColor = blackboard.add<SceneColorData>();
-        sceneColor.hdr   = deferredLightingPass.addToGraph(fg, blackboard);
+        const ShadowSettings shadowSettings {.numCascades = enableShadows ? static_cast<uint32_t>(numCascades) : 0};
 
-        // Tone-mapping pass
-        sceneColor.ldr = tonemappingPass.addToGraph(fg, sceneColor.hdr);
+        vgfw::renderer::beginFrame();
 
-        // Final composition pass
-        finalCompositionPass.compose(fg, blackboard, renderTarget);
+        if (sponzaDrawCommands)
+        {
+            sponzaDrawCommands->selectLods(lodSelection);
+        }
 
-        fg.compile();
+        const SceneGraphSettings graphSettings {
+            .resolution             = {.width = window->getWidth(), .height = window->getHeight()},
+            .renderTarget           = renderTarget,
+            .enableGpuCulling       = enableGpuCulling,
+            .enableOcclusionCulling = enableOcclusionCulling,
+            .enableCompactGBuffer   = enableCompactGBuffer,
+            .numCascades            = shadowSettings.numCascades,
+            .shadowMapSize          = shadowSettings.shadowMapSize,
+        };
+        if (!retainFrameGraph)
+            retainedGraph.invalidate();
+
+        const bool rebuildGraph = retainedGraph.begin(ScenePasses::getGraphKey(graphSettings));
+        auto&      blackboard   = retainedGraph.getBlackboard();
+
+        uploadCameraUniform(rc, blackboard, camera);
+        uploadLightUniform(rc, blackboard, light, std::span {localLights}.first(numLocalLights));
+        uploadShadowUniform(rc, blackboard, camera, light, shadowSettings);
+
+        if (rebuildGraph)
+        {
+            auto& fg = retainedGraph.getGraph();
 
-        vgfw::renderer::beginFrame();
+            scenePasses.addToGraph(fg,
+                                   blackboard,
+                                   graphSettings,
+                                   sponza.meshPrimitives,
+                                   sponzaBounds,
+                                   visiblePrimitives,
+                                   sponzaDrawCommands ? &*sponzaDrawCommands : nullptr);
 
-        fg.execute(&rc, &transientResources);
+            retainedGraph.compile();
 
 #ifndef NDEBUG
-        // Built in graphviz writer.
-        std::ofstream {"DebugFrameGraph.dot"} << fg;
+            // Built in graphviz writer.
+            std::ofstream {"DebugFrameGraph.dot"} << fg;
 #endif
+        }
+
+        retainedGraph.execute(&rc, &transientResources);
 
         transientResources.update(dt);
+        vgfw::io::getTextureManager().update(rc);
 
         ImGui::Begin("Deferred (Naive) with FrameGraph");
         ImGui::SliderFloat("Camera FOV", &camera.fov, 1.0f, 179.0f);
         ImGui::Text("Press CAPSLOCK to toggle the camera (W/A/S/D/Q/E + Mouse)");
+        ImGui::SliderInt("Local Lights", &numLocalLights, 0, kMaxLocalLights);
+        ImGui::Checkbox("Compact G-Buffer", &enableCompactGBuffer);
+        ImGui::SliderFloat("LOD Bias", &lodBias, -2.0f, 4.0f);
+        ImGui::Checkbox("Frame Profiler", &showProfiler);
+        if (ImGui::Button("Export Profile (CSV)"))
+        {
+            std::ofstream file {"frame_profile.csv"};
+            rc.getProfiler().writeCSV(file);
+        }
+        ImGui::SameLine();
+        if (ImGui::Button("Export Profile (JSON)"))
+        {
+            std::ofstream file {"frame_profile.json"};
+            rc.getProfiler().writeJSON(file);
+        }
+        ImGui::Checkbox("Retained Frame Graph", &retainFrameGraph);
+
+        // Transients with disjoint lifetimes share storage, the peak is what the graph really needs
+        const auto&    transientStats = transientResources.getStats();
+        constexpr auto kMiB           = static_cast<float>(1 << 20);
+        ImGui::Text("Transient VRAM: %.1f MiB peak, %.1f MiB pooled",
+                    transientStats.peakBytes / kMiB,
+                    (transientStats.textureBytes + transientStats.bufferBytes) / kMiB);
+        ImGui::Text("Transients: %u textures (%u views), %u buffers",
+                    transientStats.numTextures,
+                    transientStats.numTextureViews,
+                    transientStats.numBuffers);
+        ImGui::Text("Pool: %llu hits, %llu misses, %llu created, %llu evicted",
+                    static_cast<unsigned long long>(transientStats.numHits),
+                    static_cast<unsigned long long>(transientStats.numMisses),
+                    static_cast<unsigned long long>(transientStats.numCreations),
+                    static_cast<unsigned long long>(transientStats.numEvictions));
+
+        const auto textureStats = vgfw::io::getTextureManager().getStats();
+        ImGui::Text("Textures: %u (%.1f MiB), %u streaming, %u unused",
+                    textureStats.numTextures,
+                    textureStats.residentBytes / kMiB,
+                    textureStats.numStreaming,
+                    textureStats.numUnused);
+
+        if (supportShadows)
+        {
+            ImGui::Checkbox("Cascaded Shadows", &enableShadows);
+            if (enableShadows)
+            {
+                ImGui::SliderInt("Cascades", &numCascades, 1, static_cast<int>(ShadowData::kMaxCascades));
+            }
+        }
+
+        if (supportGpuCulling)
+        {
+            ImGui::Checkbox("GPU Culling", &enableGpuCulling);
+            if (enableGpuCulling)
+            {
+                ImGui::Checkbox("Occlusion Culling (Hi-Z)", &enableOcclusionCulling);
+            }
+        }
 
         const char* comboItems[] = {
             "Final", "GPosition", "GNormal", "GAlbedo", "GEmissive", "GMetallicRoughnessAO", "SceneColorHDR"};
@@ -126,12 +303,18 @@ int main()
         }
         ImGui::End();
 
+        if (showProfiler)
+        {
+            vgfw::renderer::imgui::drawProfilerOverlay(rc.getProfiler());
+        }
+
         vgfw::renderer::endFrame();
 
         vgfw::renderer::present();
     }
 
     // Cleanup
+    sponzaDrawCommands.reset();
     vgfw::shutdown();
 
     return 0;
@@ -1,8 +1,14 @@
 #pragma once
 
-#include <fg/Fwd.hpp>
+#include "vgfw.hpp"
 
+// Written by uploadCameraUniform, see getOrAdd
 struct CameraData
 {
-    FrameGraphResource cameraUniform;
-};
\ No newline at end of file
+    vgfw::renderer::UniformAllocation cameraUniform;
+    glm::vec3                         position;       // For CPU side sorting
+    glm::mat4                         viewProjection; // For culling
+    glm::mat4                         inverseProjection;
+    float                             zNear;
+    float                             zFar;
+};
@@ -0,0 +1,9 @@
+#pragma once
+
+#include <fg/Fwd.hpp>
+
+struct CullingData
+{
+    FrameGraphResource commands; // Compacted copy of the DrawCommandBuilder command buffer
+    FrameGraphResource counts;   // Number of visible commands per batch
+};
@@ -4,7 +4,9 @@
 
 struct GBufferData
 {
-    FrameGraphResource position;
+    bool compact {false}; // Depth replaces position and normals are octahedral, see shaders/lib/gbuffer.glsl
+
+    FrameGraphResource position {-1};
     FrameGraphResource normal;
     FrameGraphResource albedo;
     FrameGraphResource emissive;
@@ -0,0 +1,15 @@
+#pragma once
+
+#include "vgfw.hpp"
+
+#include <fg/Fwd.hpp>
+
+struct LightClusterData
+{
+    // Grid parameters shared by culling and shading, uploaded by LightCullingPass when it executes
+    const vgfw::renderer::UniformAllocation* clustersUniform {nullptr};
+
+    FrameGraphResource lights;       // LocalLight[]
+    FrameGraphResource grid;         // {offset, count} into lightIndices, per cluster
+    FrameGraphResource lightIndices; // Indices into lights
+};
@@ -1,8 +1,14 @@
 #pragma once
 
-#include <fg/Fwd.hpp>
+#include "light.hpp"
 
+#include "vgfw.hpp"
+
+#include <span>
+
+// Written by uploadLightUniform, see getOrAdd
 struct LightData
 {
-    FrameGraphResource lightUniform;
-};
\ No newline at end of file
+    vgfw::renderer::UniformAllocation lightUniform;
+    std::span<const LocalLight>       localLights; // Binned by LightCullingPass
+};
@@ -0,0 +1,20 @@
+#pragma once
+
+#include "vgfw.hpp"
+
+#include <fg/Fwd.hpp>
+
+// Written by uploadShadowUniform, see getOrAdd
+struct ShadowData
+{
+    static constexpr uint32_t kMaxCascades {4}; // MAX_CASCADES of shaders/lib/cascades.glsl
+
+    vgfw::renderer::UniformAllocation cascadesUniform;
+    // One per cascade (none without shadows), without the near plane: casters behind the light still cast
+    std::vector<vgfw::culling::Frustum> casterFrusta;
+};
+
+struct ShadowMapData
+{
+    FrameGraphResource cascadedShadowMaps; // 2D array depth texture, one layer per cascade
+};
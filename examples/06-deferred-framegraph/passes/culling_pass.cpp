@@ -0,0 +1,87 @@
+#include "passes/culling_pass.hpp"
+#include "pass_resource/camera_data.hpp"
+#include "pass_resource/culling_data.hpp"
+#include "passes/hiz_pass.hpp"
+
+namespace
+{
+    constexpr uint32_t kLocalSize = 64;
+
+    // Matches the Culling block of cull.comp (std140)
+    struct CullingUniform
+    {
+        std::array<glm::vec4, 6> frustumPlanes;
+        glm::mat4                hiZViewProjection;
+        glm::vec2                hiZSize;
+        uint32_t                 numCommands;
+        uint32_t                 useHiZ;
+    };
+} // namespace
+
+CullingPass::CullingPass(vgfw::renderer::RenderContext& rc) : BasePass(rc)
+{
+    m_Program = m_RenderContext.createComputeProgram(vgfw::utils::readFileAllText("shaders/cull.comp"));
+}
+
+CullingPass::~CullingPass() { m_RenderContext.destroyProgram(m_Program); }
+
+void CullingPass::addToGraph(FrameGraph&                               fg,
+                             FrameGraphBlackboard&                     blackboard,
+                             const vgfw::resource::DrawCommandBuilder& drawCommands,
+                             const HiZPass*                            hiZPass)
+{
+    const auto numCommands = drawCommands.getNumCommands();
+    const auto numBatches  = static_cast<uint32_t>(drawCommands.getBatches().size());
+
+    const auto& cameraData = blackboard.get<CameraData>();
+
+    blackboard.add<CullingData>() = fg.addCallbackPass<CullingData>(
+        "Culling Pass",
+        [&](FrameGraph::Builder& builder, CullingData& data) {
+            data.commands = builder.create<vgfw::renderer::framegraph::FrameGraphBuffer>(
+                "Compacted Commands",
+                {.size = static_cast<GLsizeiptr>(numCommands * sizeof(vgfw::renderer::DrawElementsIndirectCommand))});
+            data.commands = builder.write(data.commands);
+
+            data.counts = builder.create<vgfw::renderer::framegraph::FrameGraphBuffer>(
+                "Draw Counts", {.size = static_cast<GLsizeiptr>(numBatches * sizeof(uint32_t))});
+            data.counts = builder.write(data.counts);
+        },
+        [=, &drawCommands, &cameraData, this](const CullingData& data, FrameGraphPassResources& resources, void* ctx) {
+            NAMED_DEBUG_MARKER("Culling Pass");
+            VGFW_PROFILE_GL("Culling Pass");
+            VGFW_PROFILE_NAMED_SCOPE("Culling Pass");
+
+            auto& rc = *static_cast<vgfw::renderer::RenderContext*>(ctx);
+            VGFW_TIMED_SCOPE(rc, "Culling Pass");
+
+            // Null until the Hi-Z pass ran once
+            const auto* hiZ = hiZPass ? hiZPass->getPyramid() : nullptr;
+
+            const CullingUniform cullingUniform {
+                .frustumPlanes     = vgfw::culling::Frustum::fromViewProjection(cameraData.viewProjection).planes,
+                .hiZViewProjection = hiZ ? hiZPass->getViewProjection() : glm::mat4 {1.0f},
+                .hiZSize           = hiZ ? glm::vec2 {static_cast<float>(hiZ->getExtent().width),
+                                                      static_cast<float>(hiZ->getExtent().height)} :
+                                           glm::vec2 {0.0f},
+                .numCommands       = numCommands,
+                .useHiZ            = hiZ != nullptr,
+            };
+
+            auto& counts = vgfw::renderer::framegraph::getBuffer(resources, data.counts);
+
+            const std::vector<uint32_t> zeros(numBatches, 0);
+            rc.upload(counts, 0, static_cast<GLsizeiptr>(zeros.size() * sizeof(uint32_t)), zeros.data());
+
+            rc.bindUniformBuffer(0, rc.uploadUniform(cullingUniform))
+                .bindStorageBuffer(0, drawCommands.getBoundsBuffer())
+                .bindStorageBuffer(1, drawCommands.getCommandBuffer())
+                .bindStorageBuffer(2, vgfw::renderer::framegraph::getBuffer(resources, data.commands))
+                .bindStorageBuffer(3, counts);
+            if (hiZ)
+                rc.bindTexture(0, *hiZ);
+
+            rc.dispatch(m_Program, {(numCommands + kLocalSize - 1) / kLocalSize, 1, 1})
+                .memoryBarrier(GL_COMMAND_BARRIER_BIT | GL_SHADER_STORAGE_BARRIER_BIT);
+        });
+}
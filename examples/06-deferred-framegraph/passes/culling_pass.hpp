@@ -0,0 +1,24 @@
+#pragma once
+
+#include "base_pass.hpp"
+
+class HiZPass;
+
+// Culls the commands of a DrawCommandBuilder on the GPU and adds the compacted result (CullingData) to the
+// blackboard, for GBufferPass to draw with glMultiDrawElementsIndirectCount
+class CullingPass : public BasePass
+{
+public:
+    explicit CullingPass(vgfw::renderer::RenderContext& rc);
+    ~CullingPass();
+
+    // hiZPass provides the previous frame depth for occlusion culling, pass nullptr for frustum culling only.
+    // The frustum comes from CameraData when the pass executes
+    void addToGraph(FrameGraph&                               fg,
+                    FrameGraphBlackboard&                     blackboard,
+                    const vgfw::resource::DrawCommandBuilder& drawCommands,
+                    const HiZPass*                            hiZPass);
+
+private:
+    GLuint m_Program {GL_NONE};
+};
@@ -1,34 +1,29 @@
 #include "passes/deferred_lighting_pass.hpp"
 #include "pass_resource/camera_data.hpp"
 #include "pass_resource/gbuffer_data.hpp"
+#include "pass_resource/light_cluster_data.hpp"
 #include "pass_resource/light_data.hpp"
+#include "pass_resource/shadow_data.hpp"
 
 DeferredLightingPass::DeferredLightingPass(vgfw::renderer::RenderContext& rc) : BasePass(rc)
 {
-    auto program =
-        m_RenderContext.createGraphicsProgram(vgfw::utils::readFileAllText("shaders/fullscreen.vert"),
-                                              vgfw::utils::readFileAllText("shaders/deferred_lighting.frag"));
-
-    m_Pipeline = vgfw::renderer::GraphicsPipeline::Builder {}
-                     .setShaderProgram(program)
-                     .setDepthStencil({
-                         .depthTest  = false,
-                         .depthWrite = false,
-                     })
-                     .setRasterizerState({
-                         .polygonMode = vgfw::renderer::PolygonMode::eFill,
-                         .cullMode    = vgfw::renderer::CullMode::eBack,
-                         .scissorTest = false,
-                     })
-                     .build();
+    m_Pipeline        = createPipeline("shaders/deferred_lighting.frag");
+    m_CompactPipeline = createPipeline("shaders/deferred_lighting_compact.frag");
 }
 
-DeferredLightingPass::~DeferredLightingPass() { m_RenderContext.destroy(m_Pipeline); }
+DeferredLightingPass::~DeferredLightingPass()
+{
+    m_RenderContext.destroy(m_Pipeline);
+    m_RenderContext.destroy(m_CompactPipeline);
+}
 
 FrameGraphResource DeferredLightingPass::addToGraph(FrameGraph& fg, FrameGraphBlackboard& blackboard)
 {
-    const auto [cameraUniform] = blackboard.get<CameraData>();
-    const auto [lightUniform]  = blackboard.get<LightData>();
+    const auto& cameraData    = blackboard.get<CameraData>();
+    const auto& lightData     = blackboard.get<LightData>();
+    const auto& lightClusters = blackboard.get<LightClusterData>();
+    const auto& shadowData    = blackboard.get<ShadowData>();
+    const auto* shadowMap     = blackboard.try_get<ShadowMapData>(); // Not without cascades
 
     const auto& gBuffer = blackboard.get<GBufferData>();
 
@@ -41,25 +36,31 @@ FrameGraphResource DeferredLightingPass::addToGraph(FrameGraph& fg, FrameGraphBl
     const auto& deferredLighting = fg.addCallbackPass<Data>(
         "Deferred Lighting Pass",
         [&](FrameGraph::Builder& builder, Data& data) {
-            builder.read(cameraUniform);
-            builder.read(lightUniform);
-
-            builder.read(gBuffer.position);
+            builder.read(gBuffer.compact ? gBuffer.depth : gBuffer.position);
             builder.read(gBuffer.normal);
             builder.read(gBuffer.albedo);
             builder.read(gBuffer.emissive);
             builder.read(gBuffer.metallicRoughnessAO);
 
+            builder.read(lightClusters.lights);
+            builder.read(lightClusters.grid);
+            builder.read(lightClusters.lightIndices);
+
+            if (shadowMap)
+                builder.read(shadowMap->cascadedShadowMaps);
+
             data.sceneColorHDR = builder.create<vgfw::renderer::framegraph::FrameGraphTexture>(
                 "SceneColorHDR", {.extent = extent, .format = vgfw::renderer::PixelFormat::eRGB16F});
             data.sceneColorHDR = builder.write(data.sceneColorHDR);
         },
-        [=, this](const Data& data, FrameGraphPassResources& resources, void* ctx) {
+        [=, &cameraData, &lightData, &shadowData, this](
+            const Data& data, FrameGraphPassResources& resources, void* ctx) {
             NAMED_DEBUG_MARKER("Deferred Lighting Pass");
             VGFW_PROFILE_GL("Deferred Lighting Pass");
             VGFW_PROFILE_NAMED_SCOPE("Deferred Lighting Pass");
 
             auto& rc = *static_cast<vgfw::renderer::RenderContext*>(ctx);
+            VGFW_TIMED_SCOPE(rc, "Deferred Lighting Pass");
 
             const vgfw::renderer::RenderingInfo renderingInfo {
                 .area             = {.extent = extent},
@@ -71,17 +72,46 @@ FrameGraphResource DeferredLightingPass::addToGraph(FrameGraph& fg, FrameGraphBl
 
             const auto framebuffer = rc.beginRendering(renderingInfo);
 
-            rc.bindGraphicsPipeline(m_Pipeline)
-                .bindUniformBuffer(0, vgfw::renderer::framegraph::getBuffer(resources, cameraUniform))
-                .bindUniformBuffer(1, vgfw::renderer::framegraph::getBuffer(resources, lightUniform))
-                .bindTexture(0, vgfw::renderer::framegraph::getTexture(resources, gBuffer.position))
+            // The compact layout reconstructs the position from depth
+            const auto positionOrDepth = gBuffer.compact ? gBuffer.depth : gBuffer.position;
+
+            rc.bindGraphicsPipeline(gBuffer.compact ? m_CompactPipeline : m_Pipeline)
+                .bindUniformBuffer(0, cameraData.cameraUniform)
+                .bindUniformBuffer(1, lightData.lightUniform)
+                .bindUniformBuffer(2, *lightClusters.clustersUniform)
+                .bindUniformBuffer(3, shadowData.cascadesUniform)
+                .bindStorageBuffer(0, vgfw::renderer::framegraph::getBuffer(resources, lightClusters.lights))
+                .bindStorageBuffer(1, vgfw::renderer::framegraph::getBuffer(resources, lightClusters.grid))
+                .bindStorageBuffer(2, vgfw::renderer::framegraph::getBuffer(resources, lightClusters.lightIndices))
+                .bindTexture(0, vgfw::renderer::framegraph::getTexture(resources, positionOrDepth))
                 .bindTexture(1, vgfw::renderer::framegraph::getTexture(resources, gBuffer.normal))
                 .bindTexture(2, vgfw::renderer::framegraph::getTexture(resources, gBuffer.albedo))
                 .bindTexture(3, vgfw::renderer::framegraph::getTexture(resources, gBuffer.emissive))
-                .bindTexture(4, vgfw::renderer::framegraph::getTexture(resources, gBuffer.metallicRoughnessAO))
-                .drawFullScreenTriangle()
-                .endRendering(framebuffer);
+                .bindTexture(4, vgfw::renderer::framegraph::getTexture(resources, gBuffer.metallicRoughnessAO));
+            if (shadowMap)
+                rc.bindTexture(5, vgfw::renderer::framegraph::getTexture(resources, shadowMap->cascadedShadowMaps));
+
+            rc.drawFullScreenTriangle().endRendering(framebuffer);
         });
 
     return deferredLighting.sceneColorHDR;
+}
+
+vgfw::renderer::GraphicsPipeline DeferredLightingPass::createPipeline(const char* fragmentShader)
+{
+    auto program = m_RenderContext.createGraphicsProgramAsync(vgfw::utils::readFileAllText("shaders/fullscreen.vert"),
+                                                              vgfw::utils::readFileAllText(fragmentShader));
+
+    return vgfw::renderer::GraphicsPipeline::Builder {}
+        .setShaderProgram(program)
+        .setDepthStencil({
+            .depthTest  = false,
+            .depthWrite = false,
+        })
+        .setRasterizerState({
+            .polygonMode = vgfw::renderer::PolygonMode::eFill,
+            .cullMode    = vgfw::renderer::CullMode::eBack,
+            .scissorTest = false,
+        })
+        .build();
 }
\ No newline at end of file
@@ -10,6 +10,10 @@ public:
 
     FrameGraphResource addToGraph(FrameGraph& fg, FrameGraphBlackboard& blackboard);
 
+private:
+    vgfw::renderer::GraphicsPipeline createPipeline(const char* fragmentShader);
+
 private:
     vgfw::renderer::GraphicsPipeline m_Pipeline;
+    vgfw::renderer::GraphicsPipeline m_CompactPipeline; // For GBufferData::compact
 };
\ No newline at end of file
@@ -1,30 +1,33 @@
 #include "passes/final_composition_pass.hpp"
+#include "pass_resource/camera_data.hpp"
 #include "pass_resource/gbuffer_data.hpp"
 #include "pass_resource/scene_color_data.hpp"
 
 FinalCompositionPass::FinalCompositionPass(vgfw::renderer::RenderContext& rc) : BasePass(rc)
 {
-    auto program = m_RenderContext.createGraphicsProgram(vgfw::utils::readFileAllText("shaders/fullscreen.vert"),
-                                                         vgfw::utils::readFileAllText("shaders/final.frag"));
-
-    m_Pipeline = vgfw::renderer::GraphicsPipeline::Builder {}
-                     .setShaderProgram(program)
-                     .setDepthStencil({
-                         .depthTest  = false,
-                         .depthWrite = false,
-                     })
-                     .setRasterizerState({
-                         .polygonMode = vgfw::renderer::PolygonMode::eFill,
-                         .cullMode    = vgfw::renderer::CullMode::eBack,
-                         .scissorTest = false,
-                     })
-                     .build();
+    const auto vertexShader = vgfw::utils::readFileAllText("shaders/fullscreen.vert");
+
+    m_Pipeline = createPipeline(
+        m_RenderContext.createGraphicsProgramAsync(vertexShader, vgfw::utils::readFileAllText("shaders/final.frag")));
+    m_DecodePipeline = createPipeline(m_RenderContext.createGraphicsProgramAsync(
+        vertexShader, vgfw::utils::readFileAllText("shaders/gbuffer_debug.frag")));
 }
 
-FinalCompositionPass::~FinalCompositionPass() { m_RenderContext.destroy(m_Pipeline); }
+FinalCompositionPass::~FinalCompositionPass()
+{
+    m_RenderContext.destroy(m_Pipeline);
+    m_RenderContext.destroy(m_DecodePipeline);
+}
 
 void FinalCompositionPass::compose(FrameGraph& fg, FrameGraphBlackboard& blackboard, RenderTarget renderTarget)
 {
+    if (blackboard.get<GBufferData>().compact &&
+        (renderTarget == RenderTarget::eGPosition || renderTarget == RenderTarget::eGNormal))
+    {
+        composeDecoded(fg, blackboard, renderTarget);
+        return;
+    }
+
     FrameGraphResource output {-1};
 
     switch (renderTarget)
@@ -68,10 +71,64 @@ void FinalCompositionPass::compose(FrameGraph& fg, FrameGraphBlackboard& blackbo
 
             const auto extent = resources.getDescriptor<vgfw::renderer::framegraph::FrameGraphTexture>(output).extent;
             auto&      rc     = *static_cast<vgfw::renderer::RenderContext*>(ctx);
+            VGFW_TIMED_SCOPE(rc, "Final Composition Pass");
 
             rc.beginRendering({.extent = extent}, glm::vec4 {0.0f});
             rc.bindGraphicsPipeline(m_Pipeline)
                 .bindTexture(0, vgfw::renderer::framegraph::getTexture(resources, output))
                 .drawFullScreenTriangle();
         });
-}
\ No newline at end of file
+}
+
+void FinalCompositionPass::composeDecoded(FrameGraph& fg, FrameGraphBlackboard& blackboard, RenderTarget renderTarget)
+{
+    // Matches the TARGET_ defines of gbuffer_debug.frag
+    constexpr int32_t kTargetPosition = 0;
+    constexpr int32_t kTargetNormal   = 1;
+
+    const auto& cameraData = blackboard.get<CameraData>();
+    const auto& gBuffer    = blackboard.get<GBufferData>();
+
+    const auto input  = renderTarget == RenderTarget::eGPosition ? gBuffer.depth : gBuffer.normal;
+    const auto target = renderTarget == RenderTarget::eGPosition ? kTargetPosition : kTargetNormal;
+
+    fg.addCallbackPass(
+        "Final Composition Pass",
+        [&](FrameGraph::Builder& builder, auto&) {
+            builder.read(input);
+            builder.setSideEffect();
+        },
+        [=, &cameraData, this](const auto&, FrameGraphPassResources& resources, void* ctx) {
+            NAMED_DEBUG_MARKER("Final Composition Pass");
+            VGFW_PROFILE_GL("Final Composition Pass");
+            VGFW_PROFILE_NAMED_SCOPE("Final Composition Pass");
+
+            const auto extent = resources.getDescriptor<vgfw::renderer::framegraph::FrameGraphTexture>(input).extent;
+            auto&      rc     = *static_cast<vgfw::renderer::RenderContext*>(ctx);
+            VGFW_TIMED_SCOPE(rc, "Final Composition Pass");
+
+            rc.beginRendering({.extent = extent}, glm::vec4 {0.0f});
+            rc.bindGraphicsPipeline(m_DecodePipeline)
+                .bindUniformBuffer(0, cameraData.cameraUniform)
+                .bindTexture(renderTarget == RenderTarget::eGPosition ? 0 : 1,
+                             vgfw::renderer::framegraph::getTexture(resources, input))
+                .setUniform1i("uTarget", target)
+                .drawFullScreenTriangle();
+        });
+}
+
+vgfw::renderer::GraphicsPipeline FinalCompositionPass::createPipeline(const vgfw::renderer::ProgramHandle& program)
+{
+    return vgfw::renderer::GraphicsPipeline::Builder {}
+        .setShaderProgram(program)
+        .setDepthStencil({
+            .depthTest  = false,
+            .depthWrite = false,
+        })
+        .setRasterizerState({
+            .polygonMode = vgfw::renderer::PolygonMode::eFill,
+            .cullMode    = vgfw::renderer::CullMode::eBack,
+            .scissorTest = false,
+        })
+        .build();
+}
@@ -11,6 +11,13 @@ public:
 
     void compose(FrameGraph& fg, FrameGraphBlackboard& blackboard, RenderTarget renderTarget);
 
+private:
+    // Position and normal views of the compact G-Buffer go through a decode shader
+    void composeDecoded(FrameGraph& fg, FrameGraphBlackboard& blackboard, RenderTarget renderTarget);
+
+    static vgfw::renderer::GraphicsPipeline createPipeline(const vgfw::renderer::ProgramHandle& program);
+
 private:
     vgfw::renderer::GraphicsPipeline m_Pipeline;
+    vgfw::renderer::GraphicsPipeline m_DecodePipeline;
 };
\ No newline at end of file
@@ -1,100 +1,200 @@
 #include "passes/gbuffer_pass.hpp"
 #include "pass_resource/camera_data.hpp"
+#include "pass_resource/culling_data.hpp"
 #include "pass_resource/gbuffer_data.hpp"
 
-GBufferPass::GBufferPass(vgfw::renderer::RenderContext& rc) : BasePass(rc) {}
+GBufferPass::GBufferPass(vgfw::renderer::RenderContext& rc) : BasePass(rc)
+{
+    for (const auto drawMode : {DrawMode::eDirect, DrawMode::eIndirect, DrawMode::eIndirectBindless})
+    {
+        requestProgram(drawMode, false);
+        requestProgram(drawMode, true);
+    }
+}
 
 GBufferPass::~GBufferPass()
 {
-    for (auto& [_, pipeline] : m_Pipelines)
+    // The pipelines share these
+    for (auto& [_, program] : m_Programs)
     {
-        m_RenderContext.destroy(pipeline);
+        m_RenderContext.destroy(program);
     }
 }
 
 void GBufferPass::addToGraph(FrameGraph&                                       fg,
                              FrameGraphBlackboard&                             blackboard,
                              const vgfw::renderer::Extent2D&                   resolution,
-                             const std::vector<vgfw::resource::MeshPrimitive>& meshPrimitives)
+                             const std::vector<vgfw::resource::MeshPrimitive>& meshPrimitives,
+                             const std::vector<uint32_t>&                      visiblePrimitives,
+                             const vgfw::resource::DrawCommandBuilder*         drawCommands)
 {
-    const auto [cameraUniform] = blackboard.get<CameraData>();
+    const auto& cameraData = blackboard.get<CameraData>();
+    const auto* culling    = blackboard.try_get<CullingData>();
 
     blackboard.add<GBufferData>() = fg.addCallbackPass<GBufferData>(
         "GBuffer Pass",
         [&, resolution](FrameGraph::Builder& builder, GBufferData& data) {
-            builder.read(cameraUniform);
+            if (culling)
+            {
+                builder.read(culling->commands);
+                builder.read(culling->counts);
+            }
 
-            data.position = builder.create<vgfw::renderer::framegraph::FrameGraphTexture>(
-                "Position", {.extent = resolution, .format = vgfw::renderer::PixelFormat::eRGB16F});
-            data.position = builder.write(data.position);
+            using enum vgfw::renderer::PixelFormat;
+
+            // 16 bytes per pixel (with depth) instead of 25+, RGB formats are usually padded too
+            data.compact = m_Compact;
+            if (!m_Compact)
+            {
+                data.position = builder.create<vgfw::renderer::framegraph::FrameGraphTexture>(
+                    "Position", {.extent = resolution, .format = eRGB16F});
+                data.position = builder.write(data.position);
+            }
 
             data.normal = builder.create<vgfw::renderer::framegraph::FrameGraphTexture>(
-                "Normal", {.extent = resolution, .format = vgfw::renderer::PixelFormat::eRGB16F});
+                "Normal", {.extent = resolution, .format = m_Compact ? eRG16_UNorm : eRGB16F});
             data.normal = builder.write(data.normal);
 
+            const auto materialFormat = m_Compact ? eRGBA8_UNorm : eRGB8_UNorm;
+
             data.albedo = builder.create<vgfw::renderer::framegraph::FrameGraphTexture>(
-                "Albedo", {.extent = resolution, .format = vgfw::renderer::PixelFormat::eRGB8_UNorm});
+                "Albedo", {.extent = resolution, .format = materialFormat});
             data.albedo = builder.write(data.albedo);
 
             data.emissive = builder.create<vgfw::renderer::framegraph::FrameGraphTexture>(
-                "Emissive", {.extent = resolution, .format = vgfw::renderer::PixelFormat::eRGB8_UNorm});
+                "Emissive", {.extent = resolution, .format = materialFormat});
             data.emissive = builder.write(data.emissive);
 
             data.metallicRoughnessAO = builder.create<vgfw::renderer::framegraph::FrameGraphTexture>(
-                "Metallic Roughness AO", {.extent = resolution, .format = vgfw::renderer::PixelFormat::eRGB8_UNorm});
+                "Metallic Roughness AO", {.extent = resolution, .format = materialFormat});
             data.metallicRoughnessAO = builder.write(data.metallicRoughnessAO);
 
             data.depth = builder.create<vgfw::renderer::framegraph::FrameGraphTexture>(
                 "Depth", {.extent = resolution, .format = vgfw::renderer::PixelFormat::eDepth32F});
             data.depth = builder.write(data.depth);
         },
-        [=, &meshPrimitives, this](const GBufferData& data, FrameGraphPassResources& resources, void* ctx) {
+        [=, &meshPrimitives, &visiblePrimitives, &cameraData, this](
+            const GBufferData& data, FrameGraphPassResources& resources, void* ctx) {
             NAMED_DEBUG_MARKER("GBuffer Pass");
             VGFW_PROFILE_GL("GBuffer Pass");
             VGFW_PROFILE_NAMED_SCOPE("GBuffer Pass");
 
             auto& rc = *static_cast<vgfw::renderer::RenderContext*>(ctx);
+            VGFW_TIMED_SCOPE(rc, "GBuffer Pass");
 
             constexpr glm::vec4 kBlackColor {0.0f};
             constexpr float     kFarPlane {1.0f};
 
-            vgfw::renderer::RenderingInfo renderingInfo = {
-                .area = {.extent = resolution},
-                .colorAttachments =
-                    {
-                        {.image      = vgfw::renderer::framegraph::getTexture(resources, data.position),
-                         .clearValue = kBlackColor},
-                        {.image      = vgfw::renderer::framegraph::getTexture(resources, data.normal),
-                         .clearValue = kBlackColor},
-                        {.image      = vgfw::renderer::framegraph::getTexture(resources, data.albedo),
-                         .clearValue = kBlackColor},
-                        {.image      = vgfw::renderer::framegraph::getTexture(resources, data.emissive),
-                         .clearValue = kBlackColor},
-                        {.image      = vgfw::renderer::framegraph::getTexture(resources, data.metallicRoughnessAO),
-                         .clearValue = kBlackColor},
-                    },
+            vgfw::renderer::RenderingInfo renderingInfo {
+                .area            = {.extent = resolution},
                 .depthAttachment = vgfw::renderer::AttachmentInfo {
-                    .image = vgfw::renderer::framegraph::getTexture(resources, data.depth), .clearValue = kFarPlane}};
+                    .image      = vgfw::renderer::framegraph::getTexture(resources, data.depth),
+                    .clearValue = kFarPlane,
+                },
+            };
+
+            // Attachment order matches the outputs of lib/gbuffer.glsl
+            if (!data.compact)
+            {
+                renderingInfo.colorAttachments.push_back({
+                    .image      = vgfw::renderer::framegraph::getTexture(resources, data.position),
+                    .clearValue = kBlackColor,
+                });
+            }
+            for (const auto target : {data.normal, data.albedo, data.emissive, data.metallicRoughnessAO})
+            {
+                renderingInfo.colorAttachments.push_back(
+                    {.image = vgfw::renderer::framegraph::getTexture(resources, target), .clearValue = kBlackColor});
+            }
 
             auto frameBuffer = rc.beginRendering(renderingInfo);
 
             // Draw
-            for (const auto& meshPrimitive : meshPrimitives)
+            if (drawCommands)
             {
-                rc.bindGraphicsPipeline(getPipeline(*meshPrimitive.vertexFormat))
-                    .bindUniformBuffer(0, vgfw::renderer::framegraph::getBuffer(resources, cameraUniform))
-                    .bindMeshPrimitiveMaterialBuffer(1, meshPrimitive)
-                    .bindMeshPrimitiveTextures(0, meshPrimitive)
-                    .drawMeshPrimitive(meshPrimitive);
+                const auto drawMode = drawCommands->isBindless() ? DrawMode::eIndirectBindless : DrawMode::eIndirect;
+                for (const auto& batch : drawCommands->getBatches())
+                {
+                    rc.bindGraphicsPipeline(getPipeline(*batch.vertexFormat, drawMode))
+                        .bindUniformBuffer(0, cameraData.cameraUniform)
+                        .bindStorageBuffer(0, drawCommands->getDrawDataBuffer());
+                    if (!drawCommands->isBindless())
+                        rc.bindMeshPrimitiveTextures(0, *batch.primitive);
+
+                    if (culling)
+                    {
+                        drawCommands->draw(batch,
+                                           vgfw::renderer::framegraph::getBuffer(resources, culling->commands),
+                                           vgfw::renderer::framegraph::getBuffer(resources, culling->counts));
+                    }
+                    else
+                    {
+                        drawCommands->draw(batch);
+                    }
+                }
+            }
+            else
+            {
+                // Sorted by pipeline, textures and front-to-back distance
+                m_RenderQueue.clear().reserve(visiblePrimitives.size());
+                for (const auto index : visiblePrimitives)
+                {
+                    const auto& meshPrimitive = meshPrimitives[index];
+                    const auto  center        = meshPrimitive.aabb.transform(meshPrimitive.modelMatrix).getCenter();
+
+                    m_RenderQueue.push(getPipeline(*meshPrimitive.vertexFormat, DrawMode::eDirect),
+                                       meshPrimitive,
+                                       glm::distance(cameraData.position, center),
+                                       false,
+                                       vgfw::resource::selectLod(meshPrimitive, m_LodSelection));
+                }
+
+                rc.bindUniformBuffer(0, cameraData.cameraUniform);
+                m_RenderQueue.sort().submit(rc, 1, 0);
             }
 
             rc.endRendering(frameBuffer);
         });
 }
 
-vgfw::renderer::GraphicsPipeline& GBufferPass::getPipeline(const vgfw::renderer::VertexFormat& vertexFormat)
+void GBufferPass::setCompactLayout(bool compact) { m_Compact = compact; }
+
+void GBufferPass::setLodSelection(const vgfw::resource::LodSelection& lodSelection) { m_LodSelection = lodSelection; }
+
+size_t GBufferPass::getProgramKey(DrawMode drawMode, bool compact)
+{
+    size_t hash = 0;
+    vgfw::utils::hashCombine(hash, drawMode, compact);
+    return hash;
+}
+
+void GBufferPass::requestProgram(DrawMode drawMode, bool compact)
+{
+    const char* vertexShader   = "shaders/geometry.vert";
+    const char* fragmentShader = compact ? "shaders/gbuffer_compact.frag" : "shaders/gbuffer.frag";
+    switch (drawMode)
+    {
+        case DrawMode::eDirect:
+            break;
+        case DrawMode::eIndirect:
+            vertexShader   = "shaders/geometry_indirect.vert";
+            fragmentShader = compact ? "shaders/gbuffer_indirect_compact.frag" : "shaders/gbuffer_indirect.frag";
+            break;
+        case DrawMode::eIndirectBindless:
+            vertexShader   = "shaders/geometry_indirect.vert";
+            fragmentShader = compact ? "shaders/gbuffer_bindless_compact.frag" : "shaders/gbuffer_bindless.frag";
+            break;
+    }
+
+    m_Programs[getProgramKey(drawMode, compact)] = m_RenderContext.createGraphicsProgramAsync(
+        vgfw::utils::readFileAllText(vertexShader), vgfw::utils::readFileAllText(fragmentShader));
+}
+
+vgfw::renderer::GraphicsPipeline& GBufferPass::getPipeline(const vgfw::renderer::VertexFormat& vertexFormat,
+                                                           DrawMode                            drawMode)
 {
     size_t hash = vertexFormat.getHash();
+    vgfw::utils::hashCombine(hash, drawMode, m_Compact);
 
     vgfw::renderer::GraphicsPipeline* passPipeline = nullptr;
 
@@ -103,7 +203,7 @@ vgfw::renderer::GraphicsPipeline& GBufferPass::getPipeline(const vgfw::renderer:
 
     if (!passPipeline)
     {
-        auto pipeline = createPipeline(vertexFormat);
+        auto pipeline = createPipeline(vertexFormat, drawMode);
 
         const auto& it = m_Pipelines.insert_or_assign(hash, std::move(pipeline)).first;
         passPipeline   = &it->second;
@@ -112,12 +212,12 @@ vgfw::renderer::GraphicsPipeline& GBufferPass::getPipeline(const vgfw::renderer:
     return *passPipeline;
 }
 
-vgfw::renderer::GraphicsPipeline GBufferPass::createPipeline(const vgfw::renderer::VertexFormat& vertexFormat)
+vgfw::renderer::GraphicsPipeline GBufferPass::createPipeline(const vgfw::renderer::VertexFormat& vertexFormat,
+                                                             DrawMode                            drawMode)
 {
     auto vertexArrayObject = m_RenderContext.getVertexArray(vertexFormat.getAttributes());
 
-    auto program = m_RenderContext.createGraphicsProgram(vgfw::utils::readFileAllText("shaders/geometry.vert"),
-                                                         vgfw::utils::readFileAllText("shaders/gbuffer.frag"));
+    const auto& program = m_Programs.at(getProgramKey(drawMode, m_Compact));
 
     return vgfw::renderer::GraphicsPipeline::Builder {}
         .setDepthStencil({
@@ -9,15 +9,40 @@ public:
     explicit GBufferPass(vgfw::renderer::RenderContext& rc);
     ~GBufferPass();
 
+    // Only the visible primitives (indices into meshPrimitives) are drawn, unless drawCommands is set, then all
+    // of them are submitted as multi-draw indirect batches, or the ones surviving GPU culling if the blackboard
+    // has CullingData
     void addToGraph(FrameGraph&                                       fg,
                     FrameGraphBlackboard&                             blackboard,
                     const vgfw::renderer::Extent2D&                   resolution,
-                    const std::vector<vgfw::resource::MeshPrimitive>& meshPrimitives);
+                    const std::vector<vgfw::resource::MeshPrimitive>& meshPrimitives,
+                    const std::vector<uint32_t>&                      visiblePrimitives,
+                    const vgfw::resource::DrawCommandBuilder*         drawCommands = nullptr);
+
+    // Compact layout: no position target (reconstructed from depth), RG16 octahedral normals, RGBA8 material
+    void setCompactLayout(bool compact);
+    // Per frame, for the primitives drawn one by one (the indirect path selects through DrawCommandBuilder)
+    void setLodSelection(const vgfw::resource::LodSelection& lodSelection);
 
 private:
-    vgfw::renderer::GraphicsPipeline& getPipeline(const vgfw::renderer::VertexFormat&);
-    vgfw::renderer::GraphicsPipeline  createPipeline(const vgfw::renderer::VertexFormat&);
+    enum class DrawMode
+    {
+        eDirect,
+        eIndirect,
+        eIndirectBindless
+    };
+
+    static size_t getProgramKey(DrawMode, bool compact);
+
+    void                              requestProgram(DrawMode, bool compact);
+    vgfw::renderer::GraphicsPipeline& getPipeline(const vgfw::renderer::VertexFormat&, DrawMode);
+    vgfw::renderer::GraphicsPipeline  createPipeline(const vgfw::renderer::VertexFormat&, DrawMode);
 
 private:
+    // Every variant is compiled in the background from construction on, pipelines only add the vertex format
+    std::unordered_map<size_t, vgfw::renderer::ProgramHandle>    m_Programs;
     std::unordered_map<size_t, vgfw::renderer::GraphicsPipeline> m_Pipelines;
+    vgfw::renderer::RenderQueue                                  m_RenderQueue;
+    bool                                                         m_Compact {false};
+    vgfw::resource::LodSelection                                 m_LodSelection {};
 };
\ No newline at end of file
@@ -0,0 +1,101 @@
+#include "passes/hiz_pass.hpp"
+#include "pass_resource/camera_data.hpp"
+#include "pass_resource/gbuffer_data.hpp"
+
+namespace
+{
+    constexpr uint32_t kLocalSize = 8;
+
+    glm::uvec3 getNumGroups(const vgfw::renderer::Extent2D& extent)
+    {
+        return {(extent.width + kLocalSize - 1) / kLocalSize, (extent.height + kLocalSize - 1) / kLocalSize, 1};
+    }
+} // namespace
+
+HiZPass::HiZPass(vgfw::renderer::RenderContext& rc) : BasePass(rc)
+{
+    m_CopyProgram       = m_RenderContext.createComputeProgram(vgfw::utils::readFileAllText("shaders/hiz_copy.comp"));
+    m_DownsampleProgram = m_RenderContext.createComputeProgram(
+        vgfw::utils::readFileAllText("shaders/hiz_downsample.comp"));
+}
+
+HiZPass::~HiZPass()
+{
+    m_RenderContext.destroyProgram(m_CopyProgram).destroyProgram(m_DownsampleProgram).destroy(m_Pyramid);
+}
+
+void HiZPass::addToGraph(FrameGraph& fg, FrameGraphBlackboard& blackboard)
+{
+    const auto& cameraData = blackboard.get<CameraData>();
+    const auto& gBuffer    = blackboard.get<GBufferData>();
+
+    fg.addCallbackPass(
+        "Hi-Z Pass",
+        [&](FrameGraph::Builder& builder, auto&) {
+            builder.read(gBuffer.depth);
+            // Consumed by the next frame, outside of this graph
+            builder.setSideEffect();
+        },
+        [=, &cameraData, this](const auto&, FrameGraphPassResources& resources, void* ctx) {
+            NAMED_DEBUG_MARKER("Hi-Z Pass");
+            VGFW_PROFILE_GL("Hi-Z Pass");
+            VGFW_PROFILE_NAMED_SCOPE("Hi-Z Pass");
+
+            auto& rc    = *static_cast<vgfw::renderer::RenderContext*>(ctx);
+            auto& depth = vgfw::renderer::framegraph::getTexture(resources, gBuffer.depth);
+            VGFW_TIMED_SCOPE(rc, "Hi-Z Pass");
+
+            auto extent = depth.getExtent();
+            resize(extent);
+
+            rc.bindTexture(0, depth)
+                .bindImage(0, m_Pyramid, 0, GL_WRITE_ONLY)
+                .dispatch(m_CopyProgram, getNumGroups(extent));
+
+            for (uint32_t level = 1; level < m_Pyramid.getNumMipLevels(); ++level)
+            {
+                extent = {glm::max(extent.width / 2, 1u), glm::max(extent.height / 2, 1u)};
+
+                rc.memoryBarrier(GL_SHADER_IMAGE_ACCESS_BARRIER_BIT)
+                    .bindImage(0, m_Pyramid, level - 1, GL_READ_ONLY)
+                    .bindImage(1, m_Pyramid, level, GL_WRITE_ONLY)
+                    .dispatch(m_DownsampleProgram, getNumGroups(extent));
+            }
+            // The culling pass samples it next frame
+            rc.memoryBarrier(GL_TEXTURE_FETCH_BARRIER_BIT);
+
+            m_ViewProjection = cameraData.viewProjection;
+            m_Valid          = true;
+        });
+}
+
+void HiZPass::invalidate()
+{
+    m_ViewProjection = glm::mat4 {1.0f};
+    m_Valid          = false;
+}
+
+const vgfw::renderer::Texture* HiZPass::getPyramid() const { return m_Valid ? &m_Pyramid : nullptr; }
+
+const glm::mat4& HiZPass::getViewProjection() const { return m_ViewProjection; }
+
+void HiZPass::resize(const vgfw::renderer::Extent2D& extent)
+{
+    if (m_Pyramid && m_Pyramid.getExtent() == extent)
+        return;
+
+    m_RenderContext.destroy(m_Pyramid);
+
+    m_Pyramid = m_RenderContext.createTexture2D(extent,
+                                                vgfw::renderer::PixelFormat::eR32F,
+                                                vgfw::renderer::calcMipLevels(glm::max(extent.width, extent.height)));
+    m_RenderContext.setupSampler(m_Pyramid,
+                                 {
+                                     .minFilter    = vgfw::renderer::TexelFilter::eNearest,
+                                     .mipmapMode   = vgfw::renderer::MipmapMode::eNearest,
+                                     .magFilter    = vgfw::renderer::TexelFilter::eNearest,
+                                     .addressModeS = vgfw::renderer::SamplerAddressMode::eClampToEdge,
+                                     .addressModeT = vgfw::renderer::SamplerAddressMode::eClampToEdge,
+                                 });
+    m_Valid = false;
+}
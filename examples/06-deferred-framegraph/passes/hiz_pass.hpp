@@ -0,0 +1,31 @@
+#pragma once
+
+#include "base_pass.hpp"
+
+// Builds a farthest-depth pyramid from the G-Buffer depth, kept alive for occlusion culling in the next frame
+class HiZPass : public BasePass
+{
+public:
+    explicit HiZPass(vgfw::renderer::RenderContext& rc);
+    ~HiZPass();
+
+    // Records the CameraData view-projection the pyramid was built with when the pass executes
+    void addToGraph(FrameGraph& fg, FrameGraphBlackboard& blackboard);
+    // For frames without the pass, the pyramid would be stale once it is added again
+    void invalidate();
+
+    // Null until the first pyramid was built
+    const vgfw::renderer::Texture* getPyramid() const;
+    const glm::mat4&               getViewProjection() const;
+
+private:
+    void resize(const vgfw::renderer::Extent2D&);
+
+private:
+    GLuint m_CopyProgram {GL_NONE};
+    GLuint m_DownsampleProgram {GL_NONE};
+
+    vgfw::renderer::Texture m_Pyramid;
+    glm::mat4               m_ViewProjection {1.0f};
+    bool                    m_Valid {false};
+};
@@ -0,0 +1,104 @@
+#include "passes/light_culling_pass.hpp"
+#include "pass_resource/camera_data.hpp"
+#include "pass_resource/light_cluster_data.hpp"
+#include "pass_resource/light_data.hpp"
+
+namespace
+{
+    constexpr uint32_t   kLocalSize = 64;
+    constexpr glm::uvec3 kGridSize {16, 9, 24};
+    constexpr uint32_t   kNumClusters = kGridSize.x * kGridSize.y * kGridSize.z;
+
+    // Size of the shared index list, clusters past it are left without lights
+    constexpr uint32_t kAverageLightsPerCluster = 32;
+
+    // Matches LightClusters of lib/light.glsl (std140)
+    struct LightClustersUniform
+    {
+        glm::mat4  inverseProjection;
+        glm::uvec4 gridSize; // w = number of lights
+        glm::vec2  screenSize;
+        float      zNear;
+        float      zFar;
+        float      sliceScale;
+        float      sliceBias;
+        glm::vec2  padding;
+    };
+    static_assert(sizeof(LightClustersUniform) == 112);
+} // namespace
+
+LightCullingPass::LightCullingPass(vgfw::renderer::RenderContext& rc) : BasePass(rc)
+{
+    m_Program = m_RenderContext.createComputeProgram(vgfw::utils::readFileAllText("shaders/light_cull.comp"));
+}
+
+LightCullingPass::~LightCullingPass() { m_RenderContext.destroyProgram(m_Program); }
+
+void LightCullingPass::addToGraph(FrameGraph&                     fg,
+                                  FrameGraphBlackboard&           blackboard,
+                                  const vgfw::renderer::Extent2D& resolution)
+{
+    const auto& cameraData = blackboard.get<CameraData>();
+    const auto& lightData  = blackboard.get<LightData>();
+
+    blackboard.add<LightClusterData>() = fg.addCallbackPass<LightClusterData>(
+        "Light Culling Pass",
+        [&](FrameGraph::Builder& builder, LightClusterData& data) {
+            data.clustersUniform = &m_ClustersUniform;
+
+            data.lights = builder.create<vgfw::renderer::framegraph::FrameGraphBuffer>(
+                "Lights", {.size = static_cast<GLsizeiptr>(kMaxLights * sizeof(LocalLight))});
+            data.lights = builder.write(data.lights);
+
+            data.grid = builder.create<vgfw::renderer::framegraph::FrameGraphBuffer>(
+                "Light Grid", {.size = static_cast<GLsizeiptr>(kNumClusters * sizeof(glm::uvec2))});
+            data.grid = builder.write(data.grid);
+
+            data.lightIndices = builder.create<vgfw::renderer::framegraph::FrameGraphBuffer>(
+                "Light Indices",
+                {.size = static_cast<GLsizeiptr>((1 + kNumClusters * kAverageLightsPerCluster) * sizeof(uint32_t))});
+            data.lightIndices = builder.write(data.lightIndices);
+        },
+        [=, &cameraData, &lightData, this](
+            const LightClusterData& data, FrameGraphPassResources& resources, void* ctx) {
+            NAMED_DEBUG_MARKER("Light Culling Pass");
+            VGFW_PROFILE_GL("Light Culling Pass");
+            VGFW_PROFILE_NAMED_SCOPE("Light Culling Pass");
+
+            auto& rc = *static_cast<vgfw::renderer::RenderContext*>(ctx);
+            VGFW_TIMED_SCOPE(rc, "Light Culling Pass");
+
+            const auto lights = lightData.localLights.first(std::min<size_t>(lightData.localLights.size(), kMaxLights));
+
+            // slice = log(depth) * scale + bias, spreads the depth slices evenly in log space
+            const auto logDepthRange = std::log(cameraData.zFar / cameraData.zNear);
+
+            const LightClustersUniform clusters {
+                .inverseProjection = cameraData.inverseProjection,
+                .gridSize          = {kGridSize, static_cast<uint32_t>(lights.size())},
+                .screenSize        = {static_cast<float>(resolution.width), static_cast<float>(resolution.height)},
+                .zNear             = cameraData.zNear,
+                .zFar              = cameraData.zFar,
+                .sliceScale        = kGridSize.z / logDepthRange,
+                .sliceBias         = -(kGridSize.z * std::log(cameraData.zNear)) / logDepthRange,
+            };
+            m_ClustersUniform = rc.uploadUniform(clusters);
+
+            auto& lightsBuffer = vgfw::renderer::framegraph::getBuffer(resources, data.lights);
+            if (!lights.empty())
+                rc.upload(lightsBuffer, 0, static_cast<GLsizeiptr>(lights.size_bytes()), lights.data());
+
+            // The index list starts with the counter its ranges are allocated from
+            auto&          lightIndices = vgfw::renderer::framegraph::getBuffer(resources, data.lightIndices);
+            const uint32_t zero {0};
+            rc.upload(lightIndices, 0, sizeof(zero), &zero);
+
+            rc.bindUniformBuffer(0, cameraData.cameraUniform)
+                .bindUniformBuffer(1, m_ClustersUniform)
+                .bindStorageBuffer(0, lightsBuffer)
+                .bindStorageBuffer(1, vgfw::renderer::framegraph::getBuffer(resources, data.grid))
+                .bindStorageBuffer(2, lightIndices)
+                .dispatch(m_Program, {(kNumClusters + kLocalSize - 1) / kLocalSize, 1, 1})
+                .memoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+        });
+}
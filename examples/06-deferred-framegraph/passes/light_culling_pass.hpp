@@ -0,0 +1,25 @@
+#pragma once
+
+#include "base_pass.hpp"
+
+#include "light.hpp"
+
+// Bins the local lights into a froxel grid (screen tiles x exponential depth slices) and adds the per-cluster light
+// lists (LightClusterData) to the blackboard, for DeferredLightingPass to shade with
+class LightCullingPass : public BasePass
+{
+public:
+    // Size of the light buffer, extra lights in LightData are ignored
+    static constexpr uint32_t kMaxLights = 1024;
+
+    explicit LightCullingPass(vgfw::renderer::RenderContext& rc);
+    ~LightCullingPass();
+
+    // Lights and camera are read from the blackboard (LightData, CameraData) when the pass executes
+    void addToGraph(FrameGraph& fg, FrameGraphBlackboard& blackboard, const vgfw::renderer::Extent2D& resolution);
+
+private:
+    GLuint m_Program {GL_NONE};
+
+    vgfw::renderer::UniformAllocation m_ClustersUniform; // Uploaded on execution, see LightClusterData
+};
@@ -0,0 +1,222 @@
+#include "passes/shadow_pass.hpp"
+#include "pass_resource/shadow_data.hpp"
+
+ShadowPass::ShadowPass(vgfw::renderer::RenderContext& rc) : BasePass(rc)
+{
+    for (const auto drawMode : {DrawMode::eDirect, DrawMode::eIndirect, DrawMode::eIndirectBindless})
+    {
+        requestProgram(drawMode);
+    }
+}
+
+ShadowPass::~ShadowPass()
+{
+    // The pipelines share these
+    for (auto& program : m_Programs)
+    {
+        m_RenderContext.destroy(program);
+    }
+}
+
+void ShadowPass::addToGraph(FrameGraph&                                       fg,
+                            FrameGraphBlackboard&                             blackboard,
+                            uint32_t                                          shadowMapSize,
+                            const std::vector<vgfw::resource::MeshPrimitive>& meshPrimitives,
+                            const vgfw::culling::BoundsList&                  bounds,
+                            const vgfw::resource::DrawCommandBuilder*         drawCommands)
+{
+    const auto& shadowData = blackboard.get<ShadowData>();
+
+    // The number of cascades is part of the graph setup, their matrices are read when the pass executes
+    const auto numCascades = static_cast<uint32_t>(shadowData.casterFrusta.size());
+    if (numCascades == 0)
+        return;
+
+    const auto numCommands = drawCommands ? drawCommands->getNumCommands() : 0;
+
+    struct Data
+    {
+        FrameGraphResource cascadedShadowMaps;
+        FrameGraphResource commands {-1};     // Indirect path only
+        FrameGraphResource cascadeMasks {-1}; // Per command
+    };
+    const auto& shadowPass = fg.addCallbackPass<Data>(
+        "Shadow Pass",
+        [&](FrameGraph::Builder& builder, Data& data) {
+            if (drawCommands)
+            {
+                const auto commandsSize = numCommands * sizeof(vgfw::renderer::DrawElementsIndirectCommand);
+                data.commands           = builder.create<vgfw::renderer::framegraph::FrameGraphBuffer>(
+                    "Layered Commands", {.size = static_cast<GLsizeiptr>(commandsSize)});
+                data.commands = builder.write(data.commands);
+
+                data.cascadeMasks = builder.create<vgfw::renderer::framegraph::FrameGraphBuffer>(
+                    "Cascade Masks", {.size = static_cast<GLsizeiptr>(numCommands * sizeof(uint32_t))});
+                data.cascadeMasks = builder.write(data.cascadeMasks);
+            }
+
+            data.cascadedShadowMaps = builder.create<vgfw::renderer::framegraph::FrameGraphTexture>(
+                "Cascaded Shadow Maps",
+                {
+                    .extent        = {.width = shadowMapSize, .height = shadowMapSize},
+                    .layers        = numCascades,
+                    .format        = vgfw::renderer::PixelFormat::eDepth32F,
+                    .shadowSampler = true,
+                    .wrap          = vgfw::renderer::WrapMode::eClampToOpaqueWhite, // Lit outside the cascade
+                });
+            data.cascadedShadowMaps = builder.write(data.cascadedShadowMaps);
+        },
+        [=, &meshPrimitives, &bounds, &shadowData, this](
+            const Data& data, FrameGraphPassResources& resources, void* ctx) {
+            NAMED_DEBUG_MARKER("Shadow Pass");
+            VGFW_PROFILE_GL("Shadow Pass");
+            VGFW_PROFILE_NAMED_SCOPE("Shadow Pass");
+
+            auto& rc = *static_cast<vgfw::renderer::RenderContext*>(ctx);
+            VGFW_TIMED_SCOPE(rc, "Shadow Pass");
+
+            constexpr float kFarPlane {1.0f};
+
+            // No layer: every cascade is attached, gl_Layer picks one per instance
+            const vgfw::renderer::RenderingInfo renderingInfo {
+                .area            = {.extent = {.width = shadowMapSize, .height = shadowMapSize}},
+                .depthAttachment = vgfw::renderer::AttachmentInfo {
+                    .image      = vgfw::renderer::framegraph::getTexture(resources, data.cascadedShadowMaps),
+                    .clearValue = kFarPlane,
+                },
+            };
+
+            // Culled per cascade, a caster outside of all of them is not drawn at all
+            vgfw::culling::cullViews(
+                shadowData.casterFrusta, drawCommands ? drawCommands->getBounds() : bounds, m_CascadeMasks);
+
+            auto frameBuffer = rc.beginRendering(renderingInfo);
+
+            // Cleared to the far plane (nothing in shadow) until the program has compiled
+            const auto drawMode = !drawCommands              ? DrawMode::eDirect :
+                                  drawCommands->isBindless() ? DrawMode::eIndirectBindless :
+                                                               DrawMode::eIndirect;
+            if (!m_Programs[static_cast<size_t>(drawMode)].isReady())
+            {
+                rc.endRendering(frameBuffer);
+                return;
+            }
+
+            if (drawCommands)
+            {
+                m_LayeredCommands.resize(numCommands);
+                drawCommands->writeLayeredCommands(m_CascadeMasks, m_LayeredCommands);
+
+                auto& commands     = vgfw::renderer::framegraph::getBuffer(resources, data.commands);
+                auto& cascadeMasks = vgfw::renderer::framegraph::getBuffer(resources, data.cascadeMasks);
+                rc.upload(commands,
+                          0,
+                          static_cast<GLsizeiptr>(m_LayeredCommands.size() * sizeof(m_LayeredCommands[0])),
+                          m_LayeredCommands.data())
+                    .upload(cascadeMasks,
+                            0,
+                            static_cast<GLsizeiptr>(m_CascadeMasks.size() * sizeof(m_CascadeMasks[0])),
+                            m_CascadeMasks.data());
+
+                for (const auto& batch : drawCommands->getBatches())
+                {
+                    rc.bindGraphicsPipeline(getPipeline(*batch.vertexFormat, drawMode))
+                        .bindUniformBuffer(0, shadowData.cascadesUniform)
+                        .bindStorageBuffer(0, drawCommands->getDrawDataBuffer())
+                        .bindStorageBuffer(1, cascadeMasks);
+                    if (!drawCommands->isBindless())
+                        rc.bindMeshPrimitiveTextures(0, *batch.primitive);
+
+                    // Commands of casters outside every cascade have no instances
+                    drawCommands->draw(batch, commands);
+                }
+            }
+            else
+            {
+                for (uint32_t i = 0; i < meshPrimitives.size(); ++i)
+                {
+                    const auto cascadeMask = m_CascadeMasks[i];
+                    if (cascadeMask == 0)
+                        continue;
+
+                    const auto& meshPrimitive = meshPrimitives[i];
+                    rc.bindGraphicsPipeline(getPipeline(*meshPrimitive.vertexFormat, drawMode))
+                        .bindUniformBuffer(0, shadowData.cascadesUniform)
+                        .bindMeshPrimitiveMaterialBuffer(1, meshPrimitive)
+                        .bindMeshPrimitiveTextures(0, meshPrimitive)
+                        .setUniformMat4("uModel", meshPrimitive.modelMatrix)
+                        .setUniform1ui("uCascadeMask", cascadeMask)
+                        .drawMeshPrimitive(meshPrimitive,
+                                           vgfw::resource::selectLod(meshPrimitive, m_LodSelection),
+                                           static_cast<uint32_t>(std::popcount(cascadeMask)));
+                }
+            }
+
+            rc.endRendering(frameBuffer);
+        });
+
+    blackboard.add<ShadowMapData>().cascadedShadowMaps = shadowPass.cascadedShadowMaps;
+}
+
+void ShadowPass::setLodSelection(const vgfw::resource::LodSelection& lodSelection) { m_LodSelection = lodSelection; }
+
+void ShadowPass::requestProgram(DrawMode drawMode)
+{
+    const char* vertexShader   = "shaders/shadow.vert";
+    const char* fragmentShader = "shaders/shadow.frag";
+    switch (drawMode)
+    {
+        case DrawMode::eDirect:
+            break;
+        case DrawMode::eIndirect:
+            vertexShader   = "shaders/shadow_indirect.vert";
+            fragmentShader = "shaders/shadow_indirect.frag";
+            break;
+        case DrawMode::eIndirectBindless:
+            vertexShader   = "shaders/shadow_indirect.vert";
+            fragmentShader = "shaders/shadow_bindless.frag";
+            break;
+    }
+
+    m_Programs[static_cast<size_t>(drawMode)] = m_RenderContext.createGraphicsProgramAsync(
+        vgfw::utils::readFileAllText(vertexShader), vgfw::utils::readFileAllText(fragmentShader));
+}
+
+vgfw::renderer::GraphicsPipeline& ShadowPass::getPipeline(const vgfw::renderer::VertexFormat& vertexFormat,
+                                                          DrawMode                            drawMode)
+{
+    size_t hash = vertexFormat.getHash();
+    vgfw::utils::hashCombine(hash, drawMode);
+
+    if (const auto it = m_Pipelines.find(hash); it != m_Pipelines.cend())
+        return it->second;
+
+    return m_Pipelines.insert_or_assign(hash, createPipeline(vertexFormat, drawMode)).first->second;
+}
+
+vgfw::renderer::GraphicsPipeline ShadowPass::createPipeline(const vgfw::renderer::VertexFormat& vertexFormat,
+                                                            DrawMode                            drawMode)
+{
+    auto vertexArrayObject = m_RenderContext.getVertexArray(vertexFormat.getAttributes());
+
+    const auto& program = m_Programs[static_cast<size_t>(drawMode)];
+
+    return vgfw::renderer::GraphicsPipeline::Builder {}
+        .setDepthStencil({
+            .depthTest      = true,
+            .depthWrite     = true,
+            .depthCompareOp = vgfw::renderer::CompareOp::eLessOrEqual,
+        })
+        // Both faces cast (Sponza has single sided curtains and foliage), with a slope scaled bias. Depth clamping
+        // flattens the casters in front of a cascade onto its near plane
+        .setRasterizerState({
+            .polygonMode      = vgfw::renderer::PolygonMode::eFill,
+            .cullMode         = vgfw::renderer::CullMode::eNone,
+            .polygonOffset    = vgfw::renderer::PolygonOffset {.factor = 2.0f, .units = 4.0f},
+            .depthClampEnable = true,
+            .scissorTest      = false,
+        })
+        .setVAO(vertexArrayObject)
+        .setShaderProgram(program)
+        .build();
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+#include "base_pass.hpp"
+#include "vgfw.hpp"
+
+// Renders the cascaded shadow maps of the directional light (ShadowData) into one 2D array depth texture
+// (ShadowMapData) in a single submission: every caster is culled against each cascade and drawn once, with one
+// instance per cascade it intersects, the vertex shader picks the layer (gl_Layer). Needs
+// RenderContext::hasVertexShaderLayer
+class ShadowPass : public BasePass
+{
+public:
+    explicit ShadowPass(vgfw::renderer::RenderContext& rc);
+    ~ShadowPass();
+
+    // Adds nothing when ShadowData has no cascades. bounds are the world bounds of meshPrimitives, the casters are
+    // culled against them when the pass executes, unless drawCommands is set, then its commands are drawn as
+    // multi-draw indirect batches (with its bounds)
+    void addToGraph(FrameGraph&                                       fg,
+                    FrameGraphBlackboard&                             blackboard,
+                    uint32_t                                          shadowMapSize,
+                    const std::vector<vgfw::resource::MeshPrimitive>& meshPrimitives,
+                    const vgfw::culling::BoundsList&                  bounds,
+                    const vgfw::resource::DrawCommandBuilder*         drawCommands = nullptr);
+
+    // Per frame, for the primitives drawn one by one (the indirect path keeps the LODs of DrawCommandBuilder)
+    void setLodSelection(const vgfw::resource::LodSelection& lodSelection);
+
+private:
+    enum class DrawMode
+    {
+        eDirect,
+        eIndirect,
+        eIndirectBindless
+    };
+
+    void                              requestProgram(DrawMode);
+    vgfw::renderer::GraphicsPipeline& getPipeline(const vgfw::renderer::VertexFormat&, DrawMode);
+    vgfw::renderer::GraphicsPipeline  createPipeline(const vgfw::renderer::VertexFormat&, DrawMode);
+
+private:
+    // By DrawMode, compiled in the background from construction on, the pass draws nothing until its one is ready
+    std::array<vgfw::renderer::ProgramHandle, 3>                 m_Programs;
+    std::unordered_map<size_t, vgfw::renderer::GraphicsPipeline> m_Pipelines;
+    vgfw::resource::LodSelection                                 m_LodSelection {};
+
+    // Rebuilt when the pass executes
+    std::vector<uint32_t>                                     m_CascadeMasks;
+    std::vector<vgfw::renderer::DrawElementsIndirectCommand> m_LayeredCommands;
+};
@@ -2,8 +2,9 @@
 
 TonemappingPass::TonemappingPass(vgfw::renderer::RenderContext& rc) : BasePass(rc)
 {
-    auto program = m_RenderContext.createGraphicsProgram(vgfw::utils::readFileAllText("shaders/fullscreen.vert"),
-                                                         vgfw::utils::readFileAllText("shaders/tonemapping.frag"));
+    auto program =
+        m_RenderContext.createGraphicsProgramAsync(vgfw::utils::readFileAllText("shaders/fullscreen.vert"),
+                                                   vgfw::utils::readFileAllText("shaders/tonemapping.frag"));
 
     m_Pipeline = vgfw::renderer::GraphicsPipeline::Builder {}
                      .setShaderProgram(program)
@@ -50,7 +51,9 @@ FrameGraphResource TonemappingPass::addToGraph(FrameGraph& fg, FrameGraphResourc
                 }},
             };
 
-            auto&      rc          = *static_cast<vgfw::renderer::RenderContext*>(ctx);
+            auto& rc = *static_cast<vgfw::renderer::RenderContext*>(ctx);
+            VGFW_TIMED_SCOPE(rc, "Tone-mapping Pass");
+
             const auto framebuffer = rc.beginRendering(renderingInfo);
             rc.bindGraphicsPipeline(m_Pipeline)
                 .bindTexture(0, vgfw::renderer::framegraph::getTexture(resources, input))
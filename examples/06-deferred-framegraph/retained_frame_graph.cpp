@@ -0,0 +1,46 @@
+#include "retained_frame_graph.hpp"
+
+bool RetainedFrameGraph::begin(std::size_t key)
+{
+    if (m_Compiled && key == m_Key)
+        return false;
+
+    VGFW_TRACE("[RetainedFrameGraph] Rebuilding the frame graph");
+
+    // The passes of the old graph reference the old blackboard, drop the graph first
+    m_Graph.reset();
+    m_Blackboard.reset();
+
+    m_Graph.emplace();
+    m_Blackboard.emplace();
+    m_Key      = key;
+    m_Compiled = false;
+    return true;
+}
+
+void RetainedFrameGraph::invalidate() { m_Compiled = false; }
+
+FrameGraph& RetainedFrameGraph::getGraph()
+{
+    assert(m_Graph);
+    return *m_Graph;
+}
+
+FrameGraphBlackboard& RetainedFrameGraph::getBlackboard()
+{
+    assert(m_Blackboard);
+    return *m_Blackboard;
+}
+
+void RetainedFrameGraph::compile()
+{
+    assert(m_Graph && !m_Compiled);
+    m_Graph->compile();
+    m_Compiled = true;
+}
+
+void RetainedFrameGraph::execute(void* context, void* allocator)
+{
+    assert(m_Compiled);
+    m_Graph->execute(context, allocator);
+}
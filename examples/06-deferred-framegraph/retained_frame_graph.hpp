@@ -0,0 +1,40 @@
+#pragma once
+
+#include "vgfw.hpp"
+
+// Keeps a compiled FrameGraph, and the blackboard its passes hold references into, across frames. Only the execute
+// step runs again while the topology key is unchanged, transient resources are still acquired and released by the
+// graph on every execution, so the lifetimes and the aliasing in TransientResources stay the same.
+// Passes must read per-frame values when they execute, through blackboard entries (CameraData, LightData) or their
+// own members, never from copies taken during setup
+class RetainedFrameGraph
+{
+public:
+    // Drops the graph and the blackboard when the key differs from the one they were built for
+    // @return true if the passes have to be added and the graph compiled again
+    bool begin(std::size_t key);
+    // Forces a rebuild on the next begin
+    void invalidate();
+
+    FrameGraph&           getGraph();
+    FrameGraphBlackboard& getBlackboard();
+
+    void compile();
+    void execute(void* context, void* allocator);
+
+private:
+    std::optional<FrameGraph>           m_Graph;
+    std::optional<FrameGraphBlackboard> m_Blackboard;
+    std::size_t                         m_Key {0};
+    bool                                m_Compiled {false};
+};
+
+// For entries refreshed every frame (e.g. by uploadCameraUniform): a retained blackboard keeps them, and the passes of
+// the retained graph hold references to them, so they are updated in place rather than added again
+template<typename T>
+T& getOrAdd(FrameGraphBlackboard& blackboard)
+{
+    if (auto* entry = blackboard.try_get<T>())
+        return *entry;
+    return blackboard.add<T>();
+}
@@ -0,0 +1,102 @@
+#include "scene_setup.hpp"
+
+#include "pass_resource/scene_color_data.hpp"
+
+#include <random>
+
+ScenePasses::ScenePasses(vgfw::renderer::RenderContext& rc) :
+    m_CullingPass {rc}, m_LightCullingPass {rc}, m_ShadowPass {rc}, m_GBufferPass {rc}, m_HiZPass {rc},
+    m_DeferredLightingPass {rc}, m_TonemappingPass {rc}, m_FinalCompositionPass {rc}
+{}
+
+std::size_t ScenePasses::getGraphKey(const SceneGraphSettings& settings)
+{
+    std::size_t key {0};
+    vgfw::utils::hashCombine(key,
+                             settings.resolution.width,
+                             settings.resolution.height,
+                             settings.renderTarget,
+                             settings.enableGpuCulling,
+                             settings.enableOcclusionCulling,
+                             settings.enableCompactGBuffer,
+                             settings.numCascades,
+                             settings.shadowMapSize);
+    return key;
+}
+
+void ScenePasses::setLodSelection(const vgfw::resource::LodSelection& lodSelection)
+{
+    m_GBufferPass.setLodSelection(lodSelection);
+    m_ShadowPass.setLodSelection(lodSelection);
+}
+
+void ScenePasses::addToGraph(FrameGraph&                                       fg,
+                             FrameGraphBlackboard&                             blackboard,
+                             const SceneGraphSettings&                         settings,
+                             const std::vector<vgfw::resource::MeshPrimitive>& meshPrimitives,
+                             const vgfw::culling::BoundsList&                  bounds,
+                             const std::vector<uint32_t>&                      visiblePrimitives,
+                             const vgfw::resource::DrawCommandBuilder*         drawCommands)
+{
+    assert(drawCommands || !settings.enableGpuCulling);
+    const bool enableOcclusionCulling = settings.enableGpuCulling && settings.enableOcclusionCulling;
+
+    // Light culling pass
+    m_LightCullingPass.addToGraph(fg, blackboard, settings.resolution);
+
+    // Shadow pass, every cascade at once
+    m_ShadowPass.addToGraph(fg, blackboard, settings.shadowMapSize, meshPrimitives, bounds, drawCommands);
+
+    // Culling pass
+    if (settings.enableGpuCulling)
+    {
+        m_CullingPass.addToGraph(fg, blackboard, *drawCommands, enableOcclusionCulling ? &m_HiZPass : nullptr);
+    }
+
+    // GBuffer pass
+    m_GBufferPass.setCompactLayout(settings.enableCompactGBuffer);
+    m_GBufferPass.addToGraph(fg, blackboard, settings.resolution, meshPrimitives, visiblePrimitives, drawCommands);
+
+    // Hi-Z pass, for occlusion culling in the next frame
+    if (enableOcclusionCulling)
+    {
+        m_HiZPass.addToGraph(fg, blackboard);
+    }
+    else
+    {
+        m_HiZPass.invalidate();
+    }
+
+    // Deferred Lighting pass
+    auto& sceneColor = blackboard.add<SceneColorData>();
+    sceneColor.hdr   = m_DeferredLightingPass.addToGraph(fg, blackboard);
+
+    // Tone-mapping pass
+    sceneColor.ldr = m_TonemappingPass.addToGraph(fg, sceneColor.hdr);
+
+    // Final composition pass
+    m_FinalCompositionPass.compose(fg, blackboard, settings.renderTarget);
+}
+
+std::vector<LocalLight> scatterLocalLights(const vgfw::math::AABB& sceneBounds, uint32_t count, uint32_t seed)
+{
+    std::vector<LocalLight> localLights(count);
+
+    std::mt19937                          random {seed};
+    std::uniform_real_distribution<float> unit {0.0f, 1.0f};
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        auto& localLight = localLights[i];
+        localLight.position =
+            glm::mix(sceneBounds.min, sceneBounds.max, glm::vec3 {unit(random), unit(random), unit(random)});
+        localLight.radius    = glm::mix(100.0f, 400.0f, unit(random));
+        localLight.color     = glm::vec3 {unit(random), unit(random), unit(random)};
+        localLight.intensity = 2.0f;
+        if (i % 4 == 0)
+        {
+            localLight.direction = {0, -1, 0};
+            localLight.setCone(glm::radians(20.0f), glm::radians(35.0f));
+        }
+    }
+    return localLights;
+}
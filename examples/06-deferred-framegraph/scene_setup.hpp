@@ -0,0 +1,62 @@
+#pragma once
+
+#include "light.hpp"
+#include "render_target.hpp"
+
+#include "passes/culling_pass.hpp"
+#include "passes/deferred_lighting_pass.hpp"
+#include "passes/final_composition_pass.hpp"
+#include "passes/gbuffer_pass.hpp"
+#include "passes/hiz_pass.hpp"
+#include "passes/light_culling_pass.hpp"
+#include "passes/shadow_pass.hpp"
+#include "passes/tonemapping_pass.hpp"
+
+// What the passes are added for, any change needs the graph to be set up again
+struct SceneGraphSettings
+{
+    vgfw::renderer::Extent2D resolution {};
+    RenderTarget             renderTarget {RenderTarget::eFinal};
+    bool                     enableGpuCulling {false};
+    bool                     enableOcclusionCulling {false}; // With GPU culling only
+    bool                     enableCompactGBuffer {false};
+    uint32_t                 numCascades {0}; // Of ShadowSettings, the shadow pass adds nothing for 0
+    uint32_t                 shadowMapSize {2048};
+};
+
+// The passes of the deferred example and the order they are added in, the scene benchmarks render with them too
+class ScenePasses
+{
+public:
+    // Their programs start compiling here
+    explicit ScenePasses(vgfw::renderer::RenderContext& rc);
+
+    // Topology key for RetainedFrameGraph, per-frame values are read by the passes when they execute
+    static std::size_t getGraphKey(const SceneGraphSettings& settings);
+
+    // Per frame, for the primitives drawn one by one
+    void setLodSelection(const vgfw::resource::LodSelection& lodSelection);
+
+    // Expects the camera, light and shadow uniforms on the blackboard, adds SceneColorData. drawCommands is required
+    // for GPU culling, see GBufferPass::addToGraph for the rest
+    void addToGraph(FrameGraph&                                       fg,
+                    FrameGraphBlackboard&                             blackboard,
+                    const SceneGraphSettings&                         settings,
+                    const std::vector<vgfw::resource::MeshPrimitive>& meshPrimitives,
+                    const vgfw::culling::BoundsList&                  bounds,
+                    const std::vector<uint32_t>&                      visiblePrimitives,
+                    const vgfw::resource::DrawCommandBuilder*         drawCommands);
+
+private:
+    CullingPass          m_CullingPass;
+    LightCullingPass     m_LightCullingPass;
+    ShadowPass           m_ShadowPass;
+    GBufferPass          m_GBufferPass;
+    HiZPass              m_HiZPass;
+    DeferredLightingPass m_DeferredLightingPass;
+    TonemappingPass      m_TonemappingPass;
+    FinalCompositionPass m_FinalCompositionPass;
+};
+
+// Point and spot lights (every 4th) scattered over the scene bounds, the same ones for the same seed
+std::vector<LocalLight> scatterLocalLights(const vgfw::math::AABB& sceneBounds, uint32_t count, uint32_t seed = 42);
@@ -0,0 +1,5 @@
+#version 450
+
+#define COMPACT_GBUFFER
+
+#include "lib/deferred_lighting.glsl"
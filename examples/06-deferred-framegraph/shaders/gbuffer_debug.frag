@@ -0,0 +1,31 @@
+#version 450
+
+#define COMPACT_GBUFFER
+
+#include "lib/gbuffer_decode.glsl"
+
+// Decodes the compact G-Buffer attributes for the RenderTarget debug views
+
+layout(location = 0) in vec2 vTexCoords;
+
+layout(location = 0) out vec4 FragColor;
+
+layout(binding = 0) uniform Camera {
+    vec3 position;
+    mat4 view;
+    mat4 projection;
+    mat4 inverseView;
+    mat4 inverseProjection;
+} uCamera;
+
+#define TARGET_POSITION 0
+#define TARGET_NORMAL 1
+
+layout(location = 0) uniform int uTarget;
+
+void main() {
+    vec3 target = uTarget == TARGET_POSITION
+                      ? fetchPosition(vTexCoords, uCamera.inverseProjection, uCamera.inverseView)
+                      : fetchNormal(vTexCoords);
+    FragColor = vec4(target, 1.0);
+}
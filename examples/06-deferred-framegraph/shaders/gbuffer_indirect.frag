@@ -0,0 +1,20 @@
+#version 450
+
+#include "lib/draw_data.glsl"
+#include "lib/gbuffer.glsl"
+
+layout(location = 5) flat in int vDrawIndex;
+
+layout(binding = 0) uniform sampler2D pbrTextures[5];
+
+bool hasTexture(int slot) {
+    return getTextureIndex(draws[vDrawIndex].material, slot) != -1;
+}
+
+vec4 sampleTexture(int slot, vec2 texCoords) {
+    return texture(pbrTextures[getTextureIndex(draws[vDrawIndex].material, slot)], texCoords);
+}
+
+void main() {
+    writeGBuffer();
+}
@@ -0,0 +1,37 @@
+#version 450
+#extension GL_ARB_shader_draw_parameters : require
+
+#include "lib/draw_data.glsl"
+
+layout(location = 0) in vec3 aPos;
+layout(location = 1) in vec3 aNormal;
+layout(location = 2) in vec2 aTexCoords;
+layout(location = 3) in vec4 aTangent;
+
+layout(location = 0) out vec2 vTexCoords;
+layout(location = 1) out vec3 vFragPos;
+layout(location = 2) out mat3 vTBN;
+layout(location = 5) flat out int vDrawIndex;
+
+layout(binding = 0) uniform Camera {
+    vec3 position;
+    mat4 view;
+    mat4 projection;
+} uCamera;
+
+void main() {
+    // DrawCommandBuilder stores the command index as base instance, it survives GPU compaction unlike gl_DrawID
+    vDrawIndex = gl_BaseInstanceARB;
+
+    mat4 modelMatrix = draws[vDrawIndex].modelMatrix;
+    mat3 normalMatrix = mat3(modelMatrix);
+
+    vec4 worldPos = modelMatrix * vec4(aPos, 1.0);
+    gl_Position = uCamera.projection * uCamera.view * worldPos;
+    vTexCoords = aTexCoords;
+    vFragPos = worldPos.xyz;
+
+    vec3 normal = normalize(normalMatrix * aNormal);
+    vec3 tangent = normalize(normalMatrix * aTangent.xyz);
+    vTBN = mat3(tangent, cross(tangent, normal) * aTangent.w, normal);
+}
@@ -0,0 +1,57 @@
+#ifndef CASCADES_GLSL
+#define CASCADES_GLSL
+
+#define MAX_CASCADES 4
+
+// Mirrors CascadesUniform of uniforms/shadow_uniform.cpp (std140)
+struct ShadowCascades {
+    mat4 viewProjections[MAX_CASCADES];
+    vec4 splitDepths; // Positive view depth where each cascade ends
+    vec4 texelSizes;  // World space size of a shadow map texel, per cascade
+    uint numCascades; // 0 = no shadows
+    float normalBias; // In texels
+    vec2 padding;
+};
+
+// A caster is drawn with one instance per cascade it intersects, the n-th instance goes to the n-th set bit of mask
+uint getInstanceCascade(uint mask, int instance) {
+    for(int i = 0; i < instance; ++i) {
+        mask &= mask - 1u;
+    }
+    return uint(findLSB(mask));
+}
+
+// numCascades when viewDepth is past the last one
+uint selectCascade(ShadowCascades cascades, float viewDepth) {
+    uint cascade = 0u;
+    while(cascade < cascades.numCascades && viewDepth > cascades.splitDepths[cascade]) {
+        ++cascade;
+    }
+    return cascade;
+}
+
+// 0 = in shadow, 1 = lit, filtered over 3x3 hardware comparisons
+float sampleCascadedShadow(sampler2DArrayShadow shadowMaps, ShadowCascades cascades, vec3 fragPos, vec3 normal,
+                           float viewDepth) {
+    uint cascade = selectCascade(cascades, viewDepth);
+    if(cascade >= cascades.numCascades) {
+        return 1.0;
+    }
+
+    // Offsetting along the normal keeps lit surfaces from shadowing themselves at grazing angles
+    vec3 offsetPos = fragPos + normal * cascades.normalBias * cascades.texelSizes[cascade];
+    vec4 clipPos = cascades.viewProjections[cascade] * vec4(offsetPos, 1.0);
+    vec3 shadowCoords = clipPos.xyz / clipPos.w * 0.5 + 0.5;
+
+    vec2 texelSize = 1.0 / vec2(textureSize(shadowMaps, 0).xy);
+    float lit = 0.0;
+    for(int y = -1; y <= 1; ++y) {
+        for(int x = -1; x <= 1; ++x) {
+            vec2 uv = shadowCoords.xy + vec2(x, y) * texelSize;
+            lit += texture(shadowMaps, vec4(uv, float(cascade), shadowCoords.z));
+        }
+    }
+    return lit / 9.0;
+}
+
+#endif
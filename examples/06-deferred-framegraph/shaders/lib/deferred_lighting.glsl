@@ -0,0 +1,107 @@
+#ifndef DEFERRED_LIGHTING_GLSL
+#define DEFERRED_LIGHTING_GLSL
+
+// Body of deferred_lighting.frag and deferred_lighting_compact.frag, which only differ in the G-Buffer layout
+
+#include "lib/cascades.glsl"
+#include "lib/gbuffer_decode.glsl"
+#include "lib/light.glsl"
+#include "lib/pbr.glsl"
+
+layout(location = 0) in vec2 vTexCoords;
+
+layout(location = 0) out vec3 FragColor;
+
+layout(binding = 0) uniform Camera {
+    vec3 position;
+    mat4 view;
+    mat4 projection;
+    mat4 inverseView;
+    mat4 inverseProjection;
+} uCamera;
+
+layout(binding = 1) uniform DirectionalLight {
+    vec3 direction;
+    float intensity;
+    vec3 color;
+} uLight;
+
+layout(binding = 2) uniform Clusters {
+    LightClusters uClusters;
+};
+
+layout(binding = 3) uniform Cascades {
+    ShadowCascades uCascades;
+};
+
+// After the G-Buffer targets, only sampled when uCascades has cascades
+layout(binding = 5) uniform sampler2DArrayShadow uShadowMaps;
+
+layout(binding = 0, std430) readonly buffer Lights {
+    LocalLight lights[];
+};
+layout(binding = 1, std430) readonly buffer LightGrid {
+    uvec2 lightGrid[]; // {offset, count} into lightIndices
+};
+layout(binding = 2, std430) readonly buffer LightIndices {
+    uint lightIndexCount;
+    uint lightIndices[];
+};
+
+// Diffuse and specular (Cook-Torrance BRDF) response to one light, lightDir points towards the light
+vec3 shadeLight(vec3 normal, vec3 viewDir, vec3 lightDir, vec3 radiance, float metallic, float roughness) {
+    // Diffuse
+    float diff = max(dot(normal, lightDir), 0.0);
+    vec3 diffuse = radiance * diff;
+
+    // Specular
+    vec3 halfwayDir = normalize(lightDir + viewDir);
+
+    float NDF = DistributionGGX(normal, halfwayDir, roughness);
+    float G = GeometrySmith(normal, viewDir, lightDir, roughness);
+    vec3 F0 = vec3(0.04); // default specular reflectance
+    vec3 F = FresnelSchlick(max(dot(halfwayDir, viewDir), 0.0), F0);
+    vec3 specular = (NDF * G * F) / max(4.0 * max(dot(normal, viewDir), 0.0) * diff, 0.001);
+
+    return (1.0 - metallic) * diffuse + metallic * specular * radiance;
+}
+
+void main() {
+    GBuffer gBuffer = fetchGBuffer(vTexCoords, uCamera.inverseProjection, uCamera.inverseView);
+    vec3 fragPos = gBuffer.position;
+    vec3 normal = gBuffer.normal;
+    vec3 baseColor = gBuffer.baseColor;
+    vec3 emissive = gBuffer.emissive;
+    float metallic = gBuffer.metallic;
+    float roughness = gBuffer.roughness;
+    float ao = gBuffer.ao;
+
+    vec3 viewDir = normalize(uCamera.position - fragPos);
+
+    // Ambient
+    vec3 ambient = uLight.intensity * uLight.color * 0.02;
+
+    float viewDepth = -(uCamera.view * vec4(fragPos, 1.0)).z;
+
+    // Directional light
+    float shadow = sampleCascadedShadow(uShadowMaps, uCascades, fragPos, normalize(normal), viewDepth);
+    vec3 radiance = shadeLight(normal, viewDir, -uLight.direction, shadow * uLight.intensity * uLight.color, metallic,
+                               roughness);
+
+    // Local lights, only the ones binned into the cluster of this fragment
+    uvec2 cell = lightGrid[getClusterIndex(uClusters, gl_FragCoord.xy, viewDepth)];
+    for(uint i = 0; i < cell.y; ++i) {
+        LocalLight light = lights[lightIndices[cell.x + i]];
+
+        vec3 toLight = light.position - fragPos;
+        float attenuation = getLightAttenuation(light, toLight);
+        if(attenuation > 0.0) {
+            radiance += shadeLight(normal, viewDir, normalize(toLight), light.intensity * attenuation * light.color,
+                                   metallic, roughness);
+        }
+    }
+
+    FragColor = (ambient + radiance) * baseColor * ao + emissive;
+}
+
+#endif
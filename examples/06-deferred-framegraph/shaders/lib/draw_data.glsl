@@ -0,0 +1,17 @@
+#ifndef DRAW_DATA_GLSL
+#define DRAW_DATA_GLSL
+
+#include "lib/material.glsl"
+
+// Mirrors vgfw::resource::DrawData (std430), indexed by the command index of an indirect draw
+struct DrawData {
+    mat4 modelMatrix;
+    PrimitiveMaterial material;
+    uvec2 textureHandles[5]; // Bindless handles in the gbuffer.glsl slot order, zero when unused
+};
+
+layout(binding = 0, std430) readonly buffer DrawDataBuffer {
+    DrawData draws[];
+};
+
+#endif
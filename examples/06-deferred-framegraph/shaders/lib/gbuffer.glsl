@@ -0,0 +1,90 @@
+#ifndef GBUFFER_GLSL
+#define GBUFFER_GLSL
+
+// Shared G-Buffer output, the including shader defines how material textures are reached:
+//   bool hasTexture(int slot);
+//   vec4 sampleTexture(int slot, vec2 texCoords);
+// Define COMPACT_GBUFFER before the include for the compact layout: no position (reconstructed from depth),
+// octahedral normals in RG16 and the material channels in RGBA8, see lib/gbuffer_decode.glsl
+
+#include "lib/octahedral.glsl"
+
+#define BASE_COLOR_SLOT 0 // Slots follow the PrimitiveMaterial field order
+#define METALLIC_ROUGHNESS_SLOT 1
+#define NORMAL_SLOT 2
+#define OCCLUSION_SLOT 3
+#define EMISSIVE_SLOT 4
+
+layout(location = 0) in vec2 vTexCoords;
+layout(location = 1) in vec3 vFragPos;
+layout(location = 2) in mat3 vTBN;
+
+#ifdef COMPACT_GBUFFER
+layout(location = 0) out vec2 gNormal;
+layout(location = 1) out vec4 gAlbedo;
+layout(location = 2) out vec4 gEmissive;
+layout(location = 3) out vec4 gMetallicRoughnessAO;
+#else
+layout(location = 0) out vec3 gPosition;
+layout(location = 1) out vec3 gNormal;
+layout(location = 2) out vec3 gAlbedo;
+layout(location = 3) out vec3 gEmissive;
+layout(location = 4) out vec3 gMetallicRoughnessAO;
+#endif
+
+bool hasTexture(int slot);
+vec4 sampleTexture(int slot, vec2 texCoords);
+
+void writeGBuffer() {
+    vec3 baseColor;
+    float alpha = 1.0;
+    if(hasTexture(BASE_COLOR_SLOT)) {
+        vec4 color = sampleTexture(BASE_COLOR_SLOT, vTexCoords);
+        baseColor = color.rgb;
+        alpha = color.a;
+    }
+
+    if(alpha < 0.5) {
+        discard;
+    }
+
+    float metallic = 0.0;
+    float roughness = 0.5;
+    if(hasTexture(METALLIC_ROUGHNESS_SLOT)) {
+        vec4 metallicRoughness = sampleTexture(METALLIC_ROUGHNESS_SLOT, vTexCoords);
+        metallic = metallicRoughness.b;
+        roughness = metallicRoughness.g;
+    }
+
+    vec3 normal = normalize(vTBN[2]);
+    if(hasTexture(NORMAL_SLOT)) {
+        vec3 normalColor = sampleTexture(NORMAL_SLOT, vTexCoords).rgb;
+        vec3 tangentNormal = normalColor * 2.0 - 1.0;
+        normal = tangentNormal * transpose(vTBN);
+    }
+
+    float ao = 1.0;
+    if(hasTexture(OCCLUSION_SLOT)) {
+        ao = sampleTexture(OCCLUSION_SLOT, vTexCoords).r;
+    }
+
+    vec3 emissive;
+    if(hasTexture(EMISSIVE_SLOT)) {
+        emissive = sampleTexture(EMISSIVE_SLOT, vTexCoords).rgb;
+    }
+
+#ifdef COMPACT_GBUFFER
+    gNormal = encodeOctahedral(normalize(normal));
+    gAlbedo = vec4(baseColor, 1.0);
+    gEmissive = vec4(emissive, 1.0);
+    gMetallicRoughnessAO = vec4(metallic, roughness, ao, 1.0);
+#else
+    gPosition = vFragPos;
+    gNormal = normal;
+    gAlbedo = baseColor;
+    gEmissive = emissive;
+    gMetallicRoughnessAO = vec3(metallic, roughness, ao);
+#endif
+}
+
+#endif
@@ -0,0 +1,64 @@
+#ifndef GBUFFER_DECODE_GLSL
+#define GBUFFER_DECODE_GLSL
+
+// Reads back what lib/gbuffer.glsl wrote, define COMPACT_GBUFFER before the include for the compact layout.
+// The G-Buffer textures take units 0-4, the compact layout binds depth in place of the position
+
+#include "lib/octahedral.glsl"
+
+struct GBuffer {
+    vec3 position; // World space
+    vec3 normal;
+    vec3 baseColor;
+    vec3 emissive;
+    float metallic;
+    float roughness;
+    float ao;
+};
+
+#ifdef COMPACT_GBUFFER
+layout(binding = 0) uniform sampler2D gDepth;
+#else
+layout(binding = 0) uniform sampler2D gPosition;
+#endif
+layout(binding = 1) uniform sampler2D gNormal;
+layout(binding = 2) uniform sampler2D gAlbedo;
+layout(binding = 3) uniform sampler2D gEmissive;
+layout(binding = 4) uniform sampler2D gMetallicRoughnessAO;
+
+vec3 reconstructPosition(vec2 texCoords, float depth, mat4 inverseProjection, mat4 inverseView) {
+    vec4 position = inverseProjection * vec4(vec3(texCoords, depth) * 2.0 - 1.0, 1.0);
+    return (inverseView * vec4(position.xyz / position.w, 1.0)).xyz;
+}
+
+vec3 fetchPosition(vec2 texCoords, mat4 inverseProjection, mat4 inverseView) {
+#ifdef COMPACT_GBUFFER
+    return reconstructPosition(texCoords, texture(gDepth, texCoords).r, inverseProjection, inverseView);
+#else
+    return texture(gPosition, texCoords).rgb;
+#endif
+}
+
+vec3 fetchNormal(vec2 texCoords) {
+#ifdef COMPACT_GBUFFER
+    return decodeOctahedral(texture(gNormal, texCoords).rg);
+#else
+    return texture(gNormal, texCoords).rgb;
+#endif
+}
+
+GBuffer fetchGBuffer(vec2 texCoords, mat4 inverseProjection, mat4 inverseView) {
+    GBuffer gBuffer;
+    gBuffer.position = fetchPosition(texCoords, inverseProjection, inverseView);
+    gBuffer.normal = fetchNormal(texCoords);
+    gBuffer.baseColor = texture(gAlbedo, texCoords).rgb;
+    gBuffer.emissive = texture(gEmissive, texCoords).rgb;
+
+    vec3 metallicRoughnessAO = texture(gMetallicRoughnessAO, texCoords).rgb;
+    gBuffer.metallic = metallicRoughnessAO.r;
+    gBuffer.roughness = metallicRoughnessAO.g;
+    gBuffer.ao = metallicRoughnessAO.b;
+    return gBuffer;
+}
+
+#endif
@@ -0,0 +1,54 @@
+#ifndef LIGHT_GLSL
+#define LIGHT_GLSL
+
+// Mirrors LocalLight of light.hpp (std430)
+struct LocalLight {
+    vec3 position;
+    float radius;
+    vec3 color;
+    float intensity;
+    vec3 direction;
+    float spotScale;
+    float spotOffset;
+    float padding0;
+    float padding1;
+    float padding2;
+};
+
+// Mirrors LightClustersUniform of passes/light_culling_pass.cpp (std140)
+struct LightClusters {
+    mat4 inverseProjection;
+    uvec4 gridSize; // w = number of lights
+    vec2 screenSize;
+    float zNear;
+    float zFar;
+    float sliceScale;
+    float sliceBias;
+    vec2 padding;
+};
+
+uint getNumClusters(LightClusters clusters) {
+    return clusters.gridSize.x * clusters.gridSize.y * clusters.gridSize.z;
+}
+
+// viewDepth is the positive distance along the view direction
+uint getClusterIndex(LightClusters clusters, vec2 fragCoord, float viewDepth) {
+    uvec3 gridSize = clusters.gridSize.xyz;
+    uvec2 tile = min(uvec2(fragCoord / clusters.screenSize * vec2(gridSize.xy)), gridSize.xy - 1u);
+    float slice = log(max(viewDepth, clusters.zNear)) * clusters.sliceScale + clusters.sliceBias;
+    uint z = min(uint(max(slice, 0.0)), gridSize.z - 1u);
+    return tile.x + gridSize.x * (tile.y + gridSize.y * z);
+}
+
+// Smooth window that reaches zero at the light radius, times the spot cone falloff
+float getLightAttenuation(LocalLight light, vec3 toLight) {
+    float distanceRatio = length(toLight) / light.radius;
+    float window = clamp(1.0 - distanceRatio * distanceRatio, 0.0, 1.0);
+
+    float cosAngle = dot(-normalize(toLight), light.direction);
+    float cone = clamp(cosAngle * light.spotScale + light.spotOffset, 0.0, 1.0);
+
+    return window * window * cone * cone;
+}
+
+#endif
@@ -0,0 +1,24 @@
+#ifndef MATERIAL_GLSL
+#define MATERIAL_GLSL
+
+// Mirrors vgfw::resource::PrimitiveMaterial, indices are texture units relative to the first bound one, -1 = none
+struct PrimitiveMaterial {
+    int baseColorTextureIndex;
+    int metallicRoughnessTextureIndex;
+    int normalTextureIndex;
+    int occlusionTextureIndex;
+    int emissiveTextureIndex;
+};
+
+int getTextureIndex(PrimitiveMaterial material, int slot) {
+    switch(slot) {
+        case 0: return material.baseColorTextureIndex;
+        case 1: return material.metallicRoughnessTextureIndex;
+        case 2: return material.normalTextureIndex;
+        case 3: return material.occlusionTextureIndex;
+        case 4: return material.emissiveTextureIndex;
+    }
+    return -1;
+}
+
+#endif
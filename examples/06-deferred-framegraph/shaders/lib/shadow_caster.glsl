@@ -0,0 +1,23 @@
+#ifndef SHADOW_CASTER_GLSL
+#define SHADOW_CASTER_GLSL
+
+// Shared alpha test of the shadow casters, the including shader defines how material textures are reached (as for
+// lib/gbuffer.glsl):
+//   bool hasTexture(int slot);
+//   vec4 sampleTexture(int slot, vec2 texCoords);
+
+#define BASE_COLOR_SLOT 0
+
+layout(location = 0) in vec2 vTexCoords;
+
+bool hasTexture(int slot);
+vec4 sampleTexture(int slot, vec2 texCoords);
+
+// Same cutoff as the G-Buffer, so that foliage casts the shadow of what is drawn
+void alphaTest() {
+    if(hasTexture(BASE_COLOR_SLOT) && sampleTexture(BASE_COLOR_SLOT, vTexCoords).a < 0.5) {
+        discard;
+    }
+}
+
+#endif
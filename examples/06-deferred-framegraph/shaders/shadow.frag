@@ -0,0 +1,22 @@
+#version 450
+
+#include "lib/material.glsl"
+#include "lib/shadow_caster.glsl"
+
+layout(binding = 1) uniform Material {
+    PrimitiveMaterial uMaterial;
+};
+
+layout(binding = 0) uniform sampler2D pbrTextures[5];
+
+bool hasTexture(int slot) {
+    return getTextureIndex(uMaterial, slot) != -1;
+}
+
+vec4 sampleTexture(int slot, vec2 texCoords) {
+    return texture(pbrTextures[getTextureIndex(uMaterial, slot)], texCoords);
+}
+
+void main() {
+    alphaTest();
+}
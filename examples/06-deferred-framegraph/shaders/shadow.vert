@@ -0,0 +1,26 @@
+#version 450
+// Either one lets the vertex shader pick the layer, ShadowPass is only used when the driver has one of them
+#extension GL_ARB_shader_viewport_layer_array : enable
+#extension GL_AMD_vertex_shader_layer : enable
+
+#include "lib/cascades.glsl"
+
+layout(location = 0) in vec3 aPos;
+layout(location = 2) in vec2 aTexCoords;
+
+layout(location = 0) out vec2 vTexCoords;
+
+layout(binding = 0) uniform Cascades {
+    ShadowCascades uCascades;
+};
+
+layout(location = 0) uniform mat4 uModel;
+layout(location = 4) uniform uint uCascadeMask; // Cascades the primitive intersects
+
+void main() {
+    uint cascade = getInstanceCascade(uCascadeMask, gl_InstanceID);
+
+    gl_Position = uCascades.viewProjections[cascade] * uModel * vec4(aPos, 1.0);
+    gl_Layer = int(cascade);
+    vTexCoords = aTexCoords;
+}
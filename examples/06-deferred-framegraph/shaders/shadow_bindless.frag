@@ -0,0 +1,19 @@
+#version 450
+#extension GL_ARB_bindless_texture : require
+
+#include "lib/draw_data.glsl"
+#include "lib/shadow_caster.glsl"
+
+layout(location = 5) flat in int vDrawIndex;
+
+bool hasTexture(int slot) {
+    return draws[vDrawIndex].textureHandles[slot] != uvec2(0);
+}
+
+vec4 sampleTexture(int slot, vec2 texCoords) {
+    return texture(sampler2D(draws[vDrawIndex].textureHandles[slot]), texCoords);
+}
+
+void main() {
+    alphaTest();
+}
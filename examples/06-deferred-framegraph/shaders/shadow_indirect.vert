@@ -0,0 +1,32 @@
+#version 450
+#extension GL_ARB_shader_draw_parameters : require
+// Either one lets the vertex shader pick the layer, ShadowPass is only used when the driver has one of them
+#extension GL_ARB_shader_viewport_layer_array : enable
+#extension GL_AMD_vertex_shader_layer : enable
+
+#include "lib/cascades.glsl"
+#include "lib/draw_data.glsl"
+
+layout(location = 0) in vec3 aPos;
+layout(location = 2) in vec2 aTexCoords;
+
+layout(location = 0) out vec2 vTexCoords;
+layout(location = 5) flat out int vDrawIndex;
+
+layout(binding = 0) uniform Cascades {
+    ShadowCascades uCascades;
+};
+
+layout(binding = 1, std430) readonly buffer CascadeMasks {
+    uint cascadeMasks[]; // Per command, which also has one instance per set bit
+};
+
+void main() {
+    // DrawCommandBuilder stores the command index as base instance
+    vDrawIndex = gl_BaseInstanceARB;
+    uint cascade = getInstanceCascade(cascadeMasks[vDrawIndex], gl_InstanceID);
+
+    gl_Position = uCascades.viewProjections[cascade] * draws[vDrawIndex].modelMatrix * vec4(aPos, 1.0);
+    gl_Layer = int(cascade);
+    vTexCoords = aTexCoords;
+}
@@ -2,6 +2,9 @@
 
 #include "camera.hpp"
 
+#include "vgfw.hpp"
+
 #include <fg/Fwd.hpp>
 
-void uploadCameraUniform(FrameGraph& fg, FrameGraphBlackboard& blackboard, const Camera::CameraUniform& cameraUniform);
\ No newline at end of file
+// Uniforms live in the per-frame uniform ring, call after renderer::beginFrame
+void uploadCameraUniform(vgfw::renderer::RenderContext& rc, FrameGraphBlackboard& blackboard, const Camera& camera);
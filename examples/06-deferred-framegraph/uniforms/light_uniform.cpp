@@ -1,22 +1,18 @@
 #include "uniforms/light_uniform.hpp"
 #include "pass_resource/light_data.hpp"
+#include "retained_frame_graph.hpp"
 
 #include "vgfw.hpp"
 
-void uploadLightUniform(FrameGraph& fg, FrameGraphBlackboard& blackboard, const DirectionalLight& light)
+void uploadLightUniform(vgfw::renderer::RenderContext& rc,
+                        FrameGraphBlackboard&          blackboard,
+                        const DirectionalLight&        light,
+                        std::span<const LocalLight>    localLights)
 {
-    blackboard.add<LightData>() = fg.addCallbackPass<LightData>(
-        "Upload LightUniform",
-        [&](FrameGraph::Builder& builder, LightData& data) {
-            data.lightUniform = builder.create<vgfw::renderer::framegraph::FrameGraphBuffer>(
-                "LightUniform", {.size = sizeof(DirectionalLight)});
-            data.lightUniform = builder.write(data.lightUniform);
-        },
-        [=](const LightData& data, FrameGraphPassResources& resources, void* ctx) {
-            static_cast<vgfw::renderer::RenderContext*>(ctx)->upload(
-                vgfw::renderer::framegraph::getBuffer(resources, data.lightUniform),
-                0,
-                sizeof(DirectionalLight),
-                &light);
-        });
-}
\ No newline at end of file
+    auto& lightData = getOrAdd<LightData>(blackboard);
+
+    lightData = {
+        .lightUniform = rc.uploadUniform(light),
+        .localLights  = localLights,
+    };
+}
@@ -2,6 +2,13 @@
 
 #include "light.hpp"
 
+#include "vgfw.hpp"
+
 #include <fg/Fwd.hpp>
 
-void uploadLightUniform(FrameGraph& fg, FrameGraphBlackboard& blackboard, const DirectionalLight& light);
\ No newline at end of file
+// Uniforms live in the per-frame uniform ring, call after renderer::beginFrame. localLights must stay alive until
+// the graph is executed
+void uploadLightUniform(vgfw::renderer::RenderContext& rc,
+                        FrameGraphBlackboard&          blackboard,
+                        const DirectionalLight&        light,
+                        std::span<const LocalLight>    localLights);
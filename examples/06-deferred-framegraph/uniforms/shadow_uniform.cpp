@@ -0,0 +1,62 @@
+#include "uniforms/shadow_uniform.hpp"
+#include "pass_resource/shadow_data.hpp"
+#include "retained_frame_graph.hpp"
+
+#include "vgfw.hpp"
+
+namespace
+{
+    // Matches ShadowCascades of lib/cascades.glsl (std140)
+    struct CascadesUniform
+    {
+        glm::mat4 viewProjections[ShadowData::kMaxCascades];
+        glm::vec4 splitDepths;
+        glm::vec4 texelSizes;
+        uint32_t  numCascades;
+        float     normalBias;
+        glm::vec2 padding;
+    };
+    static_assert(sizeof(CascadesUniform) == 304);
+} // namespace
+
+void uploadShadowUniform(vgfw::renderer::RenderContext& rc,
+                         FrameGraphBlackboard&          blackboard,
+                         const Camera&                  camera,
+                         const DirectionalLight&        light,
+                         const ShadowSettings&          settings)
+{
+    assert(settings.numCascades <= ShadowData::kMaxCascades);
+
+    auto& shadowData = getOrAdd<ShadowData>(blackboard);
+
+    CascadesUniform uniform {.numCascades = settings.numCascades, .normalBias = settings.normalBias};
+    shadowData.casterFrusta.clear();
+
+    if (settings.numCascades > 0)
+    {
+        const auto cascades = vgfw::renderer::shadow::buildCascades(camera.zNear,
+                                                                    camera.zFar,
+                                                                    camera.data.projection * camera.data.view,
+                                                                    light.direction,
+                                                                    settings.numCascades,
+                                                                    settings.splitLambda,
+                                                                    settings.shadowMapSize);
+        for (uint32_t i = 0; i < cascades.size(); ++i)
+        {
+            const auto& viewProjection = cascades[i].viewProjection;
+
+            uniform.viewProjections[i] = viewProjection;
+            uniform.splitDepths[i]     = -cascades[i].splitDepth;
+            // The view is a rotation, so the x row of the orthographic projection has a length of 2 / width
+            const glm::vec3 xRow {viewProjection[0][0], viewProjection[1][0], viewProjection[2][0]};
+            uniform.texelSizes[i] = 2.0f / (glm::length(xRow) * static_cast<float>(settings.shadowMapSize));
+
+            // Depth clamping flattens casters in front of the near plane onto it
+            auto& frustum     = shadowData.casterFrusta.emplace_back(
+                vgfw::culling::Frustum::fromViewProjection(viewProjection));
+            frustum.planes[4] = glm::vec4 {0.0f, 0.0f, 0.0f, 1.0f};
+        }
+    }
+
+    shadowData.cascadesUniform = rc.uploadUniform(uniform);
+}
@@ -0,0 +1,24 @@
+#pragma once
+
+#include "camera.hpp"
+#include "light.hpp"
+
+#include "vgfw.hpp"
+
+#include <fg/Fwd.hpp>
+
+struct ShadowSettings
+{
+    uint32_t numCascades {4}; // 0 = no shadows, up to ShadowData::kMaxCascades
+    uint32_t shadowMapSize {2048};
+    float    splitLambda {0.75f}; // 0 = uniform splits, 1 = logarithmic
+    float    normalBias {1.5f};   // In texels of the cascade
+};
+
+// Builds the cascades of the light once per frame, uniforms live in the per-frame uniform ring, call after
+// renderer::beginFrame
+void uploadShadowUniform(vgfw::renderer::RenderContext& rc,
+                         FrameGraphBlackboard&          blackboard,
+                         const Camera&                  camera,
+                         const DirectionalLight&        light,
+                         const ShadowSettings&          settings);
@@ -20,6 +20,8 @@
 
 #include <algorithm>
 #include <array>
+#include <bit>
+#include <fstream>
 #include <iostream>
 #include <limits>
 #include <numeric>
@@ -47,6 +49,22 @@
 #error "Unsupported Platform"
 #endif
 
+// SIMD instruction set of the batch culling kernels (scalar when none is available)
+#define VGFW_SIMD_AVX 0
+#define VGFW_SIMD_SSE 0
+#define VGFW_SIMD_NEON 0
+
+#if defined(__AVX__)
+#undef VGFW_SIMD_AVX
+#define VGFW_SIMD_AVX 1
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#undef VGFW_SIMD_SSE
+#define VGFW_SIMD_SSE 1
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#undef VGFW_SIMD_NEON
+#define VGFW_SIMD_NEON 1
+#endif
+
 #define VGFW_RENDER_API_OPENGL_MIN_MAJOR 3
 #define VGFW_RENDER_API_OPENGL_MIN_MINOR 3
 
@@ -58,6 +76,23 @@
 #define VGFW_RENDER_API_OPENGL_MIN_MINOR 6
 #endif
 
+#ifdef VGFW_IMPLEMENTATION
+#if VGFW_PLATFORM_LINUX
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#if VGFW_SIMD_AVX
+#include <immintrin.h>
+#elif VGFW_SIMD_SSE
+#include <emmintrin.h>
+#elif VGFW_SIMD_NEON
+#include <arm_neon.h>
+#endif
+#endif
+
 #define VGFW_TRACE(...) ::vgfw::log::g_Logger->trace(__VA_ARGS__)
 #define VGFW_INFO(...) ::vgfw::log::g_Logger->info(__VA_ARGS__)
 #define VGFW_WARN(...) ::vgfw::log::g_Logger->warn(__VA_ARGS__)
@@ -72,19 +107,42 @@
 // clang-format on
 
 #include <array>
+#include <atomic>
 #include <chrono>
+#include <condition_variable>
+#include <cstddef>
 #include <cstdint>
 #include <cstring>
+#include <deque>
 #include <filesystem>
+#include <functional>
+#include <future>
 #include <map>
 #include <memory>
+#include <mutex>
+#include <shared_mutex>
 #include <optional>
+#include <queue>
+#include <set>
+#include <span>
 #include <string>
+#include <string_view>
+#include <thread>
+#include <tuple>
+#include <utility>
 #include <unordered_map>
 #include <variant>
 
 #include <glad/glad.h>
 
+// GL_EXT_texture_compression_s3tc is not core, but every desktop driver has it
+#ifndef GL_COMPRESSED_RGBA_S3TC_DXT1_EXT
+#define GL_COMPRESSED_RGBA_S3TC_DXT1_EXT 0x83F1
+#endif
+#ifndef GL_COMPRESSED_RGBA_S3TC_DXT5_EXT
+#define GL_COMPRESSED_RGBA_S3TC_DXT5_EXT 0x83F3
+#endif
+
 #ifdef VGFW_ENABLE_TRACY
 #define TRACY_ENABLE
 #include <tracy/Tracy.hpp>
@@ -118,6 +176,14 @@
 #define DEBUG_MARKER()
 #endif
 
+// Expands its arguments before pasting, so that VGFW_CONCAT(x, __LINE__) gives x123
+#define VGFW_CONCAT_IMPL(a, b) a##b
+#define VGFW_CONCAT(a, b) VGFW_CONCAT_IMPL(a, b)
+
+// CPU and GPU time of the enclosing scope, recorded by the RenderContext's FrameProfiler (with or without Tracy)
+#define VGFW_TIMED_SCOPE(rc, name) \
+    const ::vgfw::renderer::ProfileScope VGFW_CONCAT(ps, __LINE__) { (rc).getProfiler(), name }
+
 #include <GLFW/glfw3.h>
 #if VGFW_PLATFORM_LINUX
 #define GLFW_EXPOSE_NATIVE_X11
@@ -129,6 +195,7 @@
 #include <GLFW/glfw3native.h>
 
 #include <glm/glm.hpp>
+#include <glm/gtc/packing.hpp>
 #include <glm/gtc/type_ptr.hpp>
 
 #include <fg/Blackboard.hpp>
@@ -150,6 +217,7 @@ namespace vgfw
     namespace renderer
     {
         class GraphicsContext;
+        class RenderContext;
     }
     namespace resource
     {
@@ -163,6 +231,92 @@ namespace vgfw
         void hashCombine(std::size_t& seed, const T& v, const Rest&... rest);
 
         std::string readFileAllText(const std::filesystem::path& filePath);
+
+        // Fixed number of worker threads consuming tasks in FIFO order
+        class ThreadPool
+        {
+        public:
+            explicit ThreadPool(uint32_t numThreads = std::max(2u, std::thread::hardware_concurrency()) - 1);
+            ThreadPool(const ThreadPool&) = delete;
+            ThreadPool(ThreadPool&&)      = delete;
+            // Tasks that did not start yet are discarded
+            ~ThreadPool();
+
+            ThreadPool& operator=(const ThreadPool&) = delete;
+            ThreadPool& operator=(ThreadPool&&)      = delete;
+
+            void submit(std::function<void()> task);
+
+            uint32_t getNumThreads() const;
+
+        private:
+            void workerLoop();
+
+        private:
+            std::vector<std::thread>          m_Workers;
+            std::queue<std::function<void()>> m_Tasks;
+            std::mutex                        m_Mutex;
+            std::condition_variable           m_Condition;
+            bool                              m_Stop {false};
+        };
+
+        // Open addressing (linear probing) map for keys that already are hashes, all values live in one array
+        template<typename T>
+        class FlatHashMap
+        {
+        public:
+            T&       operator[](std::size_t key);
+            T*       find(std::size_t key);
+            const T* find(std::size_t key) const;
+
+            // Visits every (key, value)
+            template<typename F>
+            void forEach(F&&);
+            // The predicate takes (key, value) and may see an element twice, so it must not have side effects
+            template<typename Predicate>
+            void eraseIf(Predicate&&);
+
+            std::size_t size() const;
+            bool        empty() const;
+            void        clear();
+
+        private:
+            std::size_t findSlot(std::size_t key) const;
+            void        eraseSlot(std::size_t index);
+            void        grow();
+
+        private:
+            struct Slot
+            {
+                std::size_t      key {0};
+                std::optional<T> value; // Empty slot when not set
+            };
+            std::vector<Slot> m_Slots; // Power of 2 capacity, at most half full
+            std::size_t       m_Size {0};
+        };
+
+        // Read-only view of a whole file, mapped into memory
+        class MappedFile
+        {
+        public:
+            MappedFile() = delete;
+            // Empty (false) when the file could not be opened or mapped
+            explicit MappedFile(const std::filesystem::path&);
+            MappedFile(const MappedFile&) = delete;
+            MappedFile(MappedFile&&)      = delete;
+            ~MappedFile();
+
+            MappedFile& operator=(const MappedFile&) = delete;
+            MappedFile& operator=(MappedFile&&)      = delete;
+
+            explicit operator bool() const;
+
+            std::span<const std::byte> getData() const;
+
+        private:
+            const std::byte* m_Data {nullptr};
+            std::size_t      m_Size {0};
+        };
     } // namespace utils
 
     namespace time
@@ -191,6 +345,48 @@ namespace vgfw
         inline constexpr bool isPowerOf2(uint32_t v) { return v && !(v & (v - 1)); }
     } // namespace math
 
+    namespace culling
+    {
+        struct Frustum
+        {
+            // xyz = normal pointing inside, w = distance, in left, right, bottom, top, near, far order
+            std::array<glm::vec4, 6> planes;
+
+            // Planes of the clip volume of a (GL convention) view-projection matrix, in the space it transforms from
+            static Frustum fromViewProjection(const glm::mat4& viewProjection);
+
+            bool isVisible(const math::AABB&) const;
+        };
+
+        // Bounds stored as centers and half extents in structure-of-arrays layout, padded to whole SIMD batches
+        class BoundsList
+        {
+        public:
+            static constexpr uint32_t kBatchSize {8};
+
+            uint32_t add(const math::AABB&); // Returns the index of the bounds
+            void     set(uint32_t index, const math::AABB&);
+            void     reserve(uint32_t count);
+            void     clear();
+
+            uint32_t size() const;
+            bool     empty() const;
+
+            const float* getCenters(uint32_t axis) const;
+            const float* getExtents(uint32_t axis) const;
+
+        private:
+            uint32_t                          m_Size {0};
+            std::array<std::vector<float>, 3> m_Centers;
+            std::array<std::vector<float>, 3> m_Extents;
+        };
+
+        // Appends the (ascending) indices of the bounds intersecting the frustum, returns how many were appended
+        uint32_t cull(const Frustum&, const BoundsList&, std::vector<uint32_t>& visible);
+        // One mask per bounds, bit v is set when they intersect views[v] (at most 32), e.g. for layered rendering
+        void cullViews(std::span<const Frustum> views, const BoundsList&, std::vector<uint32_t>& masks);
+    } // namespace culling
+
     namespace log
     {
         static std::shared_ptr<spdlog::logger> g_Logger = nullptr;
@@ -217,6 +413,7 @@ namespace vgfw
             uint32_t    height       = 768;
             bool        isResizable  = false;
             bool        isFullScreen = false;
+            bool        isVisible    = true; // Hidden windows still render, e.g. for headless benchmarks
             AASample    aaSample     = AASample::e1;
         };
 
@@ -376,6 +573,7 @@ namespace vgfw
         class Buffer
         {
             friend class RenderContext;
+            friend class UniformRing;
 
         public:
             Buffer()              = default;
@@ -457,9 +655,15 @@ namespace vgfw
                 eInt4,
 
                 eUByte4_Norm,
+                eShort4_Norm,
+                eInt2_10_10_10_Rev_Norm, // Signed, xyz = 10 bits, w = 2 bits
+
+                eHalf2,
+                eHalf4,
             };
-            Type    vertType;
-            int32_t offset;
+            Type     vertType;
+            int32_t  offset;
+            uint32_t divisor {0}; // 0 = per vertex, otherwise sourced from the instance stream
         };
 
         using VertexAttributes = std::map<int32_t, VertexAttribute>;
@@ -471,7 +675,20 @@ namespace vgfw
             eTexCoords,
             eTangent,
             eBitangent,
+
+            // Per-instance stream, see InstanceData
+            eInstanceModelMatrix = 8, // mat4, takes four consecutive locations
+            eInstanceID          = 12,
+        };
+
+        // Default layout of the per-instance stream, set by VertexFormat::Builder::setInstanceData
+        struct InstanceData
+        {
+            glm::mat4 modelMatrix {1.0f};
+            int32_t   instanceId {0};
+            int32_t   padding[3] {};
         };
+        static_assert(sizeof(InstanceData) == 80);
 
         class VertexFormat
         {
@@ -491,6 +708,7 @@ namespace vgfw
             bool                    contains(std::initializer_list<AttributeLocation>) const;
 
             uint32_t getStride() const;
+            uint32_t getInstanceStride() const;
 
             class Builder final
             {
@@ -504,24 +722,29 @@ namespace vgfw
                 Builder& operator=(Builder&&) noexcept = delete;
 
                 Builder& setAttribute(AttributeLocation, const VertexAttribute&);
+                Builder& setInstanceAttribute(AttributeLocation, const VertexAttribute&, uint32_t divisor = 1);
+                Builder& setInstanceData(uint32_t divisor = 1);
 
                 std::shared_ptr<VertexFormat> build();
                 std::shared_ptr<VertexFormat> buildDefault();
 
             private:
                 VertexAttributes m_Attributes;
+                uint32_t         m_InstanceStride {0}; // 0: tightly packed instance attributes
 
                 using Cache = std::unordered_map<std::size_t, std::weak_ptr<VertexFormat>>;
-                inline static Cache s_Cache;
+                inline static Cache      s_Cache;
+                inline static std::mutex s_CacheMutex; // Formats may be built by loader threads
             };
 
         private:
-            VertexFormat(std::size_t hash, VertexAttributes&&, uint32_t stride);
+            VertexFormat(std::size_t hash, VertexAttributes&&, uint32_t stride, uint32_t instanceStride);
 
         private:
             const std::size_t      m_Hash {0u};
             const VertexAttributes m_Attributes;
             const uint32_t         m_Stride {0};
+            const uint32_t         m_InstanceStride {0};
         };
 
         int32_t getSize(VertexAttribute::Type type);
@@ -579,11 +802,14 @@ namespace vgfw
             eRGB8_SNorm  = GL_RGB8_SNORM,
             eRGBA8_SNorm = GL_RGBA8_SNORM,
 
+            eRG16_UNorm = GL_RG16,
+
             eR16F    = GL_R16F,
             eRG16F   = GL_RG16F,
             eRGB16F  = GL_RGB16F,
             eRGBA16F = GL_RGBA16F,
 
+            eR32F   = GL_R32F,
             eRGB32F = GL_RGB32F,
 
             eRGBA32F = GL_RGBA32F,
@@ -592,7 +818,13 @@ namespace vgfw
 
             eDepth16  = GL_DEPTH_COMPONENT16,
             eDepth24  = GL_DEPTH_COMPONENT24,
-            eDepth32F = GL_DEPTH_COMPONENT32F
+            eDepth32F = GL_DEPTH_COMPONENT32F,
+
+            // Block compressed, 4x4 texels per block
+            eBC1_UNorm = GL_COMPRESSED_RGBA_S3TC_DXT1_EXT,
+            eBC3_UNorm = GL_COMPRESSED_RGBA_S3TC_DXT5_EXT,
+            eBC5_UNorm = GL_COMPRESSED_RG_RGTC2,
+            eBC7_UNorm = GL_COMPRESSED_RGBA_BPTC_UNORM
         };
 
         enum class WrapMode
@@ -646,8 +878,6 @@ namespace vgfw
             GLuint m_Id {GL_NONE};
             GLenum m_Type {GL_NONE};
 
-            GLuint m_View {GL_NONE};
-
             Extent2D m_Extent {0u};
             uint32_t m_Depth {0u};
             uint32_t m_NumMipLevels {1u};
@@ -696,6 +926,16 @@ namespace vgfw
         uint32_t    calcMipLevels(uint32_t size);
         glm::uvec3  calcMipSize(const glm::uvec3& baseSize, uint32_t level);
         const char* toString(PixelFormat pixelFormat);
+        // 0 for block compressed formats, see getBlockSize
+        uint32_t    getBytesPerPixel(PixelFormat pixelFormat);
+        bool        isCompressed(PixelFormat pixelFormat);
+        // Bytes per 4x4 block of a block compressed format, 0 otherwise
+        uint32_t    getBlockSize(PixelFormat pixelFormat);
+        GLsizeiptr  calcCompressedSize(PixelFormat pixelFormat, glm::uvec2 dimensions);
+        // Of the whole storage (every mip level, layer and face)
+        GLsizeiptr  calcTextureSize(const Texture&);
+        // In the given type, ready to upload (eUInt32 is a plain copy)
+        std::vector<std::byte> narrowIndices(std::span<const uint32_t> indices, IndexType);
 
         struct DepthStencilState
         {
@@ -793,18 +1033,79 @@ namespace vgfw
             // clang-format on
         };
 
+        struct UniformHandle
+        {
+            GLint  location {-1};
+            GLuint program {GL_NONE}; // Only valid while this one is bound
+
+            explicit operator bool() const { return location != -1; }
+        };
+
+        // Active uniform locations of a linked program, reflected once at link time
+        class UniformTable
+        {
+        public:
+            void          reflect(GLuint program);
+            UniformHandle find(std::string_view name) const;
+
+        private:
+            struct StringHash
+            {
+                using is_transparent = void;
+                std::size_t operator()(std::string_view sv) const { return std::hash<std::string_view> {}(sv); }
+            };
+
+            GLuint                                                              m_Program {GL_NONE};
+            std::unordered_map<std::string, GLint, StringHash, std::equal_to<>> m_Locations;
+        };
+
+        // Program that may still be compiling/linking on driver threads (GL_KHR_parallel_shader_compile)
+        class ProgramHandle
+        {
+        public:
+            friend class RenderContext;
+            ProgramHandle() = default;
+
+            explicit operator bool() const;
+
+            // Never blocks, always true when the driver does not compile in parallel, false once failed or destroyed
+            bool isReady() const;
+            // Blocks until linked, throws on compile/link errors
+            GLuint get() const;
+
+        private:
+            struct State
+            {
+                GLuint              program {GL_NONE};
+                std::vector<GLuint> shaders;
+                std::size_t         cacheKey {0};
+                uint64_t            sourceHash {0};
+                bool                linked {false};
+                // Failed to link or destroyed, there is no GL program left to query
+                bool                released {false};
+            };
+            std::shared_ptr<State> m_State {nullptr};
+        };
+
         class GraphicsPipeline
         {
         public:
             friend class RenderContext;
             GraphicsPipeline() = default;
 
+            UniformHandle getUniform(std::string_view name) const;
+
+            // False while the program is still being compiled
+            bool isReady() const;
+
             class Builder
             {
             public:
                 Builder() = default;
 
                 Builder& setShaderProgram(GLuint program);
+                // build() does not wait, the program is resolved when the pipeline is first used
+                Builder& setShaderProgram(const ProgramHandle& program);
                 Builder& setVAO(GLuint vao);
                 Builder& setDepthStencil(const DepthStencilState&);
                 Builder& setRasterizerState(const RasterizerState&);
@@ -813,19 +1114,24 @@ namespace vgfw
                 GraphicsPipeline build();
 
             private:
-                GLuint m_Program = GL_NONE;
-                GLuint m_VAO     = GL_NONE;
+                GLuint        m_Program = GL_NONE;
+                ProgramHandle m_PendingProgram {};
+                GLuint        m_VAO = GL_NONE;
 
                 DepthStencilState                          m_DepthStencilState {};
                 RasterizerState                            m_RasterizerState {};
                 std::array<BlendState, kMaxNumBlendStates> m_BlendStates {};
             };
 
+        private:
+            GLuint getProgram() const;
+
         private:
             Rect2D m_Viewport, m_Scissor;
 
-            GLuint m_Program = GL_NONE;
-            GLuint m_VAO     = GL_NONE;
+            GLuint        m_Program = GL_NONE;
+            ProgramHandle m_PendingProgram {};
+            GLuint        m_VAO = GL_NONE;
 
             DepthStencilState                          m_DepthStencilState {};
             RasterizerState                            m_RasterizerState {};
@@ -842,6 +1148,13 @@ namespace vgfw
             const void* pixels {nullptr};
         };
 
+        // Blocks of one whole mip level, in the block compressed format of the texture
+        struct CompressedImageData
+        {
+            const void* data {nullptr};
+            GLsizei     size {0};
+        };
+
         template<typename T>
         using OptionalReference = std::optional<std::reference_wrapper<T>>;
 
@@ -876,18 +1189,282 @@ namespace vgfw
             ePatchList = GL_PATCHES
         };
 
+        // Persistently mapped ring that RenderContext::upload copies from, regions are retired by fences
+        class StagingRing
+        {
+        public:
+            struct Allocation
+            {
+                void*      data {nullptr};
+                GLintptr   offset {0};
+                GLsizeiptr size {0};
+
+                explicit operator bool() const { return data != nullptr; }
+            };
+
+            StagingRing()                   = default;
+            StagingRing(const StagingRing&) = delete;
+            StagingRing(StagingRing&&)      = delete;
+            ~StagingRing();
+
+            StagingRing& operator=(const StagingRing&) = delete;
+            StagingRing& operator=(StagingRing&&)      = delete;
+
+            void create(GLsizeiptr capacity);
+            void destroy();
+
+            // Thread-safe and does not need a GL context. Returns an empty allocation when the ring is full.
+            // The memory stays valid until the end of the frame it was allocated in (renderer::endFrame),
+            // hand it to RenderContext::upload before that, which then skips the extra copy.
+            Allocation allocate(GLsizeiptr size, GLsizeiptr alignment = kDefaultAlignment);
+
+            // GL thread only: retire everything allocated so far once the GPU passes this point
+            void fence();
+            // GL thread only: release retired regions, optionally waiting for the oldest fence
+            bool reclaim(bool wait);
+
+            GLuint     getId() const;
+            GLsizeiptr getCapacity() const;
+            bool       contains(const void* ptr) const;
+            GLintptr   getOffset(const void* ptr) const;
+
+            static constexpr GLsizeiptr kDefaultAlignment {16};
+
+        private:
+            struct Fence
+            {
+                GLsync   sync {nullptr};
+                uint64_t head {0};
+            };
+
+            GLuint     m_Id {GL_NONE};
+            std::byte* m_MappedMemory {nullptr};
+            GLsizeiptr m_Capacity {0};
+
+            // Virtual offsets that only ever grow, the physical offset is (offset % capacity)
+            std::mutex        m_Mutex;
+            uint64_t          m_Head {0};
+            uint64_t          m_Tail {0};
+            std::queue<Fence> m_Fences;
+        };
+
+        struct UniformAllocation
+        {
+            void*         data {nullptr};
+            GLintptr      offset {0};
+            GLsizeiptr    size {0};
+            const Buffer* buffer {nullptr}; // The ring, or an overflow buffer of the frame
+
+            explicit operator bool() const { return data != nullptr; }
+        };
+
+        // Linear allocator over one persistently mapped uniform buffer split in per-frame regions, a region is
+        // reused once the fence of the frame that last wrote to it has signaled
+        class UniformRing
+        {
+        public:
+            UniformRing()                   = default;
+            UniformRing(const UniformRing&) = delete;
+            UniformRing(UniformRing&&)      = delete;
+            ~UniformRing();
+
+            UniformRing& operator=(const UniformRing&) = delete;
+            UniformRing& operator=(UniformRing&&)      = delete;
+
+            // Overflow buffers are destroyed through rc, which tracks their bindings
+            void create(RenderContext& rc, GLsizeiptr frameSize, uint32_t numFrames);
+            void destroy();
+
+            void beginFrame();
+            void endFrame();
+
+            // Aligned to GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, valid until the end of the frame. Spills into overflow
+            // buffers once the frame region is used up.
+            UniformAllocation allocate(GLsizeiptr size);
+
+            const Buffer& getBuffer() const;
+
+        private:
+            UniformAllocation allocateOverflow(GLsizeiptr size);
+            void              releaseOverflow(uint32_t frameIndex);
+
+        private:
+            RenderContext*      m_RenderContext {nullptr};
+            Buffer              m_Buffer;
+            std::byte*          m_MappedMemory {nullptr};
+            GLsizeiptr          m_FrameSize {0};
+            GLsizeiptr          m_Alignment {256};
+            uint32_t            m_FrameIndex {0};
+            GLsizeiptr          m_Offset {0}; // Within the current frame region
+            std::vector<GLsync> m_Fences;
+
+            // Per frame, released with its region. Allocations point at them, hence the indirection.
+            std::vector<std::vector<std::unique_ptr<Buffer>>> m_OverflowBuffers;
+            GLsizeiptr                                        m_OverflowOffset {0}; // Within the last one
+        };
+
+        struct StateChangeCounters
+        {
+            uint32_t issued {0};  // state changes that reached GL
+            uint32_t skipped {0}; // redundant ones filtered by the shadow state
+        };
+
+        struct FrameCounters
+        {
+            uint32_t   numDrawCalls {0}; // An indirect or multi-draw call counts once
+            uint32_t   numDispatches {0};
+            GLsizeiptr uploadedBytes {0}; // Buffer and texture uploads
+            uint32_t   numTransientAcquisitions {0};
+            uint32_t   numTransientAllocations {0}; // Acquisitions that had to create a resource
+        };
+
+        // Per-frame CPU and GPU (GL_TIMESTAMP queries) times of named scopes, with the frame's counters. Every
+        // frame has its own query pool, read back kNumFrames later once the results are available, so reading never
+        // stalls: results lag behind by that many frames, and a frame whose queries are still pending has no GPU
+        // times.
+        class FrameProfiler
+        {
+        public:
+            static constexpr uint32_t kNumFrames {3};
+            static constexpr uint32_t kHistorySize {240};
+
+            struct Scope
+            {
+                std::string name;
+                uint32_t    depth {0};       // Nesting level, 0 = directly in the frame
+                float       cpuTime {0.0f};  // Milliseconds
+                float       gpuTime {-1.0f}; // Milliseconds, < 0 when unknown
+            };
+            struct Frame
+            {
+                uint64_t            index {0};
+                float               cpuTime {0.0f};
+                float               gpuTime {-1.0f};
+                std::vector<Scope>  scopes; // In the order they began
+                FrameCounters       counters;
+                StateChangeCounters stateChanges;
+            };
+
+            FrameProfiler() = default;
+            FrameProfiler(const FrameProfiler&)     = delete;
+            FrameProfiler(FrameProfiler&&) noexcept = delete;
+            ~FrameProfiler();
+
+            FrameProfiler& operator=(const FrameProfiler&)     = delete;
+            FrameProfiler& operator=(FrameProfiler&&) noexcept = delete;
+
+            // Enabled by default, the cost is two queries per scope
+            void setEnabled(bool enabled);
+            bool isEnabled() const;
+
+            // Called by RenderContext::beginFrame/endFrame
+            void beginFrame();
+            void endFrame(const FrameCounters&, const StateChangeCounters&);
+
+            // Scopes nest, @return the id to end it with (scopes outside of a frame are ignored)
+            uint32_t beginScope(std::string_view name);
+            void     endScope(uint32_t id);
+
+            // Of the frame being recorded, or the next one between frames (Frame::index)
+            uint64_t getFrameIndex() const;
+
+            // Read back frames, oldest first
+            const std::deque<Frame>& getHistory() const;
+            // nullptr before the first frame is read back
+            const Frame* getLastFrame() const;
+
+            // One row per scope, and a "Frame" row with the counters, for every frame of the history
+            void writeCSV(std::ostream&) const;
+            void writeJSON(std::ostream&) const;
+
+        private:
+            static constexpr uint32_t kNoScope {std::numeric_limits<uint32_t>::max()};
+
+            struct PendingScope
+            {
+                std::string     name;
+                uint32_t        depth {0};
+                time::TimePoint cpuBegin, cpuEnd;
+            };
+            // Queries 0 and 1 time the frame, 2 + 2 * i and 3 + 2 * i the i-th scope
+            struct PendingFrame
+            {
+                bool                      recorded {false}; // Begun and ended, the queries wait to be read
+                uint64_t                  index {0};
+                time::TimePoint           cpuBegin, cpuEnd;
+                std::vector<PendingScope> scopes;
+                std::vector<GLuint>       queries;
+                FrameCounters             counters;
+                StateChangeCounters       stateChanges;
+            };
+            PendingFrame& getCurrentFrame();
+            GLuint        getQuery(PendingFrame&, uint32_t index);
+            void          resolve(PendingFrame&);
+
+        private:
+            bool                                 m_Enabled {true};
+            bool                                 m_InFrame {false};
+            uint64_t                             m_FrameIndex {0};
+            uint32_t                             m_Depth {0};
+            std::array<PendingFrame, kNumFrames> m_Frames;
+            std::deque<Frame>                    m_History;
+        };
+
+        class ProfileScope
+        {
+        public:
+            ProfileScope(FrameProfiler&, std::string_view name);
+            ProfileScope(const ProfileScope&)     = delete;
+            ProfileScope(ProfileScope&&) noexcept = delete;
+            ~ProfileScope();
+
+            ProfileScope& operator=(const ProfileScope&)     = delete;
+            ProfileScope& operator=(ProfileScope&&) noexcept = delete;
+
+        private:
+            FrameProfiler& m_Profiler;
+            uint32_t       m_Id;
+        };
+
         class RenderContext
         {
         public:
             RenderContext();
             ~RenderContext();
 
+            // Reset by renderer::beginFrame, so these are per-frame numbers
+            const StateChangeCounters& getStateChangeCounters() const;
+            RenderContext&             resetStateChangeCounters();
+            const FrameCounters&       getFrameCounters() const;
+            // For the transient resource pool, the other counters are kept by the RenderContext itself
+            RenderContext& countTransientAcquisition(bool allocated);
+
+            FrameProfiler& getProfiler();
+
+            // Called by renderer::beginFrame/endFrame
+            RenderContext& beginFrame();
+            RenderContext& endFrame();
+
+            StagingRing& getStagingRing();
+
+            // Constant data for the current frame, bind with bindUniformBuffer(index, allocation)
+            UniformAllocation allocateUniform(GLsizeiptr size);
+            template<typename T>
+            UniformAllocation uploadUniform(const T& data)
+            {
+                auto allocation = allocateUniform(sizeof(T));
+                if (allocation)
+                    memcpy(allocation.data, &data, sizeof(T));
+                return allocation;
+            }
+
             RenderContext& setViewport(const Rect2D& rect);
             static Rect2D  getViewport();
 
             RenderContext& setScissor(const Rect2D& rect);
 
-            static Buffer       createBuffer(GLsizeiptr size, const void* data = nullptr);
+            static Buffer
+            createBuffer(GLsizeiptr size, const void* data = nullptr, GLbitfield flags = GL_DYNAMIC_STORAGE_BIT);
             static VertexBuffer createVertexBuffer(GLsizei stride, int64_t capacity, const void* data = nullptr);
             static IndexBuffer  createIndexBuffer(IndexType, int64_t capacity, const void* data = nullptr);
 
@@ -899,11 +1476,23 @@ namespace vgfw
 
             static GLuint createComputeProgram(const std::string& compSource);
 
+            // Submit without waiting for the compiler, see ProgramHandle
+            static ProgramHandle
+            createGraphicsProgramAsync(const std::string&                vertSource,
+                                       const std::string&                fragSource,
+                                       const std::optional<std::string>& geomSource = std::nullopt);
+            static ProgramHandle createComputeProgramAsync(const std::string& compSource);
+
+            // Linked programs are written to (and loaded from) this directory, empty path disables the cache
+            static void setProgramCacheDirectory(const std::filesystem::path&);
+
             static Texture
             createTexture2D(Extent2D extent, PixelFormat, uint32_t numMipLevels = 1u, uint32_t numLayers = 0u);
             static Texture createTexture3D(Extent2D, uint32_t depth, PixelFormat);
             static Texture
             createCubemap(uint32_t size, PixelFormat, uint32_t numMipLevels = 1u, uint32_t numLayers = 0u);
+            // Shares the storage of the given texture, the formats must be of the same view class
+            static Texture createTextureView(const Texture&, PixelFormat);
 
             RenderContext& generateMipmaps(Texture&);
 
@@ -913,6 +1502,8 @@ namespace vgfw
             RenderContext& clear(Texture&);
             // Upload Texture2D
             RenderContext& upload(Texture&, GLint mipLevel, glm::uvec2 dimensions, const ImageData&);
+            // Upload block compressed Texture2D
+            RenderContext& upload(Texture&, GLint mipLevel, glm::uvec2 dimensions, const CompressedImageData&);
             // Upload Cubemap face
             RenderContext& upload(Texture&, GLint mipLevel, GLint face, glm::uvec2 dimensions, const ImageData&);
             RenderContext&
@@ -926,8 +1517,12 @@ namespace vgfw
             RenderContext& destroy(Buffer&);
             RenderContext& destroy(Texture&);
             RenderContext& destroy(GraphicsPipeline&);
+            // Also while compiling or after a failed build, other copies of the handle then act like a failed build
+            RenderContext& destroy(ProgramHandle&);
+            RenderContext& destroyProgram(GLuint program); // For compute programs, pipelines own theirs
 
             RenderContext& dispatch(GLuint computeProgram, const glm::uvec3& numGroups);
+            RenderContext& memoryBarrier(GLbitfield barriers);
 
             GLuint         beginRendering(const RenderingInfo& info);
             RenderContext& beginRendering(const Rect2D&            area,
@@ -936,20 +1531,35 @@ namespace vgfw
                                           std::optional<int>       clearStencil = {});
             RenderContext& endRendering(GLuint frameBufferID);
 
-            RenderContext& setUniform1f(const std::string& name, float);
-            RenderContext& setUniform1i(const std::string& name, int32_t);
-            RenderContext& setUniform1ui(const std::string& name, uint32_t);
+            static UniformHandle getUniform(GLuint program, std::string_view name);
+
+            RenderContext& setUniform1f(std::string_view name, float);
+            RenderContext& setUniform1i(std::string_view name, int32_t);
+            RenderContext& setUniform1ui(std::string_view name, uint32_t);
+
+            RenderContext& setUniformVec3(std::string_view name, const glm::vec3&);
+            RenderContext& setUniformVec4(std::string_view name, const glm::vec4&);
+
+            RenderContext& setUniformMat3(std::string_view name, const glm::mat3&);
+            RenderContext& setUniformMat4(std::string_view name, const glm::mat4&);
 
-            RenderContext& setUniformVec3(const std::string& name, const glm::vec3&);
-            RenderContext& setUniformVec4(const std::string& name, const glm::vec4&);
+            // Handles come from GraphicsPipeline::getUniform (or getUniform for compute programs)
+            RenderContext& setUniform1f(UniformHandle, float);
+            RenderContext& setUniform1i(UniformHandle, int32_t);
+            RenderContext& setUniform1ui(UniformHandle, uint32_t);
 
-            RenderContext& setUniformMat3(const std::string& name, const glm::mat3&);
-            RenderContext& setUniformMat4(const std::string& name, const glm::mat4&);
+            RenderContext& setUniformVec3(UniformHandle, const glm::vec3&);
+            RenderContext& setUniformVec4(UniformHandle, const glm::vec4&);
+
+            RenderContext& setUniformMat3(UniformHandle, const glm::mat3&);
+            RenderContext& setUniformMat4(UniformHandle, const glm::mat4&);
 
             RenderContext& bindGraphicsPipeline(const GraphicsPipeline& gp);
             RenderContext& bindImage(GLuint unit, const Texture&, GLint mipLevel, GLenum access);
             RenderContext& bindTexture(GLuint unit, const Texture&, std::optional<GLuint> samplerId = {});
             RenderContext& bindUniformBuffer(GLuint index, const UniformBuffer&);
+            RenderContext& bindUniformBuffer(GLuint index, const UniformBuffer&, GLintptr offset, GLsizeiptr size);
+            RenderContext& bindUniformBuffer(GLuint index, const UniformAllocation&);
             RenderContext& bindStorageBuffer(GLuint index, const StorageBuffer&);
             RenderContext& bindMeshPrimitiveMaterialBuffer(GLuint index, const resource::MeshPrimitive& meshPrimitive);
             RenderContext& bindMeshPrimitiveTextures(GLuint                         startUnit,
@@ -962,8 +1572,50 @@ namespace vgfw
                                 OptionalReference<const IndexBuffer>  indexBuffer,
                                 uint32_t                              numIndices,
                                 uint32_t                              numVertices,
-                                uint32_t                              numInstances = 1);
-            RenderContext& drawMeshPrimitive(const resource::MeshPrimitive& meshPrimitive);
+                                uint32_t                              numInstances = 1,
+                                uint32_t                              firstIndex   = 0,
+                                int32_t                               baseVertex   = 0);
+            // lod is clamped to the LODs the primitive has, see resource::selectLod. Instances without instance
+            // attributes only differ in gl_InstanceID (e.g. the layer of layered rendering)
+            RenderContext& drawMeshPrimitive(const resource::MeshPrimitive& meshPrimitive,
+                                             uint32_t                       lod          = 0,
+                                             uint32_t                       numInstances = 1);
+            // The bound pipeline's VAO must contain instance attributes (divisor > 0)
+            RenderContext& drawMeshPrimitiveInstanced(const resource::MeshPrimitive& meshPrimitive,
+                                                      const VertexBuffer&            instanceBuffer,
+                                                      uint32_t                       numInstances);
+
+            // Commands are DrawElementsIndirectCommand (or glDrawArraysIndirect layout without an index buffer)
+            RenderContext& drawIndirect(OptionalReference<const VertexBuffer> vertexBuffer,
+                                        OptionalReference<const IndexBuffer>  indexBuffer,
+                                        const Buffer&                         commandBuffer,
+                                        GLintptr                              offset = 0);
+            RenderContext& multiDrawElementsIndirect(const VertexBuffer&,
+                                                     const IndexBuffer&,
+                                                     const Buffer& commandBuffer,
+                                                     uint32_t      numDraws,
+                                                     GLintptr      offset = 0);
+            // The number of draws is read from countBuffer (a GLuint at countOffset), at most maxDraws are issued
+            RenderContext& multiDrawElementsIndirectCount(const VertexBuffer&,
+                                                          const IndexBuffer&,
+                                                          const Buffer& commandBuffer,
+                                                          const Buffer& countBuffer,
+                                                          uint32_t      maxDraws,
+                                                          GLintptr      offset      = 0,
+                                                          GLintptr      countOffset = 0);
+
+            // gl_DrawID/gl_BaseInstance (GL 4.6 or ARB_shader_draw_parameters), required by DrawCommandBuilder shaders
+            static bool hasShaderDrawParameters();
+            // glMultiDrawElementsIndirectCount (GL 4.6 or ARB_indirect_parameters)
+            static bool hasIndirectCount();
+            // gl_Layer written by vertex shaders (ARB_shader_viewport_layer_array or AMD_vertex_shader_layer), for
+            // layered rendering without a geometry shader
+            static bool hasVertexShaderLayer();
+
+            // GL_ARB_bindless_texture, textures loaded by io::loadTexture are made resident when available
+            static bool hasBindlessTextures();
+            // Returns the bindless handle of the texture (sampling state is frozen from here on), made resident once
+            GLuint64 makeTextureResident(const Texture&);
 
             struct ResourceDeleter
             {
@@ -977,6 +1629,8 @@ namespace vgfw
             };
 
         private:
+            friend class ProgramHandle;
+
             static GLuint createVertexArray(const VertexAttributes&);
 
             static Texture createImmutableTexture(Extent2D,
@@ -986,16 +1640,37 @@ namespace vgfw
                                                   uint32_t numMipLevels,
                                                   uint32_t numLayers);
 
-            static void createFaceView(Texture& cubeMap, GLuint mipLevel, GLuint layer, GLuint face);
             static void attachTexture(GLuint framebuffer, GLenum attachment, const AttachmentInfo&);
 
-            static GLuint createShaderProgram(std::initializer_list<GLuint> shaders);
-            static GLuint createShaderObject(GLenum type, const std::string& shaderSource);
+            GLuint getFramebuffer(const RenderingInfo&);
+            void   releaseFramebuffers(GLuint texture);
+
+            void setDrawIndirectBuffer(const Buffer&);
+            void setParameterBuffer(const Buffer&);
+
+            using ShaderStageSource = std::pair<GLenum, std::string_view>;
+
+            static bool          hasParallelShaderCompile();
+            static ProgramHandle submitProgram(std::initializer_list<ShaderStageSource>);
+            static GLuint        finalizeProgram(ProgramHandle::State&);
+            static GLuint        createShaderObject(GLenum type, std::string_view shaderSource);
+
+            static std::size_t getProgramCacheKey(std::initializer_list<ShaderStageSource>);
+            static uint64_t    getProgramSourceHash(std::initializer_list<ShaderStageSource>);
+            static GLuint      loadProgramBinary(std::size_t key, uint64_t sourceHash);
+            static void        storeProgramBinary(std::size_t key, uint64_t sourceHash, GLuint program);
+
+            UniformHandle findUniform(std::string_view name) const;
+
+            bool trackStateChange(bool changed);
+            void forgetTexture(GLuint texture);
+            void forgetBuffer(GLuint buffer);
 
             void setShaderProgram(GLuint);
             void setVertexArray(GLuint);
-            void setVertexBuffer(const VertexBuffer&) const;
-            void setIndexBuffer(const IndexBuffer&) const;
+            void setVertexBuffer(const VertexBuffer&);
+            void setInstanceBuffer(const VertexBuffer&);
+            void setIndexBuffer(const IndexBuffer&);
 
             void setDepthTest(bool enabled, CompareOp);
             void setDepthWrite(bool enabled);
@@ -1012,8 +1687,85 @@ namespace vgfw
             bool             m_RenderingStarted = false;
             GraphicsPipeline m_CurrentPipeline;
 
+            inline static std::unordered_map<GLuint, UniformTable> s_UniformTables;
+            const UniformTable*                                    m_CurrentUniforms {nullptr};
+
+            inline static std::filesystem::path s_ProgramCacheDirectory;
+
+            // Shadow state of bindings that are not part of GraphicsPipeline
+            struct TextureBinding
+            {
+                GLuint texture {GL_NONE};
+                GLuint sampler {GL_NONE};
+            };
+            struct BufferBinding
+            {
+                GLuint     buffer {GL_NONE};
+                GLintptr   offset {0};
+                GLsizeiptr size {0}; // 0 = whole buffer (glBindBufferBase)
+            };
+            struct VertexArrayBinding
+            {
+                GLuint  vertexBuffer {GL_NONE};
+                GLsizei stride {0};
+                GLuint  instanceBuffer {GL_NONE};
+                GLsizei instanceStride {0};
+                GLuint  indexBuffer {GL_NONE};
+            };
+            static constexpr GLuint kVertexBinding {0};
+            static constexpr GLuint kInstanceBinding {1};
+            std::vector<TextureBinding>                     m_TextureUnits;
+            std::vector<BufferBinding>                      m_UniformBufferBindings;
+            std::vector<BufferBinding>                      m_StorageBufferBindings;
+            std::unordered_map<GLuint, VertexArrayBinding> m_VertexArrayBindings;
+            GLuint                                         m_DrawIndirectBuffer {GL_NONE};
+            GLuint                                         m_ParameterBuffer {GL_NONE};
+
+            std::unordered_map<GLuint, GLuint64> m_ResidentTextureHandles; // Key = texture id
+
+            StateChangeCounters m_StateChangeCounters;
+            FrameCounters       m_FrameCounters;
+            FrameProfiler       m_Profiler;
+
+            // Small enough that large textures bypass it, big enough for a frame worth of uploads
+            static constexpr GLsizeiptr kStagingRingSize {32 * 1024 * 1024};
+
+            StagingRing m_StagingRing;
+
+            static constexpr uint32_t   kNumFramesInFlight {3};
+            static constexpr GLsizeiptr kUniformRingFrameSize {1024 * 1024};
+
+            UniformRing m_UniformRing;
+
+            std::optional<GLintptr> stage(const void* data, GLsizeiptr size);
+
             GLuint                                  m_DummyVAO {GL_NONE};
             std::unordered_map<std::size_t, GLuint> m_VertexArrays;
+
+            struct FramebufferAttachment
+            {
+                GLenum   attachment {GL_NONE};
+                GLuint   texture {GL_NONE};
+                uint32_t mipLevel {0};
+                uint32_t layer {~0u}; // ~0u: every layer
+                uint32_t face {~0u};
+
+                bool operator==(const FramebufferAttachment&) const = default;
+            };
+            using FramebufferKey = std::vector<FramebufferAttachment>;
+
+            struct FramebufferKeyHash
+            {
+                std::size_t operator()(const FramebufferKey& key) const
+                {
+                    std::size_t hash {0};
+                    for (const auto& a : key)
+                        utils::hashCombine(hash, a.attachment, a.texture, a.mipLevel, a.layer, a.face);
+                    return hash;
+                }
+            };
+            // The key holds the attached texture ids, used for invalidation
+            std::unordered_map<FramebufferKey, GLuint, FramebufferKeyHash> m_Framebuffers;
         };
 
         // @return {data type, number of components, normalize}
@@ -1022,29 +1774,147 @@ namespace vgfw
         GLenum                               getIndexDataType(GLsizei stride);
         GLenum                               getPolygonOffsetCap(PolygonMode polygonMode);
 
-        namespace framegraph
+        // Layout mandated by glMultiDrawElementsIndirect
+        struct DrawElementsIndirectCommand
         {
-            class FrameGraphBuffer
+            uint32_t count {0};
+            uint32_t instanceCount {1};
+            uint32_t firstIndex {0};
+            int32_t  baseVertex {0};
+            uint32_t baseInstance {0};
+        };
+
+        // Suballocates vertices and indices from a few large buffers (one group per VertexFormat) and materials from
+        // a shared uniform buffer, so that primitives only keep offsets. Space is released with the arena.
+        class GeometryArena
+        {
+        public:
+            struct Allocation
             {
-            public:
-                struct Desc
-                {
-                    GLsizeiptr size;
-                };
+                std::shared_ptr<VertexBuffer> vertexBuffer {nullptr};
+                std::shared_ptr<IndexBuffer>  indexBuffer {nullptr};
+                int32_t                       baseVertex {0};
+                uint32_t                      firstIndex {0};
+            };
+            struct UniformAllocation
+            {
+                std::shared_ptr<Buffer> buffer {nullptr};
+                GLintptr                offset {0};
+            };
 
-                // NOLINTBEGIN
-                void create(const Desc&, void* allocator);
-                void destroy(const Desc&, void* allocator) const;
-                // NOLINTEND
+            explicit GeometryArena(RenderContext&,
+                                   GLsizeiptr vertexChunkSize = kDefaultVertexChunkSize,
+                                   GLsizeiptr indexChunkSize  = kDefaultIndexChunkSize);
+            GeometryArena(const GeometryArena&) = delete;
+            GeometryArena(GeometryArena&&)      = delete;
+            ~GeometryArena()                    = default;
 
-                Buffer* handle = nullptr;
-            };
+            GeometryArena& operator=(const GeometryArena&) = delete;
+            GeometryArena& operator=(GeometryArena&&)      = delete;
 
-            class FrameGraphTexture
+            // Indices are narrowed to indexType on upload, each index type gets chunks of its own
+            Allocation add(const VertexFormat&,
+                           const void*               vertices,
+                           uint32_t                  numVertices,
+                           std::span<const uint32_t> indices,
+                           IndexType                 indexType = IndexType::eUInt32);
+            UniformAllocation addUniform(const void* data, GLsizeiptr size);
+
+            static constexpr GLsizeiptr kDefaultVertexChunkSize {32 * 1024 * 1024};
+            static constexpr GLsizeiptr kDefaultIndexChunkSize {16 * 1024 * 1024};
+            static constexpr GLsizeiptr kUniformChunkSize {64 * 1024};
+
+        private:
+            struct Chunk
             {
-            public:
-                struct Desc
-                {
+                std::shared_ptr<VertexBuffer> vertexBuffer;
+                std::shared_ptr<IndexBuffer>  indexBuffer;
+                uint32_t                      numVertices {0};
+                uint32_t                      numIndices {0};
+            };
+            struct UniformChunk
+            {
+                std::shared_ptr<Buffer> buffer;
+                GLsizeiptr              size {0};
+            };
+
+            RenderContext& m_RenderContext;
+            GLsizeiptr     m_VertexChunkSize;
+            GLsizeiptr     m_IndexChunkSize;
+            GLsizeiptr     m_UniformAlignment {256};
+
+            std::unordered_map<std::size_t, std::vector<Chunk>> m_Chunks; // Key = VertexFormat and IndexType hash
+            std::vector<UniformChunk>                            m_UniformChunks;
+        };
+
+        // Collects mesh primitive draws, orders them by a packed 64-bit key and submits them with few state changes.
+        // Opaque items group by pipeline, then material, then go front-to-back; transparent ones go back-to-front.
+        class RenderQueue
+        {
+        public:
+            struct Item
+            {
+                uint64_t                       key {0};
+                const GraphicsPipeline*        pipeline {nullptr};
+                const resource::MeshPrimitive* primitive {nullptr};
+                uint32_t                       lod {0};
+            };
+
+            // Drops the items, pipeline and material ids are only stable within one fill
+            RenderQueue& clear();
+            RenderQueue& reserve(uint32_t numItems);
+
+            // depth = view distance (>= 0)
+            RenderQueue& push(const GraphicsPipeline&,
+                              const resource::MeshPrimitive&,
+                              float    depth,
+                              bool     transparent = false,
+                              uint32_t lod         = 0);
+
+            // Radix sort on the keys, stable for equal keys
+            RenderQueue& sort();
+
+            const std::vector<Item>& getItems() const;
+
+            // Binds the pipeline (when it changes), material buffer and textures of every item and draws it.
+            // Other bindings (e.g. camera uniforms) are left to the caller.
+            void submit(RenderContext&, GLuint materialBufferIndex, GLuint firstTextureUnit) const;
+
+        private:
+            uint32_t getPipelineId(const GraphicsPipeline&);
+            uint32_t getMaterialId(const resource::MeshPrimitive&);
+
+        private:
+            std::vector<Item> m_Items;
+            std::vector<Item> m_SortBuffer;
+
+            std::unordered_map<const GraphicsPipeline*, uint32_t> m_PipelineIds;
+            std::unordered_map<std::size_t, uint32_t>             m_MaterialIds; // Key = texture set
+        };
+
+        namespace framegraph
+        {
+            class FrameGraphBuffer
+            {
+            public:
+                struct Desc
+                {
+                    GLsizeiptr size;
+                };
+
+                // NOLINTBEGIN
+                void create(const Desc&, void* allocator);
+                void destroy(const Desc&, void* allocator) const;
+                // NOLINTEND
+
+                Buffer* handle = nullptr;
+            };
+
+            class FrameGraphTexture
+            {
+            public:
+                struct Desc
+                {
                     Extent2D    extent;
                     uint32_t    depth {0};
                     uint32_t    numMipLevels {1};
@@ -1067,8 +1937,17 @@ namespace vgfw
             class TransientResources
             {
             public:
+                struct Policy
+                {
+                    float    maxIdleTime {1.0f}; // In seconds
+                    uint32_t minIdleFrames {3};  // Also required to expire, so a hitch does not flush the pools
+                    // 0 = unlimited, otherwise idle resources are evicted least recently used first when over it
+                    GLsizeiptr maxPooledBytes {0};
+                };
+
                 TransientResources() = delete;
                 explicit TransientResources(RenderContext&);
+                TransientResources(RenderContext&, const Policy&);
                 TransientResources(const TransientResources&)     = delete;
                 TransientResources(TransientResources&&) noexcept = delete;
                 ~TransientResources();
@@ -1078,29 +1957,78 @@ namespace vgfw
 
                 void update(float dt);
 
+                void          setPolicy(const Policy&);
+                const Policy& getPolicy() const;
+
                 Texture* acquireTexture(const FrameGraphTexture::Desc&);
                 void     releaseTexture(const FrameGraphTexture::Desc&, Texture*);
 
                 Buffer* acquireBuffer(const FrameGraphBuffer::Desc&);
                 void    releaseBuffer(const FrameGraphBuffer::Desc&, Buffer*);
 
+                struct Stats
+                {
+                    GLsizeiptr textureBytes {0}; // Texture storage held by the pools, views take none
+                    GLsizeiptr bufferBytes {0};
+                    GLsizeiptr peakBytes {0}; // Most transient memory in use at once, during the last frame
+
+                    uint32_t numTextures {0};
+                    uint32_t numTextureViews {0};
+                    uint32_t numBuffers {0};
+
+                    // Totals since construction
+                    uint64_t numHits {0};      // Acquisitions served from a pool
+                    uint64_t numMisses {0};    // Acquisitions that had to allocate
+                    uint64_t numCreations {0}; // Textures, texture views and buffers created
+                    uint64_t numEvictions {0}; // Released over the budget, rather than for being idle
+                };
+                const Stats& getStats() const;
+
+            private:
+                // Textures with the same size and view class alias one storage, through views for other formats
+                struct TextureStorage
+                {
+                    explicit operator bool() const;
+
+                    Texture     texture;
+                    std::size_t descHash {0};
+                    GLsizeiptr  size {0};
+
+                    std::vector<std::pair<std::size_t, std::unique_ptr<Texture>>> views; // Keyed by desc hash
+                };
+                Texture* getTextureView(TextureStorage&, const FrameGraphTexture::Desc&);
+                void     destroy(TextureStorage&);
+                void     destroy(Buffer&);
+
+                void trackUsage(GLsizeiptr delta);
+                void evictOverBudget();
+
             private:
                 RenderContext& m_RenderContext;
+                Policy         m_Policy;
 
-                std::vector<std::unique_ptr<Texture>> m_Textures;
-                std::vector<std::unique_ptr<Buffer>>  m_Buffers;
+                std::vector<std::unique_ptr<TextureStorage>> m_Textures;
+                std::vector<std::unique_ptr<Buffer>>         m_Buffers;
 
                 template<typename T>
                 struct ResourceEntry
                 {
-                    T     resource;
-                    float life;
+                    T        resource;
+                    float    idleTime {0.0f};
+                    uint32_t idleFrames {0};
                 };
                 template<typename T>
                 using ResourcePool = std::vector<ResourceEntry<T>>;
 
-                std::unordered_map<std::size_t, ResourcePool<Texture*>> m_TexturePools;
-                std::unordered_map<std::size_t, ResourcePool<Buffer*>>  m_BufferPools;
+                utils::FlatHashMap<ResourcePool<TextureStorage*>> m_TexturePools; // Keyed by alias key
+                utils::FlatHashMap<ResourcePool<Buffer*>>         m_BufferPools;
+
+                // Acquired texture (a storage or one of its views) -> storage
+                std::unordered_map<const Texture*, TextureStorage*> m_AcquiredTextures;
+
+                Stats      m_Stats;
+                GLsizeiptr m_BytesInUse {0};
+                GLsizeiptr m_FramePeakBytes {0};
             };
 
             FrameGraphResource importTexture(FrameGraph& fg, const std::string& name, Texture* texture);
@@ -1135,6 +2063,9 @@ namespace vgfw
             void beginFrame();
             void endFrame();
             void shutdown();
+
+            // Last read back frame of the profiler: scope times, counters and a GPU time graph
+            void drawProfilerOverlay(const FrameProfiler&);
         } // namespace imgui
 
         static bool                           g_RendererInit = false;
@@ -1145,6 +2076,7 @@ namespace vgfw
         {
             std::shared_ptr<window::Window> window {nullptr};
             bool                            enableImGuiDocking {false};
+            std::filesystem::path           programCacheDirectory {}; // Empty = no program binary cache
         };
 
         void init(const RendererInitInfo& initInfo);
@@ -1172,6 +2104,7 @@ namespace vgfw
 
         using PrimitiveMaterial = Material;
 
+        // Separate attribute arrays, interleaved into MeshPrimitive::vertices by prepare() and freed there
         struct MeshRecord
         {
             std::vector<glm::vec3> positions;
@@ -1180,48 +2113,143 @@ namespace vgfw
             std::vector<glm::vec4> tangents;
         };
 
+        // Load time reordering of MeshPrimitive geometry (triangle lists), every step is optional
+        struct MeshOptimization
+        {
+            bool enabled {false};
+
+            bool weldVertices {true};        // Merges bitwise identical vertices, OBJ emits one per face corner
+            bool optimizeVertexCache {true}; // Triangle order for the post-transform cache
+            // Triangle clusters facing outwards draw first, at the cost of up to this much cache efficiency
+            // (1.05 = 5%, 0 = off). Needs the vertex cache order.
+            float overdrawThreshold {1.05f};
+            bool  optimizeVertexFetch {true}; // Vertices in the order of first use, unreferenced ones are dropped
+            bool  compactIndices {true};      // 16-bit indices when the vertex count allows
+        };
+
+        // Smaller vertex attributes, applied after MeshOptimization. Normals and tangents become 10-10-10-2 snorm and
+        // texture coordinates half floats (UVs far outside [0, 1] lose texel precision).
+        struct MeshQuantization
+        {
+            bool enabled {false};
+
+            bool normals {true}; // And tangents
+            bool texCoords {true};
+            // 16-bit snorm within the AABB, scaled uniformly so that mat3(modelMatrix) still transforms normals. The
+            // dequantization is folded into modelMatrix (and the AABB is in the quantized space), so shaders have to
+            // apply modelMatrix.
+            bool positions {false};
+        };
+
+        // Discrete LODs, made by clustering vertices on a grid that gets coarser with every LOD. The LOD index
+        // ranges follow the full mesh in the same index buffer and reuse its vertices.
+        struct MeshLodGeneration
+        {
+            static constexpr uint32_t kMaxLods = 8; // maxLods is clamped to this
+
+            bool enabled {false};
+
+            uint32_t maxLods {4};       // Including the full mesh
+            float    reduction {0.5f};  // Triangles kept from one LOD to the next
+            uint32_t minTriangles {32}; // No LOD below this
+        };
+
+        // A range of MeshPrimitive::indices (relative to MeshPrimitive::firstIndex on the GPU)
+        struct MeshLod
+        {
+            uint32_t firstIndex {0};
+            uint32_t indexCount {0};
+            // Distance vertices moved by at most, relative to the AABB diagonal (0 for the full mesh)
+            float error {0.0f};
+        };
+
+        // CPU copies a MeshPrimitive keeps once it is uploaded, by default only the counts and bounds stay
+        struct MeshDataRetention
+        {
+            bool vertices {false}; // Interleaved, in the vertexFormat layout
+            bool indices {false};
+        };
+
         struct MeshPrimitive
         {
             std::string name;
 
-            uint32_t indexCount {0};
+            uint32_t indexCount {0}; // Of the full mesh (LOD 0)
             uint32_t vertexCount {0};
+            // Of the GPU copy, indices stays 32-bit
+            renderer::IndexType indexType {renderer::IndexType::eUInt32};
 
             MeshRecord record {};
 
-            std::vector<uint32_t> indices;
+            std::vector<uint32_t> indices; // Every LOD
             std::vector<float>    vertices;
 
+            // Empty without LOD generation (only the full mesh)
+            std::vector<MeshLod> lods;
+
             int materialIndex {-1};
 
             std::shared_ptr<renderer::VertexFormat> vertexFormat {nullptr};
 
+            // Possibly shared with other primitives, see renderer::GeometryArena
             std::shared_ptr<renderer::IndexBuffer>  indexBuffer {nullptr};
             std::shared_ptr<renderer::VertexBuffer> vertexBuffer {nullptr};
+            uint32_t                                firstIndex {0};
+            int32_t                                 baseVertex {0};
 
             PrimitiveMaterial                 material {};
             std::shared_ptr<renderer::Buffer> materialBuffer {nullptr};
+            GLintptr                          materialOffset {0};
             std::vector<uint32_t>             textureIndices;
 
             math::AABB aabb {};
             glm::mat4  modelMatrix {1.0};
+            // Of quantized positions back to the model space, already part of modelMatrix
+            glm::mat4 dequantization {1.0};
 
             int              indexInOwnerModel {-1};
             resource::Model* ownerModel {nullptr};
 
+            // lod is clamped to the last one
+            MeshLod  getLod(uint32_t lod) const;
+            uint32_t getNumLods() const;
+            // Of every LOD
+            uint32_t getNumStoredIndices() const;
+
             void build(renderer::VertexFormat::Builder& vertexFormatBuilder, renderer::RenderContext& rc);
 
+            // The two halves of build(), prepare() does not touch GL and may run on any thread
+            void prepare(renderer::VertexFormat::Builder& vertexFormatBuilder);
+            void upload(renderer::RenderContext& rc);
+            // Geometry kept elsewhere (e.g. a mapped baked model) instead of vertices and indices, in vertexFormat
+            // layout
+            void upload(renderer::RenderContext& rc, const void* vertexData, std::span<const uint32_t> indexData);
+
         private:
+            void interleaveRecord();
+            void releaseCpuData();
+
             friend class renderer::RenderContext;
-            void draw(renderer::RenderContext& rc) const;
+            void draw(renderer::RenderContext& rc, uint32_t numInstances = 1, uint32_t lod = 0) const;
         };
 
         struct Model
         {
             std::vector<MeshPrimitive> meshPrimitives;
 
-            std::vector<vgfw::renderer::Texture*> textures;
-            std::vector<Material>                 materials;
+            // Primitives are packed into it when set before loading, otherwise each gets its own buffers
+            std::shared_ptr<renderer::GeometryArena> geometryArena {nullptr};
+            // Set before loading as well, to read the geometry back on the CPU
+            MeshDataRetention retainMeshData {};
+            // And to reorder the geometry of each primitive once it is prepared, see optimizeMesh
+            MeshOptimization meshOptimization {};
+            // And to shrink its vertex attributes, see quantizeMesh
+            MeshQuantization meshQuantization {};
+            // And to simplify it into LODs, see generateLods
+            MeshLodGeneration meshLods {};
+
+            std::vector<std::shared_ptr<renderer::Texture>> textures; // See io::TextureHandle
+            std::vector<Material>                           materials;
 
         private:
             friend class renderer::RenderContext;
@@ -1230,23 +2258,289 @@ namespace vgfw
                                            renderer::RenderContext& rc,
                                            std::optional<GLuint>    samplerId = {}) const;
         };
+
+        // Welds, reorders for the vertex cache, overdraw and vertex fetch (Forsyth, then Sander et al.) and picks the
+        // index type. Works on the CPU data (prepared, not uploaded yet), called by prepare() when the owner model
+        // asks for it.
+        void optimizeMesh(MeshPrimitive&, const MeshOptimization&);
+        // Appends the simplified LODs to the prepared indices (a LOD that does not reduce the triangles enough ends
+        // the chain), called by prepare() after optimizeMesh
+        void generateLods(MeshPrimitive&, const MeshLodGeneration&);
+        // Rewrites the prepared vertices (and the vertex format) with the quantized attribute types, called by
+        // prepare() after generateLods
+        void quantizeMesh(MeshPrimitive&, const MeshQuantization&);
+
+        // Of the screen size of a MeshPrimitive's LOD errors
+        struct LodSelection
+        {
+            glm::vec3 cameraPosition {0.0f};
+            // Pixels per world unit at a distance of 1, i.e. viewport height * projection[1][1] / 2
+            float projectionScale {1.0f};
+            float threshold {1.0f}; // Pixels a LOD may be off by
+            float bias {0.0f};      // Each +1 doubles the threshold (coarser LODs), each -1 halves it
+        };
+
+        // The coarsest LOD whose error, scaled by the projected size of the world AABB, stays within the threshold
+        uint32_t selectLod(const MeshPrimitive&, const LodSelection&);
+
+        // Per-draw data, read in shaders as a std430 array indexed by gl_BaseInstance (the command index, which stays
+        // valid when commands are compacted)
+        struct DrawData
+        {
+            glm::mat4         modelMatrix {1.0};
+            PrimitiveMaterial material {};
+            // Resident handles in PrimitiveMaterial field order (0 = none), only filled in bindless mode
+            std::array<GLuint64, 5> textureHandles {};
+        };
+        static_assert(offsetof(DrawData, textureHandles) == 88 && sizeof(DrawData) == 128,
+                      "DrawData must match its std430 layout");
+
+        // World space bounds of a draw command, for culling on the GPU (std430)
+        struct DrawBounds
+        {
+            glm::vec3 center {0.0f};
+            uint32_t  batchIndex {0};
+            glm::vec3 extent {0.0f}; // Half size
+            uint32_t  firstCommand {0}; // Of the batch
+        };
+        static_assert(sizeof(DrawBounds) == 32, "DrawBounds must match its std430 layout");
+
+        // Consecutive commands sharing geometry buffers and textures, drawn with one glMultiDrawElementsIndirect
+        struct DrawBatch
+        {
+            const renderer::VertexFormat* vertexFormat {nullptr};
+            const renderer::VertexBuffer* vertexBuffer {nullptr};
+            const renderer::IndexBuffer*  indexBuffer {nullptr};
+            const MeshPrimitive*          primitive {nullptr}; // source of the batch textures, unless bindless
+
+            uint32_t index {0}; // In DrawCommandBuilder::getBatches()
+            uint32_t firstCommand {0};
+            uint32_t numCommands {0};
+        };
+
+        // Records the draw commands and per-draw data of a Model into GPU buffers. Primitives sharing a
+        // renderer::GeometryArena chunk and the same textures end up in the same batch. With bindless textures the
+        // handles go to DrawData instead, so batches only split on geometry buffers and need no texture binds.
+        class DrawCommandBuilder
+        {
+        public:
+            explicit DrawCommandBuilder(renderer::RenderContext&);
+            DrawCommandBuilder(const DrawCommandBuilder&) = delete;
+            DrawCommandBuilder(DrawCommandBuilder&&)      = delete;
+            ~DrawCommandBuilder();
+
+            DrawCommandBuilder& operator=(const DrawCommandBuilder&) = delete;
+            DrawCommandBuilder& operator=(DrawCommandBuilder&&)      = delete;
+
+            DrawCommandBuilder& build(const Model&);
+            // Points every command at the LOD of its primitive (see selectLod), uploads only when one changed
+            DrawCommandBuilder& selectLods(const LodSelection&);
+
+            bool isBindless() const;
+
+            const std::vector<DrawBatch>&  getBatches() const;
+            uint32_t                       getNumCommands() const;
+            const renderer::Buffer&        getCommandBuffer() const;
+            const renderer::StorageBuffer& getDrawDataBuffer() const;
+            const renderer::StorageBuffer& getBoundsBuffer() const;
+            // World space bounds of the primitives, in command order (for culling on the CPU)
+            const culling::BoundsList& getBounds() const;
+
+            // Copies the commands (at their selected LODs) with one instance per bit of viewMasks[i] (command order,
+            // see culling::cullViews), for shaders that pick the view (layer) of an instance
+            void writeLayeredCommands(std::span<const uint32_t>                        viewMasks,
+                                      std::span<renderer::DrawElementsIndirectCommand> commands) const;
+
+            // Binds the command buffer and draws one batch
+            void draw(const DrawBatch&) const;
+            // Draws a batch from a copy of the command buffer (same layout), e.g. one from writeLayeredCommands
+            void draw(const DrawBatch&, const renderer::Buffer& commandBuffer) const;
+            // Draws a batch from a compacted copy of the command buffer (same layout, each batch keeps its range),
+            // with the number of commands of each batch in countBuffer indexed by DrawBatch::index
+            void
+            draw(const DrawBatch&, const renderer::Buffer& commandBuffer, const renderer::Buffer& countBuffer) const;
+
+        private:
+            renderer::RenderContext& m_RenderContext;
+
+            bool                    m_Bindless {false};
+            std::vector<DrawBatch>  m_Batches;
+
+            // In command order
+            std::vector<const MeshPrimitive*>                   m_Primitives;
+            std::vector<renderer::DrawElementsIndirectCommand> m_Commands;
+            culling::BoundsList                                 m_Bounds;
+
+            uint32_t                m_NumCommands {0};
+            renderer::Buffer        m_CommandBuffer;
+            renderer::StorageBuffer m_DrawDataBuffer;
+            renderer::StorageBuffer m_BoundsBuffer;
+        };
     } // namespace resource
 
     namespace io
     {
-        static std::unordered_map<size_t, renderer::Texture*> g_TextureCache;
+        // Shared by everything that uses the texture, it is destroyed once none is left (see TextureManager)
+        using TextureHandle = std::shared_ptr<renderer::Texture>;
 
-        renderer::Texture*
-        loadTexture(const std::filesystem::path& texturePath, renderer::RenderContext& rc, bool flip = true);
+        // Loaded textures by path, one instance for the whole program (getTextureManager()). Lookups may run on
+        // any thread, GL work only runs on the GL thread: add() and update().
+        class TextureManager
+        {
+        public:
+            struct Policy
+            {
+                // Textures no handle refers to anymore stay cached up to this (least recently used go first)
+                GLsizeiptr maxUnusedBytes {0};
+                // Unused textures are evicted beyond maxUnusedBytes to stay below this, streaming stops at it
+                // (0 = no limit)
+                GLsizeiptr budget {0};
+
+                // Block compressed textures (DDS/KTX2) start with the mips up to this size and stream in the rest
+                // when they are bound (0 = load whole textures). Not with bindless textures, their handles would
+                // keep the first storage alive.
+                uint32_t streamingBaseSize {0};
+            };
+
+            struct Stats
+            {
+                GLsizeiptr residentBytes {0};
+                GLsizeiptr unusedBytes {0};
+                uint32_t   numTextures {0};
+                uint32_t   numUnused {0};
+                uint32_t   numStreaming {0}; // Not at full resolution yet
+
+                uint64_t numEvictions {0};
+                uint64_t numStreamedIn {0};
+            };
+
+            TextureManager()                      = default;
+            TextureManager(const TextureManager&) = delete;
+            TextureManager(TextureManager&&)      = delete;
+            ~TextureManager()                     = default;
+
+            TextureManager& operator=(const TextureManager&) = delete;
+            TextureManager& operator=(TextureManager&&)      = delete;
+
+            void   setPolicy(const Policy&);
+            Policy getPolicy() const;
+
+            // nullptr when the texture is not loaded
+            TextureHandle find(const std::filesystem::path& texturePath) const;
+            // Takes the texture over, or destroys it and returns the cached one when another load was first.
+            // numStreamedMips > 0 marks a texture streamed from texturePath that lacks that many of its largest mips.
+            TextureHandle add(const std::filesystem::path& texturePath,
+                              renderer::Texture&&          texture,
+                              renderer::RenderContext&     rc,
+                              uint32_t                     numStreamedMips = 0);
+
+            // Asks for the missing mips of a streamed texture, no-op for any other
+            void request(const renderer::Texture&);
+
+            // Once per frame on the GL thread: swaps in streamed textures and evicts unused ones
+            void update(renderer::RenderContext&);
+            // Destroys every texture, handles that are still around keep empty ones
+            void clear(renderer::RenderContext&);
 
-        void releaseTexture(const std::filesystem::path& texturePath,
-                            renderer::Texture&           texture,
-                            renderer::RenderContext&     rc);
+            Stats getStats() const;
+
+        private:
+            struct Entry
+            {
+                std::filesystem::path path;
+                TextureHandle         texture;
+                GLsizeiptr            size {0};
+                uint64_t              unusedSince {0}; // Frame, 0 while handles are out there
+
+                uint32_t numStreamedMips {0};
+                bool     requested {false};
+                bool     streaming {false}; // Read in flight
+            };
+
+            void streamIn(std::size_t key, Entry&);
+            void evict(renderer::RenderContext&);
+
+        private:
+            mutable std::shared_mutex                                 m_Mutex;
+            utils::FlatHashMap<Entry>                                 m_Entries; // By getTextureKey()
+            std::unordered_map<const renderer::Texture*, std::size_t> m_StreamedKeys;
+            // Bindings skip the lock while it is 0
+            std::atomic<uint32_t> m_NumStreamed {0};
+
+            Policy   m_Policy {};
+            uint64_t m_FrameIndex {1};
+            Stats    m_Stats {};
+
+            struct StreamedImage;
+            std::mutex                                  m_StreamMutex;
+            std::vector<std::shared_ptr<StreamedImage>> m_StreamedImages;
+
+            utils::ThreadPool m_Pool {1}; // Last, so that the reader is joined before anything else goes away
+        };
+
+        TextureManager& getTextureManager();
+
+        TextureHandle
+        loadTexture(const std::filesystem::path& texturePath, renderer::RenderContext& rc, bool flip = true);
 
         bool loadModel(const std::filesystem::path& modelPath,
                        resource::Model&             model,
                        renderer::RenderContext&     rc,
                        const glm::vec3&             scale = glm::vec3(1.0f));
+
+        // Loaded models are baked to (and mapped back from) this directory, empty path disables the cache. Baked
+        // models hold interleaved geometry, materials and texture references, and go stale with their source file.
+        void setModelCacheDirectory(const std::filesystem::path&);
+
+        struct BakedModel;
+
+        // Loads models without blocking the GL thread: file reads, image decoding and vertex interleaving run
+        // on a worker pool, update() performs the GL uploads on the thread that owns the context.
+        class ModelLoader
+        {
+        public:
+            explicit ModelLoader(uint32_t numThreads = std::max(2u, std::thread::hardware_concurrency()) - 1);
+            ModelLoader(const ModelLoader&) = delete;
+            ModelLoader(ModelLoader&&)      = delete;
+            ~ModelLoader()                  = default;
+
+            ModelLoader& operator=(const ModelLoader&) = delete;
+            ModelLoader& operator=(ModelLoader&&)      = delete;
+
+            // The model must outlive the loader and must not be used before the future is ready
+            std::future<bool> loadModelAsync(const std::filesystem::path& modelPath,
+                                             resource::Model&             model,
+                                             const glm::vec3&             scale = glm::vec3(1.0f));
+
+            // Call once per frame, runs pending uploads until the budget is spent
+            void update(renderer::RenderContext& rc, time::Duration budget = time::Duration {0.004f});
+
+            // [0, 1] over all loads in flight
+            float getProgress() const;
+            bool  isBusy() const;
+
+        private:
+            struct Job;
+            using Upload = std::function<void(renderer::RenderContext&)>;
+
+            void submitTask(const std::shared_ptr<Job>&, std::function<void()> task);
+            void postUpload(const std::shared_ptr<Job>&, Upload upload);
+
+            void loadOBJAsync(const std::shared_ptr<Job>&);
+            void loadGLTFAsync(const std::shared_ptr<Job>&);
+            void loadBakedAsync(const std::shared_ptr<Job>&, std::shared_ptr<const BakedModel>);
+
+            // Index = slot in Model::textures, empty paths are skipped
+            void loadTexturesAsync(const std::shared_ptr<Job>&, const std::vector<std::filesystem::path>& texturePaths);
+            void onPrimitivePrepared(const std::shared_ptr<Job>&, uint32_t index);
+
+        private:
+            std::vector<std::shared_ptr<Job>>                   m_Jobs; // GL thread only
+            std::mutex                                          m_UploadMutex;
+            std::queue<std::pair<std::shared_ptr<Job>, Upload>> m_Uploads;
+
+            utils::ThreadPool m_Pool; // Last, so that workers are joined before anything else goes away
+        };
     } // namespace io
 
     bool init();
@@ -1262,7 +2556,7 @@ namespace std
         std::size_t operator()(const vgfw::renderer::VertexAttribute& attribute) const noexcept
         {
             std::size_t h {0};
-            vgfw::utils::hashCombine(h, attribute.vertType, attribute.offset);
+            vgfw::utils::hashCombine(h, attribute.vertType, attribute.offset, attribute.divisor);
             return h;
         }
     };
@@ -1313,90 +2607,549 @@ namespace vgfw
             (hashCombine(seed, rest), ...);
         }
 
-        std::string readFileAllText(const std::filesystem::path& filePath)
+        template<typename T>
+        T& FlatHashMap<T>::operator[](std::size_t key)
         {
-            std::ifstream fileStream(filePath);
+            if ((m_Size + 1) * 2 > m_Slots.size())
+                grow();
 
-            if (!fileStream.is_open())
+            auto& slot = m_Slots[findSlot(key)];
+            if (!slot.value)
             {
-                throw std::runtime_error("Could not open file: " + filePath.string());
+                slot.key = key;
+                slot.value.emplace();
+                ++m_Size;
             }
-
-            std::stringstream buffer;
-            buffer << fileStream.rdbuf();
-
-            return buffer.str();
+            return *slot.value;
         }
-    } // namespace utils
-
-    namespace math
-    {
-        glm::vec3 AABB::getExtent() const { return max - min; }
-        glm::vec3 AABB::getCenter() const { return (max + min) * 0.5f; }
-        float     AABB::getRadius() const { return glm::length(getExtent() * 0.5f); }
 
-        void AABB::merge(const AABB& other)
+        template<typename T>
+        T* FlatHashMap<T>::find(std::size_t key)
         {
-            min.x = std::min(min.x, other.min.x);
-            min.y = std::min(min.y, other.min.y);
-            min.z = std::min(min.z, other.min.z);
+            if (m_Slots.empty())
+                return nullptr;
 
-            max.x = std::max(max.x, other.max.x);
-            max.y = std::max(max.y, other.max.y);
-            max.z = std::max(max.z, other.max.z);
+            auto& slot = m_Slots[findSlot(key)];
+            return slot.value ? &*slot.value : nullptr;
         }
 
-        // https://dev.theomader.com/transform-bounding-boxes/
-        AABB AABB::transform(const glm::mat4& m) const
+        template<typename T>
+        const T* FlatHashMap<T>::find(std::size_t key) const
         {
-            const auto xa = m[0] * min.x;
-            const auto xb = m[0] * max.x;
+            return const_cast<FlatHashMap*>(this)->find(key);
+        }
 
-            const auto ya = m[1] * min.y;
-            const auto yb = m[1] * max.y;
+        template<typename T>
+        template<typename F>
+        void FlatHashMap<T>::forEach(F&& f)
+        {
+            for (auto& slot : m_Slots)
+            {
+                if (slot.value)
+                    f(slot.key, *slot.value);
+            }
+        }
 
-            const auto za = m[2] * min.z;
-            const auto zb = m[2] * max.z;
+        template<typename T>
+        template<typename Predicate>
+        void FlatHashMap<T>::eraseIf(Predicate&& predicate)
+        {
+            std::size_t i {0};
+            while (i < m_Slots.size())
+            {
+                // The erase shifts a later element into this slot, so look at it again
+                if (auto& slot = m_Slots[i]; slot.value && predicate(slot.key, std::as_const(*slot.value)))
+                    eraseSlot(i);
+                else
+                    ++i;
+            }
+        }
 
-            return {
-                .min = {glm::min(xa, xb) + glm::min(ya, yb) + glm::min(za, zb) + m[3]},
-                .max = {glm::max(xa, xb) + glm::max(ya, yb) + glm::max(za, zb) + m[3]},
-            };
+        template<typename T>
+        std::size_t FlatHashMap<T>::size() const
+        {
+            return m_Size;
+        }
+        template<typename T>
+        bool FlatHashMap<T>::empty() const
+        {
+            return m_Size == 0;
+        }
+        template<typename T>
+        void FlatHashMap<T>::clear()
+        {
+            m_Slots.clear();
+            m_Size = 0;
         }
-    } // namespace math
 
-    namespace log
-    {
-        void init()
+        template<typename T>
+        std::size_t FlatHashMap<T>::findSlot(std::size_t key) const
         {
-            std::vector<spdlog::sink_ptr> logSinks;
+            const auto mask = m_Slots.size() - 1;
 
-            logSinks.emplace_back(std::make_shared<spdlog::sinks::stdout_color_sink_mt>());
-            logSinks.emplace_back(std::make_shared<spdlog::sinks::basic_file_sink_mt>("VGFW.log", true));
+            auto i = key & mask;
+            while (m_Slots[i].value && m_Slots[i].key != key)
+                i = (i + 1) & mask;
+            return i;
+        }
 
-            logSinks[0]->set_pattern("%^[%T] %n: %v%$");
-            logSinks[1]->set_pattern("[%T] [%l] %n: %v");
+        template<typename T>
+        void FlatHashMap<T>::eraseSlot(std::size_t index)
+        {
+            const auto mask = m_Slots.size() - 1;
 
-            g_Logger = std::make_shared<spdlog::logger>("VGFW", begin(logSinks), end(logSinks));
-            spdlog::register_logger(g_Logger);
-            g_Logger->set_level(spdlog::level::trace);
-            g_Logger->flush_on(spdlog::level::trace);
+            m_Slots[index].value.reset();
+            --m_Size;
 
-            VGFW_INFO("[Logger] Initialized");
+            // Backward shift deletion, keeps probe sequences intact without tombstones
+            for (auto i = (index + 1) & mask; m_Slots[i].value; i = (i + 1) & mask)
+            {
+                const auto home = m_Slots[i].key & mask;
+                if (((i - home) & mask) >= ((i - index) & mask))
+                {
+                    m_Slots[index] = std::move(m_Slots[i]);
+                    m_Slots[i].value.reset();
+                    index = i;
+                }
+            }
         }
 
-        void shutdown()
+        template<typename T>
+        void FlatHashMap<T>::grow()
         {
-            VGFW_INFO("[Logger] Shutdown...");
-            spdlog::shutdown();
+            auto slots = std::exchange(m_Slots, std::vector<Slot>(std::max<std::size_t>(16, m_Slots.size() * 2)));
+            for (auto& slot : slots)
+            {
+                if (slot.value)
+                    m_Slots[findSlot(slot.key)] = std::move(slot);
+            }
         }
-    } // namespace log
 
-    namespace window
-    {
-        bool GLFWWindow::init(const WindowInitInfo& initInfo)
+        std::string readFileAllText(const std::filesystem::path& filePath)
         {
-            if (!glfwInit())
+            std::ifstream fileStream(filePath);
+
+            if (!fileStream.is_open())
+            {
+                throw std::runtime_error("Could not open file: " + filePath.string());
+            }
+
+            std::stringstream buffer;
+            buffer << fileStream.rdbuf();
+
+            return buffer.str();
+        }
+
+        ThreadPool::ThreadPool(uint32_t numThreads)
+        {
+            assert(numThreads > 0);
+            m_Workers.reserve(numThreads);
+            for (uint32_t i = 0; i < numThreads; ++i)
+                m_Workers.emplace_back(&ThreadPool::workerLoop, this);
+        }
+
+        ThreadPool::~ThreadPool()
+        {
+            {
+                std::lock_guard lock {m_Mutex};
+                m_Stop = true;
+            }
+            m_Condition.notify_all();
+
+            for (auto& worker : m_Workers)
+                worker.join();
+        }
+
+        void ThreadPool::submit(std::function<void()> task)
+        {
+            {
+                std::lock_guard lock {m_Mutex};
+                m_Tasks.push(std::move(task));
+            }
+            m_Condition.notify_one();
+        }
+
+        uint32_t ThreadPool::getNumThreads() const { return static_cast<uint32_t>(m_Workers.size()); }
+
+        void ThreadPool::workerLoop()
+        {
+            while (true)
+            {
+                std::function<void()> task;
+                {
+                    std::unique_lock lock {m_Mutex};
+                    m_Condition.wait(lock, [this] { return m_Stop || !m_Tasks.empty(); });
+                    if (m_Stop)
+                        return;
+
+                    task = std::move(m_Tasks.front());
+                    m_Tasks.pop();
+                }
+                task();
+            }
+        }
+
+        MappedFile::MappedFile(const std::filesystem::path& filePath)
+        {
+#if VGFW_PLATFORM_LINUX
+            const auto fd = open(filePath.c_str(), O_RDONLY);
+            if (fd < 0)
+                return;
+
+            struct stat fileStat {};
+            if (fstat(fd, &fileStat) == 0 && fileStat.st_size > 0)
+            {
+                if (auto* data = mmap(nullptr, fileStat.st_size, PROT_READ, MAP_PRIVATE, fd, 0); data != MAP_FAILED)
+                {
+                    m_Data = static_cast<const std::byte*>(data);
+                    m_Size = static_cast<std::size_t>(fileStat.st_size);
+                }
+            }
+            // The mapping keeps the file alive
+            close(fd);
+#elif VGFW_PLATFORM_WINDOWS
+            auto* file = CreateFileW(filePath.c_str(),
+                                     GENERIC_READ,
+                                     FILE_SHARE_READ,
+                                     nullptr,
+                                     OPEN_EXISTING,
+                                     FILE_ATTRIBUTE_NORMAL,
+                                     nullptr);
+            if (file == INVALID_HANDLE_VALUE)
+                return;
+
+            LARGE_INTEGER fileSize {};
+            if (GetFileSizeEx(file, &fileSize) && fileSize.QuadPart > 0)
+            {
+                if (auto* mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr))
+                {
+                    if (auto* data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0))
+                    {
+                        m_Data = static_cast<const std::byte*>(data);
+                        m_Size = static_cast<std::size_t>(fileSize.QuadPart);
+                    }
+                    // The view keeps the mapping (and the file) alive
+                    CloseHandle(mapping);
+                }
+            }
+            CloseHandle(file);
+#endif
+        }
+
+        MappedFile::~MappedFile()
+        {
+            if (!m_Data)
+                return;
+
+#if VGFW_PLATFORM_LINUX
+            munmap(const_cast<std::byte*>(m_Data), m_Size);
+#elif VGFW_PLATFORM_WINDOWS
+            UnmapViewOfFile(m_Data);
+#endif
+        }
+
+        MappedFile::operator bool() const { return m_Data != nullptr; }
+
+        std::span<const std::byte> MappedFile::getData() const { return {m_Data, m_Size}; }
+    } // namespace utils
+
+    namespace math
+    {
+        glm::vec3 AABB::getExtent() const { return max - min; }
+        glm::vec3 AABB::getCenter() const { return (max + min) * 0.5f; }
+        float     AABB::getRadius() const { return glm::length(getExtent() * 0.5f); }
+
+        void AABB::merge(const AABB& other)
+        {
+            min.x = std::min(min.x, other.min.x);
+            min.y = std::min(min.y, other.min.y);
+            min.z = std::min(min.z, other.min.z);
+
+            max.x = std::max(max.x, other.max.x);
+            max.y = std::max(max.y, other.max.y);
+            max.z = std::max(max.z, other.max.z);
+        }
+
+        // https://dev.theomader.com/transform-bounding-boxes/
+        AABB AABB::transform(const glm::mat4& m) const
+        {
+            const auto xa = m[0] * min.x;
+            const auto xb = m[0] * max.x;
+
+            const auto ya = m[1] * min.y;
+            const auto yb = m[1] * max.y;
+
+            const auto za = m[2] * min.z;
+            const auto zb = m[2] * max.z;
+
+            return {
+                .min = {glm::min(xa, xb) + glm::min(ya, yb) + glm::min(za, zb) + m[3]},
+                .max = {glm::max(xa, xb) + glm::max(ya, yb) + glm::max(za, zb) + m[3]},
+            };
+        }
+    } // namespace math
+
+    namespace culling
+    {
+        Frustum Frustum::fromViewProjection(const glm::mat4& m)
+        {
+            // Gribb & Hartmann, rows of the matrix combined against the w row
+            const auto row = [&m](int i) { return glm::vec4 {m[0][i], m[1][i], m[2][i], m[3][i]}; };
+
+            Frustum frustum {{
+                row(3) + row(0),
+                row(3) - row(0),
+                row(3) + row(1),
+                row(3) - row(1),
+                row(3) + row(2),
+                row(3) - row(2),
+            }};
+            for (auto& plane : frustum.planes)
+                plane /= glm::length(glm::vec3 {plane});
+
+            return frustum;
+        }
+
+        bool Frustum::isVisible(const math::AABB& aabb) const
+        {
+            const auto center = aabb.getCenter();
+            const auto extent = aabb.getExtent() * 0.5f;
+
+            for (const auto& plane : planes)
+            {
+                const auto normal = glm::vec3 {plane};
+                if (glm::dot(normal, center) + plane.w + glm::dot(glm::abs(normal), extent) < 0.0f)
+                    return false;
+            }
+            return true;
+        }
+
+        uint32_t BoundsList::add(const math::AABB& aabb)
+        {
+            if (m_Size == m_Centers[0].size())
+            {
+                for (auto* arrays : {&m_Centers, &m_Extents})
+                    for (auto& array : *arrays)
+                        array.resize(m_Size + kBatchSize, 0.0f);
+            }
+
+            set(m_Size, aabb);
+            return m_Size++;
+        }
+
+        void BoundsList::set(uint32_t index, const math::AABB& aabb)
+        {
+            assert(index < m_Centers[0].size());
+
+            const auto center = aabb.getCenter();
+            const auto extent = aabb.getExtent() * 0.5f;
+            for (uint32_t axis = 0; axis < 3; ++axis)
+            {
+                m_Centers[axis][index] = center[axis];
+                m_Extents[axis][index] = extent[axis];
+            }
+        }
+
+        void BoundsList::reserve(uint32_t count)
+        {
+            const auto paddedCount = (count + kBatchSize - 1) / kBatchSize * kBatchSize;
+            for (auto* arrays : {&m_Centers, &m_Extents})
+                for (auto& array : *arrays)
+                    array.reserve(paddedCount);
+        }
+
+        void BoundsList::clear()
+        {
+            m_Size = 0;
+            for (auto* arrays : {&m_Centers, &m_Extents})
+                for (auto& array : *arrays)
+                    array.clear();
+        }
+
+        uint32_t BoundsList::size() const { return m_Size; }
+        bool     BoundsList::empty() const { return m_Size == 0; }
+
+        const float* BoundsList::getCenters(uint32_t axis) const { return m_Centers[axis].data(); }
+        const float* BoundsList::getExtents(uint32_t axis) const { return m_Extents[axis].data(); }
+
+        // Each kernel tests kNumLanes bounds against all planes and returns one visibility bit per lane
+#if VGFW_SIMD_AVX
+        static constexpr uint32_t kNumLanes = 8;
+
+        static uint32_t cullLanes(const Frustum& frustum, const BoundsList& bounds, uint32_t first)
+        {
+            const __m256 cx = _mm256_loadu_ps(bounds.getCenters(0) + first);
+            const __m256 cy = _mm256_loadu_ps(bounds.getCenters(1) + first);
+            const __m256 cz = _mm256_loadu_ps(bounds.getCenters(2) + first);
+            const __m256 ex = _mm256_loadu_ps(bounds.getExtents(0) + first);
+            const __m256 ey = _mm256_loadu_ps(bounds.getExtents(1) + first);
+            const __m256 ez = _mm256_loadu_ps(bounds.getExtents(2) + first);
+
+            __m256 visible = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+            for (const auto& plane : frustum.planes)
+            {
+                const __m256 distance =
+                    _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(plane.x), cx),
+                                                _mm256_mul_ps(_mm256_set1_ps(plane.y), cy)),
+                                  _mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(plane.z), cz), _mm256_set1_ps(plane.w)));
+                const __m256 radius = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(std::abs(plane.x)), ex),
+                                                                  _mm256_mul_ps(_mm256_set1_ps(std::abs(plane.y)), ey)),
+                                                    _mm256_mul_ps(_mm256_set1_ps(std::abs(plane.z)), ez));
+
+                visible = _mm256_and_ps(
+                    visible, _mm256_cmp_ps(_mm256_add_ps(distance, radius), _mm256_setzero_ps(), _CMP_GE_OQ));
+            }
+            return static_cast<uint32_t>(_mm256_movemask_ps(visible));
+        }
+#elif VGFW_SIMD_SSE
+        static constexpr uint32_t kNumLanes = 4;
+
+        static uint32_t cullLanes(const Frustum& frustum, const BoundsList& bounds, uint32_t first)
+        {
+            const __m128 cx = _mm_loadu_ps(bounds.getCenters(0) + first);
+            const __m128 cy = _mm_loadu_ps(bounds.getCenters(1) + first);
+            const __m128 cz = _mm_loadu_ps(bounds.getCenters(2) + first);
+            const __m128 ex = _mm_loadu_ps(bounds.getExtents(0) + first);
+            const __m128 ey = _mm_loadu_ps(bounds.getExtents(1) + first);
+            const __m128 ez = _mm_loadu_ps(bounds.getExtents(2) + first);
+
+            __m128 visible = _mm_castsi128_ps(_mm_set1_epi32(-1));
+            for (const auto& plane : frustum.planes)
+            {
+                const __m128 distance =
+                    _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(plane.x), cx), _mm_mul_ps(_mm_set1_ps(plane.y), cy)),
+                               _mm_add_ps(_mm_mul_ps(_mm_set1_ps(plane.z), cz), _mm_set1_ps(plane.w)));
+                const __m128 radius = _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(std::abs(plane.x)), ex),
+                                                            _mm_mul_ps(_mm_set1_ps(std::abs(plane.y)), ey)),
+                                                 _mm_mul_ps(_mm_set1_ps(std::abs(plane.z)), ez));
+
+                visible = _mm_and_ps(visible, _mm_cmpge_ps(_mm_add_ps(distance, radius), _mm_setzero_ps()));
+            }
+            return static_cast<uint32_t>(_mm_movemask_ps(visible));
+        }
+#elif VGFW_SIMD_NEON
+        static constexpr uint32_t kNumLanes = 4;
+
+        static uint32_t cullLanes(const Frustum& frustum, const BoundsList& bounds, uint32_t first)
+        {
+            const float32x4_t cx = vld1q_f32(bounds.getCenters(0) + first);
+            const float32x4_t cy = vld1q_f32(bounds.getCenters(1) + first);
+            const float32x4_t cz = vld1q_f32(bounds.getCenters(2) + first);
+            const float32x4_t ex = vld1q_f32(bounds.getExtents(0) + first);
+            const float32x4_t ey = vld1q_f32(bounds.getExtents(1) + first);
+            const float32x4_t ez = vld1q_f32(bounds.getExtents(2) + first);
+
+            uint32x4_t visible = vdupq_n_u32(0xFFFFFFFF);
+            for (const auto& plane : frustum.planes)
+            {
+                float32x4_t distance = vdupq_n_f32(plane.w);
+                distance             = vmlaq_n_f32(distance, cx, plane.x);
+                distance             = vmlaq_n_f32(distance, cy, plane.y);
+                distance             = vmlaq_n_f32(distance, cz, plane.z);
+                distance             = vmlaq_n_f32(distance, ex, std::abs(plane.x));
+                distance             = vmlaq_n_f32(distance, ey, std::abs(plane.y));
+                distance             = vmlaq_n_f32(distance, ez, std::abs(plane.z));
+
+                visible = vandq_u32(visible, vcgeq_f32(distance, vdupq_n_f32(0.0f)));
+            }
+
+            const uint32x4_t laneBits = {1, 2, 4, 8};
+            return vaddvq_u32(vandq_u32(visible, laneBits));
+        }
+#else
+        static constexpr uint32_t kNumLanes = 1;
+
+        static uint32_t cullLanes(const Frustum& frustum, const BoundsList& bounds, uint32_t first)
+        {
+            for (const auto& plane : frustum.planes)
+            {
+                float distance = plane.w;
+                for (uint32_t axis = 0; axis < 3; ++axis)
+                {
+                    distance += plane[axis] * bounds.getCenters(axis)[first] +
+                                std::abs(plane[axis]) * bounds.getExtents(axis)[first];
+                }
+                if (distance < 0.0f)
+                    return 0;
+            }
+            return 1;
+        }
+#endif
+        static_assert(BoundsList::kBatchSize % kNumLanes == 0, "Kernels may not read past the padded bounds");
+
+        uint32_t cull(const Frustum& frustum, const BoundsList& bounds, std::vector<uint32_t>& visible)
+        {
+            VGFW_PROFILE_FUNCTION
+
+            const auto numVisible = visible.size();
+            for (uint32_t first = 0; first < bounds.size(); first += kNumLanes)
+            {
+                auto mask = cullLanes(frustum, bounds, first);
+                // Lanes past the end are padding
+                if (const auto numLanes = bounds.size() - first; numLanes < kNumLanes)
+                    mask &= (1u << numLanes) - 1;
+
+                while (mask)
+                {
+                    visible.push_back(first + std::countr_zero(mask));
+                    mask &= mask - 1;
+                }
+            }
+            return static_cast<uint32_t>(visible.size() - numVisible);
+        }
+
+        void cullViews(std::span<const Frustum> views, const BoundsList& bounds, std::vector<uint32_t>& masks)
+        {
+            VGFW_PROFILE_FUNCTION
+            assert(views.size() <= 32);
+
+            masks.assign(bounds.size(), 0u);
+            for (uint32_t first = 0; first < bounds.size(); first += kNumLanes)
+            {
+                // Lanes past the end are padding
+                const auto numLanes = std::min(bounds.size() - first, kNumLanes);
+                for (uint32_t view = 0; view < views.size(); ++view)
+                {
+                    const auto mask = cullLanes(views[view], bounds, first);
+                    for (uint32_t lane = 0; lane < numLanes; ++lane)
+                        masks[first + lane] |= ((mask >> lane) & 1u) << view;
+                }
+            }
+        }
+    } // namespace culling
+
+    namespace log
+    {
+        void init()
+        {
+            std::vector<spdlog::sink_ptr> logSinks;
+
+            logSinks.emplace_back(std::make_shared<spdlog::sinks::stdout_color_sink_mt>());
+            logSinks.emplace_back(std::make_shared<spdlog::sinks::basic_file_sink_mt>("VGFW.log", true));
+
+            logSinks[0]->set_pattern("%^[%T] %n: %v%$");
+            logSinks[1]->set_pattern("[%T] [%l] %n: %v");
+
+            g_Logger = std::make_shared<spdlog::logger>("VGFW", begin(logSinks), end(logSinks));
+            spdlog::register_logger(g_Logger);
+            g_Logger->set_level(spdlog::level::trace);
+            g_Logger->flush_on(spdlog::level::trace);
+
+            VGFW_INFO("[Logger] Initialized");
+        }
+
+        void shutdown()
+        {
+            VGFW_INFO("[Logger] Shutdown...");
+            spdlog::shutdown();
+        }
+    } // namespace log
+
+    namespace window
+    {
+        bool GLFWWindow::init(const WindowInitInfo& initInfo)
+        {
+            if (!glfwInit())
             {
                 VGFW_ERROR("Failed to initialize GLFW");
                 return false;
@@ -1409,6 +3162,7 @@ namespace vgfw
 
             glfwWindowHint(GLFW_SAMPLES, static_cast<int>(initInfo.aaSample));
             glfwWindowHint(GLFW_RESIZABLE, initInfo.isResizable);
+            glfwWindowHint(GLFW_VISIBLE, initInfo.isVisible);
 
             GLFWmonitor*       primaryMonitor = glfwGetPrimaryMonitor();
             const GLFWvidmode* mode           = glfwGetVideoMode(primaryMonitor);
@@ -1600,64 +3354,525 @@ namespace vgfw
 
         Buffer::operator GLuint() const { return m_Id; }
 
-        IndexType  IndexBuffer::getIndexType() const { return m_IndexType; }
-        GLsizeiptr IndexBuffer::getCapacity() const { return m_Size / static_cast<GLsizei>(m_IndexType); }
+        StagingRing::~StagingRing() { destroy(); }
 
-        IndexBuffer::IndexBuffer(Buffer buffer, IndexType indexType) :
-            Buffer {std::move(buffer)}, m_IndexType {indexType}
-        {}
+        void StagingRing::create(GLsizeiptr capacity)
+        {
+            assert(m_Id == GL_NONE && capacity > 0);
 
-        GLsizei    VertexBuffer::getStride() const { return m_Stride; }
-        GLsizeiptr VertexBuffer::getCapacity() const { return m_Size / m_Stride; }
+            constexpr GLbitfield kFlags {GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT};
+            glCreateBuffers(1, &m_Id);
+            glNamedBufferStorage(m_Id, capacity, nullptr, kFlags);
+            m_MappedMemory = static_cast<std::byte*>(glMapNamedBufferRange(m_Id, 0, capacity, kFlags));
+            m_Capacity     = capacity;
+            assert(m_MappedMemory);
 
-        VertexBuffer::VertexBuffer(Buffer buffer, GLsizei stride) : Buffer {std::move(buffer)}, m_Stride {stride} {}
+            VGFW_TRACE("[StagingRing] Created: {0} bytes", capacity);
+        }
 
-        int32_t getSize(VertexAttribute::Type type)
+        void StagingRing::destroy()
         {
-            switch (type)
-            {
-                using enum VertexAttribute::Type;
-                case eFloat:
-                    return sizeof(float);
-                case eFloat2:
-                    return sizeof(float) * 2;
-                case eFloat3:
-                    return sizeof(float) * 3;
-                case eFloat4:
-                    return sizeof(float) * 4;
-
-                case VertexAttribute::Type::eInt:
-                    return sizeof(int32_t);
-                case eInt4:
-                    return sizeof(int32_t) * 4;
+            if (m_Id == GL_NONE)
+                return;
 
-                case eUByte4_Norm:
-                    return sizeof(uint8_t) * 4;
-            }
-            return 0;
-        }
+            for (; !m_Fences.empty(); m_Fences.pop())
+                glDeleteSync(m_Fences.front().sync);
 
-        std::size_t VertexFormat::getHash() const { return m_Hash; }
+            glUnmapNamedBuffer(m_Id);
+            glDeleteBuffers(1, &m_Id);
 
-        const VertexAttributes& VertexFormat::getAttributes() const { return m_Attributes; }
-        bool                    VertexFormat::contains(AttributeLocation location) const
-        {
-            return m_Attributes.contains(static_cast<int32_t>(location));
+            m_Id           = GL_NONE;
+            m_MappedMemory = nullptr;
+            m_Capacity     = 0;
+            m_Head = m_Tail = 0;
         }
 
-        bool VertexFormat::contains(std::initializer_list<AttributeLocation> locations) const
+        StagingRing::Allocation StagingRing::allocate(GLsizeiptr size, GLsizeiptr alignment)
         {
-            return std::all_of(std::cbegin(locations), std::cend(locations), [&](auto location) {
-                return std::any_of(m_Attributes.cbegin(),
-                                   m_Attributes.cend(),
-                                   [v = static_cast<int32_t>(location)](const auto& p) { return p.first == v; });
-            });
-        }
+            assert(math::isPowerOf2(static_cast<uint32_t>(alignment)));
 
-        uint32_t VertexFormat::getStride() const { return m_Stride; }
+            std::lock_guard lock {m_Mutex};
+            if (!m_MappedMemory || size <= 0 || size > m_Capacity)
+                return {};
 
-        VertexFormat::VertexFormat(std::size_t hash, VertexAttributes&& attributes, uint32_t stride) :
-            m_Hash {hash}, m_Attributes {attributes}, m_Stride {stride}
+            const auto capacity = static_cast<uint64_t>(m_Capacity);
+
+            auto begin = (m_Head + alignment - 1) & ~static_cast<uint64_t>(alignment - 1);
+            // An allocation never wraps around, skip to the start instead
+            if (begin % capacity + size > capacity)
+                begin = (begin / capacity + 1) * capacity;
+            if (begin + size - m_Tail > capacity)
+                return {};
+
+            m_Head = begin + size;
+
+            const auto offset = static_cast<GLintptr>(begin % capacity);
+            return {m_MappedMemory + offset, offset, size};
+        }
+
+        void StagingRing::fence()
+        {
+            uint64_t head;
+            {
+                std::lock_guard lock {m_Mutex};
+                head = m_Head;
+            }
+            if (m_Fences.empty() ? head == m_Tail : head == m_Fences.back().head)
+                return;
+
+            m_Fences.push({glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0), head});
+        }
+
+        bool StagingRing::reclaim(bool wait)
+        {
+            constexpr GLuint64 kTimeout {1'000'000'000}; // 1s
+
+            bool reclaimed {false};
+            while (!m_Fences.empty())
+            {
+                const auto [sync, head] = m_Fences.front();
+
+                const bool block  = wait && !reclaimed;
+                const auto status =
+                    glClientWaitSync(sync, block ? GL_SYNC_FLUSH_COMMANDS_BIT : 0, block ? kTimeout : 0);
+                if (status != GL_ALREADY_SIGNALED && status != GL_CONDITION_SATISFIED)
+                    break;
+
+                glDeleteSync(sync);
+                m_Fences.pop();
+                {
+                    std::lock_guard lock {m_Mutex};
+                    m_Tail = head;
+                }
+                reclaimed = true;
+            }
+            return reclaimed;
+        }
+
+        GLuint     StagingRing::getId() const { return m_Id; }
+        GLsizeiptr StagingRing::getCapacity() const { return m_Capacity; }
+
+        bool StagingRing::contains(const void* ptr) const
+        {
+            const auto* p = static_cast<const std::byte*>(ptr);
+            return m_MappedMemory && p >= m_MappedMemory && p < m_MappedMemory + m_Capacity;
+        }
+
+        GLintptr StagingRing::getOffset(const void* ptr) const
+        {
+            assert(contains(ptr));
+            return static_cast<const std::byte*>(ptr) - m_MappedMemory;
+        }
+
+        UniformRing::~UniformRing() { destroy(); }
+
+        void UniformRing::create(RenderContext& rc, GLsizeiptr frameSize, uint32_t numFrames)
+        {
+            assert(!m_Buffer && frameSize > 0 && numFrames > 0);
+            m_RenderContext = &rc;
+
+            GLint alignment;
+            glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &alignment);
+            m_Alignment = alignment;
+            // Every region starts aligned
+            m_FrameSize = (frameSize + m_Alignment - 1) / m_Alignment * m_Alignment;
+
+            constexpr GLbitfield kFlags {GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT};
+            m_Buffer       = RenderContext::createBuffer(m_FrameSize * numFrames, nullptr, kFlags);
+            m_MappedMemory = static_cast<std::byte*>(glMapNamedBufferRange(m_Buffer.m_Id, 0, m_Buffer.m_Size, kFlags));
+            m_Buffer.m_MappedMemory = m_MappedMemory;
+            assert(m_MappedMemory);
+
+            m_Fences.assign(numFrames, nullptr);
+            m_OverflowBuffers.resize(numFrames);
+            m_FrameIndex = 0;
+            m_Offset     = 0;
+
+            VGFW_TRACE("[UniformRing] Created: {0} frames x {1} bytes", numFrames, m_FrameSize);
+        }
+
+        void UniformRing::destroy()
+        {
+            if (!m_Buffer)
+                return;
+
+            for (auto fence : m_Fences)
+                if (fence)
+                    glDeleteSync(fence);
+            m_Fences.clear();
+
+            for (uint32_t i = 0; i < m_OverflowBuffers.size(); ++i)
+                releaseOverflow(i);
+            m_OverflowBuffers.clear();
+
+            glUnmapNamedBuffer(m_Buffer.m_Id);
+            m_Buffer.m_MappedMemory = nullptr;
+            glDeleteBuffers(1, &m_Buffer.m_Id);
+            m_Buffer       = {};
+            m_MappedMemory = nullptr;
+        }
+
+        void UniformRing::beginFrame()
+        {
+            m_FrameIndex = (m_FrameIndex + 1) % m_Fences.size();
+            m_Offset     = 0;
+
+            // Wait until the GPU is done with the frame that last used this region
+            if (auto& fence = m_Fences[m_FrameIndex]; fence)
+            {
+                VGFW_PROFILE_NAMED_SCOPE("UniformRing::wait");
+                constexpr GLuint64 kTimeout {1'000'000'000}; // 1s
+                while (glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, kTimeout) == GL_TIMEOUT_EXPIRED)
+                    ;
+                glDeleteSync(fence);
+                fence = nullptr;
+            }
+            releaseOverflow(m_FrameIndex);
+        }
+
+        void UniformRing::endFrame()
+        {
+            auto& fence = m_Fences[m_FrameIndex];
+            assert(!fence);
+            fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        }
+
+        UniformAllocation UniformRing::allocate(GLsizeiptr size)
+        {
+            assert(m_MappedMemory && size > 0);
+
+            if (m_Offset + size > m_FrameSize)
+                return allocateOverflow(size);
+
+            const auto offset = m_FrameIndex * m_FrameSize + m_Offset;
+            m_Offset          = (m_Offset + size + m_Alignment - 1) / m_Alignment * m_Alignment;
+
+            return {m_MappedMemory + offset, offset, size, &m_Buffer};
+        }
+
+        UniformAllocation UniformRing::allocateOverflow(GLsizeiptr size)
+        {
+            auto& buffers = m_OverflowBuffers[m_FrameIndex];
+            if (buffers.empty() || m_OverflowOffset + size > buffers.back()->m_Size)
+            {
+                // Rather than failing the draw, RenderContext::kUniformRingFrameSize wants raising when this shows up
+                const auto bufferSize = std::max(m_FrameSize, (size + m_Alignment - 1) / m_Alignment * m_Alignment);
+                VGFW_WARN("[UniformRing] Frame region of {0} bytes used up, allocating a {1} byte overflow buffer",
+                          m_FrameSize,
+                          bufferSize);
+
+                constexpr GLbitfield kFlags {GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT};
+                auto buffer = std::make_unique<Buffer>(RenderContext::createBuffer(bufferSize, nullptr, kFlags));
+                buffer->m_MappedMemory = glMapNamedBufferRange(buffer->m_Id, 0, bufferSize, kFlags);
+                assert(buffer->m_MappedMemory);
+
+                buffers.push_back(std::move(buffer));
+                m_OverflowOffset = 0;
+            }
+
+            const auto& buffer = *buffers.back();
+            const auto  offset = m_OverflowOffset;
+            m_OverflowOffset   = (m_OverflowOffset + size + m_Alignment - 1) / m_Alignment * m_Alignment;
+
+            return {static_cast<std::byte*>(buffer.m_MappedMemory) + offset, offset, size, &buffer};
+        }
+
+        void UniformRing::releaseOverflow(uint32_t frameIndex)
+        {
+            // The name may be recycled by the next overflow buffer, its bindings must not look current then
+            for (auto& buffer : m_OverflowBuffers[frameIndex])
+            {
+                glUnmapNamedBuffer(buffer->m_Id);
+                buffer->m_MappedMemory = nullptr;
+                m_RenderContext->destroy(*buffer);
+            }
+            m_OverflowBuffers[frameIndex].clear();
+        }
+
+        const Buffer& UniformRing::getBuffer() const { return m_Buffer; }
+
+        GeometryArena::GeometryArena(RenderContext& rc, GLsizeiptr vertexChunkSize, GLsizeiptr indexChunkSize) :
+            m_RenderContext {rc}, m_VertexChunkSize {vertexChunkSize}, m_IndexChunkSize {indexChunkSize}
+        {
+            GLint alignment;
+            glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &alignment);
+            m_UniformAlignment = alignment;
+        }
+
+        GeometryArena::Allocation GeometryArena::add(const VertexFormat&       vertexFormat,
+                                                     const void*               vertices,
+                                                     uint32_t                  numVertices,
+                                                     std::span<const uint32_t> indices,
+                                                     IndexType                 indexType)
+        {
+            const auto stride     = static_cast<GLsizei>(vertexFormat.getStride());
+            const auto numIndices = static_cast<uint32_t>(indices.size());
+            const auto indexSize  = static_cast<GLsizeiptr>(indexType);
+
+            auto key = vertexFormat.getHash();
+            utils::hashCombine(key, indexType);
+            auto& chunks = m_Chunks[key];
+
+            const auto fits = [&](const Chunk& chunk) {
+                return chunk.numVertices + numVertices <= chunk.vertexBuffer->getCapacity() &&
+                       chunk.numIndices + numIndices <= chunk.indexBuffer->getCapacity();
+            };
+            if (chunks.empty() || !fits(chunks.back()))
+            {
+                // Oversized meshes get a chunk of their own
+                const auto vertexCapacity = std::max<int64_t>(m_VertexChunkSize / stride, numVertices);
+                const auto indexCapacity  = std::max<int64_t>(m_IndexChunkSize / indexSize, numIndices);
+
+                auto& chunk        = chunks.emplace_back();
+                chunk.vertexBuffer = std::shared_ptr<VertexBuffer>(
+                    new VertexBuffer {RenderContext::createVertexBuffer(stride, vertexCapacity)},
+                    RenderContext::ResourceDeleter {m_RenderContext});
+                chunk.indexBuffer = std::shared_ptr<IndexBuffer>(
+                    new IndexBuffer {RenderContext::createIndexBuffer(indexType, indexCapacity)},
+                    RenderContext::ResourceDeleter {m_RenderContext});
+
+                VGFW_TRACE("[GeometryArena] New chunk for vertex format {0}: {1} vertices, {2} indices",
+                           vertexFormat.getHash(),
+                           vertexCapacity,
+                           indexCapacity);
+            }
+
+            auto& chunk = chunks.back();
+
+            const Allocation allocation {
+                .vertexBuffer = chunk.vertexBuffer,
+                .indexBuffer  = chunk.indexBuffer,
+                .baseVertex   = static_cast<int32_t>(chunk.numVertices),
+                .firstIndex   = chunk.numIndices,
+            };
+            const auto narrowed = narrowIndices(indices, indexType);
+            m_RenderContext
+                .upload(*chunk.vertexBuffer,
+                        GLintptr {chunk.numVertices} * stride,
+                        GLsizeiptr {numVertices} * stride,
+                        vertices)
+                .upload(*chunk.indexBuffer, chunk.numIndices * indexSize, numIndices * indexSize, narrowed.data());
+
+            chunk.numVertices += numVertices;
+            chunk.numIndices += numIndices;
+
+            return allocation;
+        }
+
+        GeometryArena::UniformAllocation GeometryArena::addUniform(const void* data, GLsizeiptr size)
+        {
+            assert(size > 0 && size <= kUniformChunkSize);
+
+            if (m_UniformChunks.empty() || m_UniformChunks.back().size + size > kUniformChunkSize)
+            {
+                auto& chunk  = m_UniformChunks.emplace_back();
+                chunk.buffer = std::shared_ptr<Buffer>(new Buffer {RenderContext::createBuffer(kUniformChunkSize)},
+                                                       RenderContext::ResourceDeleter {m_RenderContext});
+            }
+
+            auto&                   chunk = m_UniformChunks.back();
+            const UniformAllocation allocation {.buffer = chunk.buffer, .offset = chunk.size};
+
+            m_RenderContext.upload(*chunk.buffer, chunk.size, size, data);
+            chunk.size = (chunk.size + size + m_UniformAlignment - 1) / m_UniformAlignment * m_UniformAlignment;
+
+            return allocation;
+        }
+
+        // [63] transparent | opaque: [62..47] pipeline [46..24] material [23..0] depth
+        //                  | transparent: [62..39] inverted depth [38..23] pipeline [22..0] material
+        static constexpr uint32_t kSortKeyPipelineBits = 16;
+        static constexpr uint32_t kSortKeyMaterialBits = 23;
+        static constexpr uint32_t kSortKeyDepthBits    = 24;
+
+        static constexpr uint64_t kSortKeyPipelineMask = (1ull << kSortKeyPipelineBits) - 1;
+        static constexpr uint64_t kSortKeyMaterialMask = (1ull << kSortKeyMaterialBits) - 1;
+        static constexpr uint64_t kSortKeyDepthMask    = (1ull << kSortKeyDepthBits) - 1;
+
+        // Non-negative floats order like their bit patterns, keep the exponent and the top of the mantissa
+        static uint64_t quantizeDepth(float depth)
+        {
+            return (std::bit_cast<uint32_t>(std::max(depth, 0.0f)) >> (31 - kSortKeyDepthBits)) & kSortKeyDepthMask;
+        }
+
+        RenderQueue& RenderQueue::clear()
+        {
+            m_Items.clear();
+            m_PipelineIds.clear();
+            m_MaterialIds.clear();
+            return *this;
+        }
+
+        RenderQueue& RenderQueue::reserve(uint32_t numItems)
+        {
+            m_Items.reserve(numItems);
+            return *this;
+        }
+
+        RenderQueue& RenderQueue::push(const GraphicsPipeline&        pipeline,
+                                       const resource::MeshPrimitive& primitive,
+                                       float                          depth,
+                                       bool                           transparent,
+                                       uint32_t                       lod)
+        {
+            const uint64_t pipelineId = getPipelineId(pipeline) & kSortKeyPipelineMask;
+            const uint64_t materialId = getMaterialId(primitive) & kSortKeyMaterialMask;
+            const uint64_t depthBits  = quantizeDepth(depth);
+
+            uint64_t key;
+            if (transparent)
+            {
+                key = (1ull << 63) |
+                      ((kSortKeyDepthMask - depthBits) << (kSortKeyPipelineBits + kSortKeyMaterialBits)) |
+                      (pipelineId << kSortKeyMaterialBits) | materialId;
+            }
+            else
+            {
+                key = (pipelineId << (kSortKeyMaterialBits + kSortKeyDepthBits)) | (materialId << kSortKeyDepthBits) |
+                      depthBits;
+            }
+
+            m_Items.push_back({.key = key, .pipeline = &pipeline, .primitive = &primitive, .lod = lod});
+            return *this;
+        }
+
+        RenderQueue& RenderQueue::sort()
+        {
+            VGFW_PROFILE_FUNCTION
+
+            // LSD radix sort, 8 passes of 8 bits; passes where every key has the same digit are skipped
+            m_SortBuffer.resize(m_Items.size());
+
+            for (uint32_t shift = 0; shift < 64; shift += 8)
+            {
+                std::array<uint32_t, 256> offsets {};
+                for (const auto& item : m_Items)
+                    ++offsets[(item.key >> shift) & 0xFF];
+
+                if (std::ranges::find(offsets, static_cast<uint32_t>(m_Items.size())) != offsets.cend())
+                    continue;
+
+                uint32_t sum = 0;
+                for (auto& offset : offsets)
+                    sum += std::exchange(offset, sum);
+
+                for (const auto& item : m_Items)
+                    m_SortBuffer[offsets[(item.key >> shift) & 0xFF]++] = item;
+
+                m_Items.swap(m_SortBuffer);
+            }
+            return *this;
+        }
+
+        const std::vector<RenderQueue::Item>& RenderQueue::getItems() const { return m_Items; }
+
+        void RenderQueue::submit(RenderContext& rc, GLuint materialBufferIndex, GLuint firstTextureUnit) const
+        {
+            VGFW_PROFILE_FUNCTION
+
+            const GraphicsPipeline* currentPipeline = nullptr;
+            for (const auto& [_, pipeline, primitive, lod] : m_Items)
+            {
+                // bindGraphicsPipeline compares every state group, skip it outright for runs of the same pipeline
+                if (pipeline != currentPipeline)
+                {
+                    rc.bindGraphicsPipeline(*pipeline);
+                    currentPipeline = pipeline;
+                }
+
+                rc.bindMeshPrimitiveMaterialBuffer(materialBufferIndex, *primitive)
+                    .bindMeshPrimitiveTextures(firstTextureUnit, *primitive)
+                    .drawMeshPrimitive(*primitive, lod);
+            }
+        }
+
+        uint32_t RenderQueue::getPipelineId(const GraphicsPipeline& pipeline)
+        {
+            return m_PipelineIds.try_emplace(&pipeline, static_cast<uint32_t>(m_PipelineIds.size())).first->second;
+        }
+
+        uint32_t RenderQueue::getMaterialId(const resource::MeshPrimitive& primitive)
+        {
+            // Material parameters are a per-primitive buffer range anyway, the texture set is the state worth grouping
+            std::size_t hash {0};
+            utils::hashCombine(hash, primitive.ownerModel);
+            for (const auto textureIndex : primitive.textureIndices)
+                utils::hashCombine(hash, textureIndex);
+
+            return m_MaterialIds.try_emplace(hash, static_cast<uint32_t>(m_MaterialIds.size())).first->second;
+        }
+
+        IndexType  IndexBuffer::getIndexType() const { return m_IndexType; }
+        GLsizeiptr IndexBuffer::getCapacity() const { return m_Size / static_cast<GLsizei>(m_IndexType); }
+
+        IndexBuffer::IndexBuffer(Buffer buffer, IndexType indexType) :
+            Buffer {std::move(buffer)}, m_IndexType {indexType}
+        {}
+
+        GLsizei    VertexBuffer::getStride() const { return m_Stride; }
+        GLsizeiptr VertexBuffer::getCapacity() const { return m_Size / m_Stride; }
+
+        VertexBuffer::VertexBuffer(Buffer buffer, GLsizei stride) : Buffer {std::move(buffer)}, m_Stride {stride} {}
+
+        int32_t getSize(VertexAttribute::Type type)
+        {
+            switch (type)
+            {
+                using enum VertexAttribute::Type;
+                case eFloat:
+                    return sizeof(float);
+                case eFloat2:
+                    return sizeof(float) * 2;
+                case eFloat3:
+                    return sizeof(float) * 3;
+                case eFloat4:
+                    return sizeof(float) * 4;
+
+                case VertexAttribute::Type::eInt:
+                    return sizeof(int32_t);
+                case eInt4:
+                    return sizeof(int32_t) * 4;
+
+                case eUByte4_Norm:
+                    return sizeof(uint8_t) * 4;
+                case eShort4_Norm:
+                    return sizeof(int16_t) * 4;
+                case eInt2_10_10_10_Rev_Norm:
+                    return sizeof(uint32_t);
+
+                case eHalf2:
+                    return sizeof(uint16_t) * 2;
+                case eHalf4:
+                    return sizeof(uint16_t) * 4;
+            }
+            return 0;
+        }
+
+        std::size_t VertexFormat::getHash() const { return m_Hash; }
+
+        const VertexAttributes& VertexFormat::getAttributes() const { return m_Attributes; }
+        bool                    VertexFormat::contains(AttributeLocation location) const
+        {
+            return m_Attributes.contains(static_cast<int32_t>(location));
+        }
+
+        bool VertexFormat::contains(std::initializer_list<AttributeLocation> locations) const
+        {
+            return std::all_of(std::cbegin(locations), std::cend(locations), [&](auto location) {
+                return std::any_of(m_Attributes.cbegin(),
+                                   m_Attributes.cend(),
+                                   [v = static_cast<int32_t>(location)](const auto& p) { return p.first == v; });
+            });
+        }
+
+        uint32_t VertexFormat::getStride() const { return m_Stride; }
+        uint32_t VertexFormat::getInstanceStride() const { return m_InstanceStride; }
+
+        VertexFormat::VertexFormat(std::size_t        hash,
+                                   VertexAttributes&& attributes,
+                                   uint32_t           stride,
+                                   uint32_t           instanceStride) :
+            m_Hash {hash}, m_Attributes {attributes}, m_Stride {stride}, m_InstanceStride {instanceStride}
         {}
 
         using Builder = VertexFormat::Builder;
@@ -1668,21 +3883,58 @@ namespace vgfw
             return *this;
         }
 
+        Builder&
+        Builder::setInstanceAttribute(AttributeLocation location, const VertexAttribute& attribute, uint32_t divisor)
+        {
+            assert(divisor > 0);
+            auto instanceAttribute    = attribute;
+            instanceAttribute.divisor = divisor;
+            return setAttribute(location, instanceAttribute);
+        }
+
+        Builder& Builder::setInstanceData(uint32_t divisor)
+        {
+            // A mat4 attribute is fed as four vec4 columns
+            const auto firstColumn = static_cast<int32_t>(AttributeLocation::eInstanceModelMatrix);
+            for (int32_t column = 0; column < 4; ++column)
+            {
+                setInstanceAttribute(static_cast<AttributeLocation>(firstColumn + column),
+                                     {.vertType = VertexAttribute::Type::eFloat4,
+                                      .offset   = static_cast<int32_t>(offsetof(InstanceData, modelMatrix)) +
+                                                column * static_cast<int32_t>(sizeof(glm::vec4))},
+                                     divisor);
+            }
+            // Includes the padding, the attributes alone are smaller
+            m_InstanceStride = sizeof(InstanceData);
+            return setInstanceAttribute(
+                AttributeLocation::eInstanceID,
+                {.vertType = VertexAttribute::Type::eInt, .offset = offsetof(InstanceData, instanceId)},
+                divisor);
+        }
+
         std::shared_ptr<VertexFormat> Builder::build()
         {
             uint32_t    stride {0};
+            uint32_t    instanceStride {0};
             std::size_t hash {0};
             for (const auto& [location, attribute] : m_Attributes)
             {
-                stride += getSize(attribute.vertType);
+                (attribute.divisor > 0 ? instanceStride : stride) += getSize(attribute.vertType);
                 utils::hashCombine(hash, location, attribute);
             }
+            if (m_InstanceStride > 0)
+            {
+                instanceStride = m_InstanceStride;
+                utils::hashCombine(hash, m_InstanceStride);
+            }
 
+            std::lock_guard lock {s_CacheMutex};
             if (const auto it = s_Cache.find(hash); it != s_Cache.cend())
                 if (auto vertexFormat = it->second.lock(); vertexFormat)
                     return vertexFormat;
 
-            auto vertexFormat = std::make_shared<VertexFormat>(VertexFormat {hash, std::move(m_Attributes), stride});
+            auto vertexFormat =
+                std::make_shared<VertexFormat>(VertexFormat {hash, std::move(m_Attributes), stride, instanceStride});
             s_Cache.insert_or_assign(hash, vertexFormat);
             return vertexFormat;
         }
@@ -1690,6 +3942,7 @@ namespace vgfw
         std::shared_ptr<VertexFormat> Builder::buildDefault()
         {
             m_Attributes.clear();
+            m_InstanceStride = 0;
 
             setAttribute(AttributeLocation::ePosition, {.vertType = VertexAttribute::Type::eFloat3, .offset = 0});
             setAttribute(AttributeLocation::eNormal_Color, {.vertType = VertexAttribute::Type::eFloat3, .offset = 12});
@@ -1699,7 +3952,7 @@ namespace vgfw
         }
 
         Texture::Texture(Texture&& other) noexcept :
-            m_Id {other.m_Id}, m_Type {other.m_Type}, m_View {other.m_View}, m_Extent {other.m_Extent},
+            m_Id {other.m_Id}, m_Type {other.m_Type}, m_Extent {other.m_Extent},
             m_Depth {other.m_Depth}, m_NumMipLevels {other.m_NumMipLevels}, m_NumLayers {other.m_NumLayers},
             m_PixelFormat {other.m_PixelFormat}
         {
@@ -1771,6 +4024,9 @@ namespace vgfw
                 case eRGBA8_SNorm:
                     return "RGBA8_SNorm";
 
+                case eRG16_UNorm:
+                    return "RG16_UNorm";
+
                 case eR16F:
                     return "R16F";
                 case eRG16F:
@@ -1780,6 +4036,8 @@ namespace vgfw
                 case eRGBA16F:
                     return "RGBA16F";
 
+                case eR32F:
+                    return "R32F";
                 case eRGB32F:
                     return "RGB32F";
                 case eRGBA32F:
@@ -1797,6 +4055,15 @@ namespace vgfw
                 case eDepth32F:
                     return "Depth32F";
 
+                case eBC1_UNorm:
+                    return "BC1_UNorm";
+                case eBC3_UNorm:
+                    return "BC3_UNorm";
+                case eBC5_UNorm:
+                    return "BC5_UNorm";
+                case eBC7_UNorm:
+                    return "BC7_UNorm";
+
                 case PixelFormat::eUnknown:
                     break;
             }
@@ -1804,35 +4071,258 @@ namespace vgfw
             return "Undefined";
         }
 
-        GraphicsPipeline::Builder& GraphicsPipeline::Builder::setShaderProgram(GLuint program)
+        uint32_t getBytesPerPixel(PixelFormat pixelFormat)
         {
-            m_Program = program;
-            return *this;
-        }
+            switch (pixelFormat)
+            {
+                using enum PixelFormat;
 
-        GraphicsPipeline::Builder& GraphicsPipeline::Builder::setVAO(GLuint vao)
-        {
-            m_VAO = vao;
-            return *this;
-        }
+                case eR8_UNorm:
+                    return 1;
 
-        GraphicsPipeline::Builder& GraphicsPipeline::Builder::setDepthStencil(const DepthStencilState& state)
-        {
-            m_DepthStencilState = state;
-            return *this;
-        }
+                case eRGB8_UNorm:
+                case eRGB8_SNorm:
+                    return 3;
+                case eRGBA8_UNorm:
+                case eRGBA8_SNorm:
+                case eRG16_UNorm:
+                    return 4;
 
-        GraphicsPipeline::Builder& GraphicsPipeline::Builder::setRasterizerState(const RasterizerState& state)
-        {
-            m_RasterizerState = state;
-            return *this;
-        }
+                case eR16F:
+                    return 2;
+                case eRG16F:
+                    return 4;
+                case eRGB16F:
+                    return 6;
+                case eRGBA16F:
+                    return 8;
 
-        GraphicsPipeline::Builder& GraphicsPipeline::Builder::setBlendState(uint32_t          attachment,
-                                                                            const BlendState& state)
-        {
-            assert(attachment < kMaxNumBlendStates);
-            m_BlendStates[attachment] = state;
+                case eR32F:
+                case eR32I:
+                    return 4;
+                case eRGB32F:
+                    return 12;
+                case eRGBA32F:
+                case eRGBA32UI:
+                    return 16;
+
+                case eDepth16:
+                    return 2;
+                case eDepth24: // Padded to 32 bits by the drivers
+                case eDepth32F:
+                    return 4;
+
+                case eBC1_UNorm:
+                case eBC3_UNorm:
+                case eBC5_UNorm:
+                case eBC7_UNorm:
+                case PixelFormat::eUnknown:
+                    break;
+            }
+
+            return 0;
+        }
+
+        bool isCompressed(PixelFormat pixelFormat) { return getBlockSize(pixelFormat) > 0; }
+
+        uint32_t getBlockSize(PixelFormat pixelFormat)
+        {
+            switch (pixelFormat)
+            {
+                case PixelFormat::eBC1_UNorm:
+                    return 8;
+                case PixelFormat::eBC3_UNorm:
+                case PixelFormat::eBC5_UNorm:
+                case PixelFormat::eBC7_UNorm:
+                    return 16;
+
+                default:
+                    return 0;
+            }
+        }
+
+        GLsizeiptr calcCompressedSize(PixelFormat pixelFormat, glm::uvec2 dimensions)
+        {
+            const auto numBlocks = (glm::max(dimensions, glm::uvec2 {1u}) + 3u) / 4u;
+            return GLsizeiptr {numBlocks.x} * numBlocks.y * getBlockSize(pixelFormat);
+        }
+
+        std::vector<std::byte> narrowIndices(std::span<const uint32_t> indices, IndexType indexType)
+        {
+            std::vector<std::byte> narrowed(indices.size() * static_cast<std::size_t>(indexType));
+
+            const auto narrow = [&]<typename T>(T*) {
+                auto* out = reinterpret_cast<T*>(narrowed.data());
+                for (std::size_t i = 0; i < indices.size(); ++i)
+                {
+                    assert(indices[i] <= std::numeric_limits<T>::max());
+                    out[i] = static_cast<T>(indices[i]);
+                }
+            };
+            switch (indexType)
+            {
+                case IndexType::eUInt8:
+                    narrow(static_cast<uint8_t*>(nullptr));
+                    break;
+                case IndexType::eUInt16:
+                    narrow(static_cast<uint16_t*>(nullptr));
+                    break;
+                case IndexType::eUInt32:
+                    std::memcpy(narrowed.data(), indices.data(), indices.size_bytes());
+                    break;
+
+                default:
+                    assert(false);
+            }
+            return narrowed;
+        }
+
+        GLsizeiptr calcTextureSize(const Texture& texture)
+        {
+            const auto       extent      = texture.getExtent();
+            const auto       pixelFormat = texture.getPixelFormat();
+            const glm::uvec3 baseSize {extent.width, extent.height, std::max(texture.getDepth(), 1u)};
+
+            GLsizeiptr size {0};
+            for (uint32_t level = 0; level < texture.getNumMipLevels(); ++level)
+            {
+                const auto mipSize = glm::max(calcMipSize(baseSize, level), glm::uvec3 {1u});
+                size += isCompressed(pixelFormat) ?
+                            calcCompressedSize(pixelFormat, {mipSize.x, mipSize.y}) * mipSize.z :
+                            GLsizeiptr {mipSize.x} * mipSize.y * mipSize.z * getBytesPerPixel(pixelFormat);
+            }
+            return size * std::max(texture.getNumLayers(), 1u);
+        }
+
+        void UniformTable::reflect(GLuint program)
+        {
+            m_Program = program;
+            m_Locations.clear();
+
+            GLint numUniforms {0};
+            glGetProgramInterfaceiv(program, GL_UNIFORM, GL_ACTIVE_RESOURCES, &numUniforms);
+
+            constexpr std::array<GLenum, 3> kProperties {GL_NAME_LENGTH, GL_LOCATION, GL_ARRAY_SIZE};
+            std::string                     name;
+            for (GLint i {0}; i < numUniforms; ++i)
+            {
+                std::array<GLint, kProperties.size()> values {};
+                glGetProgramResourceiv(program,
+                                       GL_UNIFORM,
+                                       i,
+                                       kProperties.size(),
+                                       kProperties.data(),
+                                       values.size(),
+                                       nullptr,
+                                       values.data());
+                const auto [nameLength, location, arraySize] = values;
+
+                // Members of uniform blocks have no location
+                if (location == -1)
+                    continue;
+
+                name.resize(nameLength);
+                glGetProgramResourceName(program, GL_UNIFORM, i, nameLength, nullptr, name.data());
+                name.resize(nameLength - 1); // null terminator
+
+                // Arrays are reported as "name[0]", register "name" and every "name[i]"
+                if (const auto bracket = name.find('['); bracket != std::string::npos)
+                {
+                    const auto baseName = name.substr(0, bracket);
+                    m_Locations.emplace(baseName, location);
+                    for (GLint element {0}; element < arraySize; ++element)
+                        m_Locations.emplace(baseName + "[" + std::to_string(element) + "]", location + element);
+                }
+                else
+                {
+                    m_Locations.emplace(name, location);
+                }
+            }
+        }
+
+        UniformHandle UniformTable::find(std::string_view name) const
+        {
+            if (const auto it = m_Locations.find(name); it != m_Locations.cend())
+                return {it->second, m_Program};
+            return {};
+        }
+
+        ProgramHandle::operator bool() const { return m_State != nullptr; }
+
+        bool ProgramHandle::isReady() const
+        {
+            assert(m_State);
+            if (m_State->released)
+                return false;
+            if (m_State->linked || !RenderContext::hasParallelShaderCompile())
+                return true;
+
+            GLint completed {GL_FALSE};
+            glGetProgramiv(m_State->program, GL_COMPLETION_STATUS_KHR, &completed);
+            return completed == GL_TRUE;
+        }
+
+        GLuint ProgramHandle::get() const
+        {
+            assert(m_State);
+            return RenderContext::finalizeProgram(*m_State);
+        }
+
+        UniformHandle GraphicsPipeline::getUniform(std::string_view name) const
+        {
+            return RenderContext::getUniform(getProgram(), name);
+        }
+
+        bool GraphicsPipeline::isReady() const
+        {
+            return m_Program != GL_NONE || !m_PendingProgram || m_PendingProgram.isReady();
+        }
+
+        GLuint GraphicsPipeline::getProgram() const
+        {
+            if (m_Program == GL_NONE && m_PendingProgram)
+                return m_PendingProgram.get();
+            return m_Program;
+        }
+
+        GraphicsPipeline::Builder& GraphicsPipeline::Builder::setShaderProgram(GLuint program)
+        {
+            m_Program        = program;
+            m_PendingProgram = {};
+            return *this;
+        }
+
+        GraphicsPipeline::Builder& GraphicsPipeline::Builder::setShaderProgram(const ProgramHandle& program)
+        {
+            assert(program);
+            m_Program        = GL_NONE;
+            m_PendingProgram = program;
+            return *this;
+        }
+
+        GraphicsPipeline::Builder& GraphicsPipeline::Builder::setVAO(GLuint vao)
+        {
+            m_VAO = vao;
+            return *this;
+        }
+
+        GraphicsPipeline::Builder& GraphicsPipeline::Builder::setDepthStencil(const DepthStencilState& state)
+        {
+            m_DepthStencilState = state;
+            return *this;
+        }
+
+        GraphicsPipeline::Builder& GraphicsPipeline::Builder::setRasterizerState(const RasterizerState& state)
+        {
+            m_RasterizerState = state;
+            return *this;
+        }
+
+        GraphicsPipeline::Builder& GraphicsPipeline::Builder::setBlendState(uint32_t          attachment,
+                                                                            const BlendState& state)
+        {
+            assert(attachment < kMaxNumBlendStates);
+            m_BlendStates[attachment] = state;
             return *this;
         }
 
@@ -1841,6 +4331,7 @@ namespace vgfw
             GraphicsPipeline g;
 
             g.m_Program           = m_Program;
+            g.m_PendingProgram    = m_PendingProgram;
             g.m_VAO               = m_VAO;
             g.m_DepthStencilState = m_DepthStencilState;
             g.m_RasterizerState   = m_RasterizerState;
@@ -1871,6 +4362,15 @@ namespace vgfw
 
                 case eUByte4_Norm:
                     return {GL_UNSIGNED_BYTE, 4, GL_TRUE};
+                case eShort4_Norm:
+                    return {GL_SHORT, 4, GL_TRUE};
+                case eInt2_10_10_10_Rev_Norm:
+                    return {GL_INT_2_10_10_10_REV, 4, GL_TRUE};
+
+                case eHalf2:
+                    return {GL_HALF_FLOAT, 2, GL_FALSE};
+                case eHalf4:
+                    return {GL_HALF_FLOAT, 4, GL_FALSE};
             }
             return {GL_INVALID_INDEX, 0, GL_FALSE};
         }
@@ -1943,21 +4443,315 @@ namespace vgfw
             return GL_NONE;
         }
 
-        RenderContext::RenderContext() { glCreateVertexArrays(1, &m_DummyVAO); }
+        FrameProfiler::~FrameProfiler()
+        {
+            for (auto& frame : m_Frames)
+            {
+                if (!frame.queries.empty())
+                    glDeleteQueries(static_cast<GLsizei>(frame.queries.size()), frame.queries.data());
+            }
+        }
+
+        void FrameProfiler::setEnabled(bool enabled) { m_Enabled = enabled; }
+        bool FrameProfiler::isEnabled() const { return m_Enabled; }
+
+        void FrameProfiler::beginFrame()
+        {
+            // Written kNumFrames ago, the queries are long done unless the GPU is that far behind
+            auto& frame = getCurrentFrame();
+            if (frame.recorded)
+                resolve(frame);
+
+            m_InFrame = m_Enabled;
+            if (!m_Enabled)
+                return;
+
+            frame.index = m_FrameIndex;
+            frame.scopes.clear();
+            frame.cpuBegin = time::Clock::now();
+            glQueryCounter(getQuery(frame, 0), GL_TIMESTAMP);
+        }
+
+        void FrameProfiler::endFrame(const FrameCounters& counters, const StateChangeCounters& stateChanges)
+        {
+            if (m_InFrame)
+            {
+                assert(m_Depth == 0);
+
+                auto& frame = getCurrentFrame();
+                glQueryCounter(getQuery(frame, 1), GL_TIMESTAMP);
+                frame.cpuEnd       = time::Clock::now();
+                frame.counters     = counters;
+                frame.stateChanges = stateChanges;
+                frame.recorded     = true;
+            }
+            m_InFrame = false;
+            ++m_FrameIndex;
+        }
+
+        uint32_t FrameProfiler::beginScope(std::string_view name)
+        {
+            if (!m_InFrame)
+                return kNoScope;
+
+            auto&      frame = getCurrentFrame();
+            const auto id    = static_cast<uint32_t>(frame.scopes.size());
+            frame.scopes.push_back({.name = std::string {name}, .depth = m_Depth++, .cpuBegin = time::Clock::now()});
+            glQueryCounter(getQuery(frame, 2 + id * 2), GL_TIMESTAMP);
+            return id;
+        }
+
+        void FrameProfiler::endScope(uint32_t id)
+        {
+            if (id == kNoScope || !m_InFrame)
+                return;
+
+            auto& frame = getCurrentFrame();
+            glQueryCounter(getQuery(frame, 3 + id * 2), GL_TIMESTAMP);
+            frame.scopes[id].cpuEnd = time::Clock::now();
+            --m_Depth;
+        }
+
+        uint64_t FrameProfiler::getFrameIndex() const { return m_FrameIndex; }
+
+        const std::deque<FrameProfiler::Frame>& FrameProfiler::getHistory() const { return m_History; }
+
+        const FrameProfiler::Frame* FrameProfiler::getLastFrame() const
+        {
+            return m_History.empty() ? nullptr : &m_History.back();
+        }
+
+        void FrameProfiler::writeCSV(std::ostream& os) const
+        {
+            // RFC 4180: quoted, with embedded quotes doubled
+            const auto writeString = [&os](std::string_view string) {
+                os << '"';
+                for (const auto c : string)
+                {
+                    if (c == '"')
+                        os << '"';
+                    os << c;
+                }
+                os << '"';
+            };
+
+            os << "frame,scope,depth,cpu_ms,gpu_ms,draw_calls,dispatches,state_changes,redundant_state_changes,"
+                  "uploaded_bytes,transient_acquisitions,transient_allocations\n";
+            for (const auto& frame : m_History)
+            {
+                const auto& counters = frame.counters;
+                os << frame.index << ",Frame,0," << frame.cpuTime << ',' << frame.gpuTime << ','
+                   << counters.numDrawCalls << ',' << counters.numDispatches << ',' << frame.stateChanges.issued << ','
+                   << frame.stateChanges.skipped << ',' << counters.uploadedBytes << ','
+                   << counters.numTransientAcquisitions << ',' << counters.numTransientAllocations << '\n';
+
+                // Names are pass names, which may contain separators or quotes
+                for (const auto& scope : frame.scopes)
+                {
+                    os << frame.index << ',';
+                    writeString(scope.name);
+                    os << ',' << scope.depth + 1 << ',' << scope.cpuTime << ',' << scope.gpuTime << ",,,,,,,\n";
+                }
+            }
+        }
+
+        void FrameProfiler::writeJSON(std::ostream& os) const
+        {
+            const auto writeString = [&os](std::string_view string) {
+                os << '"';
+                for (const auto c : string)
+                {
+                    if (c == '"' || c == '\\')
+                        os << '\\';
+                    os << c;
+                }
+                os << '"';
+            };
+
+            os << "{\"frames\":[";
+            for (std::size_t f = 0; f < m_History.size(); ++f)
+            {
+                const auto& frame    = m_History[f];
+                const auto& counters = frame.counters;
+                os << (f > 0 ? "," : "") << "{\"index\":" << frame.index << ",\"cpuMs\":" << frame.cpuTime
+                   << ",\"gpuMs\":" << frame.gpuTime << ",\"drawCalls\":" << counters.numDrawCalls
+                   << ",\"dispatches\":" << counters.numDispatches << ",\"stateChanges\":" << frame.stateChanges.issued
+                   << ",\"redundantStateChanges\":" << frame.stateChanges.skipped
+                   << ",\"uploadedBytes\":" << counters.uploadedBytes
+                   << ",\"transientAcquisitions\":" << counters.numTransientAcquisitions
+                   << ",\"transientAllocations\":" << counters.numTransientAllocations << ",\"scopes\":[";
+                for (std::size_t s = 0; s < frame.scopes.size(); ++s)
+                {
+                    const auto& scope = frame.scopes[s];
+                    os << (s > 0 ? "," : "") << "{\"name\":";
+                    writeString(scope.name);
+                    os << ",\"depth\":" << scope.depth << ",\"cpuMs\":" << scope.cpuTime
+                       << ",\"gpuMs\":" << scope.gpuTime << '}';
+                }
+                os << "]}";
+            }
+            os << "]}\n";
+        }
+
+        FrameProfiler::PendingFrame& FrameProfiler::getCurrentFrame() { return m_Frames[m_FrameIndex % kNumFrames]; }
+
+        GLuint FrameProfiler::getQuery(PendingFrame& frame, uint32_t index)
+        {
+            // The pool grows to the most scopes a frame had, and is reused from then on
+            if (index >= frame.queries.size())
+            {
+                const auto numQueries = frame.queries.size();
+                frame.queries.resize(std::max<std::size_t>(index + 1, numQueries * 2));
+                glGenQueries(static_cast<GLsizei>(frame.queries.size() - numQueries), &frame.queries[numQueries]);
+            }
+            return frame.queries[index];
+        }
+
+        void FrameProfiler::resolve(PendingFrame& pending)
+        {
+            pending.recorded = false;
+
+            using Milliseconds = std::chrono::duration<float, std::milli>;
+
+            // The frame's end query was written last, the others are done when it is
+            GLint available {GL_FALSE};
+            glGetQueryObjectiv(pending.queries[1], GL_QUERY_RESULT_AVAILABLE, &available);
+
+            const auto getElapsed = [&](uint32_t beginQuery) {
+                if (!available)
+                    return -1.0f;
+
+                GLuint64 begin {0}, end {0};
+                glGetQueryObjectui64v(pending.queries[beginQuery], GL_QUERY_RESULT, &begin);
+                glGetQueryObjectui64v(pending.queries[beginQuery + 1], GL_QUERY_RESULT, &end);
+                return static_cast<float>(end - begin) * 1e-6f;
+            };
+
+            Frame frame {
+                .index        = pending.index,
+                .cpuTime      = Milliseconds {pending.cpuEnd - pending.cpuBegin}.count(),
+                .gpuTime      = getElapsed(0),
+                .counters     = pending.counters,
+                .stateChanges = pending.stateChanges,
+            };
+            frame.scopes.reserve(pending.scopes.size());
+            for (uint32_t i = 0; i < pending.scopes.size(); ++i)
+            {
+                auto& scope = pending.scopes[i];
+                frame.scopes.push_back({
+                    .name    = std::move(scope.name),
+                    .depth   = scope.depth,
+                    .cpuTime = Milliseconds {scope.cpuEnd - scope.cpuBegin}.count(),
+                    .gpuTime = getElapsed(2 + i * 2),
+                });
+            }
+
+            m_History.push_back(std::move(frame));
+            if (m_History.size() > kHistorySize)
+                m_History.pop_front();
+        }
+
+        ProfileScope::ProfileScope(FrameProfiler& profiler, std::string_view name) :
+            m_Profiler {profiler}, m_Id {profiler.beginScope(name)}
+        {}
+
+        ProfileScope::~ProfileScope() { m_Profiler.endScope(m_Id); }
+
+        RenderContext::RenderContext()
+        {
+            glCreateVertexArrays(1, &m_DummyVAO);
+            m_StagingRing.create(kStagingRingSize);
+            m_UniformRing.create(*this, kUniformRingFrameSize, kNumFramesInFlight);
+
+            // Image data is always tightly packed (stb, staging ring)
+            glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+
+            // Let the driver pick the number of compiler threads
+            if (GLAD_GL_KHR_parallel_shader_compile)
+                glMaxShaderCompilerThreadsKHR(0xFFFFFFFF);
+            else if (GLAD_GL_ARB_parallel_shader_compile)
+                glMaxShaderCompilerThreadsARB(0xFFFFFFFF);
+        }
 
         RenderContext::~RenderContext()
         {
+            // Its overflow buffers are destroyed through this context, while the binding shadows are still around
+            m_UniformRing.destroy();
+
             glDeleteVertexArrays(1, &m_DummyVAO);
             for (auto [_, vao] : m_VertexArrays)
                 glDeleteVertexArrays(1, &vao);
+            for (const auto& [_, framebuffer] : m_Framebuffers)
+                glDeleteFramebuffers(1, &framebuffer);
 
             m_CurrentPipeline = {};
         }
 
+        const StateChangeCounters& RenderContext::getStateChangeCounters() const { return m_StateChangeCounters; }
+
+        RenderContext& RenderContext::resetStateChangeCounters()
+        {
+            m_StateChangeCounters = {};
+            return *this;
+        }
+
+        const FrameCounters& RenderContext::getFrameCounters() const { return m_FrameCounters; }
+
+        RenderContext& RenderContext::countTransientAcquisition(bool allocated)
+        {
+            ++m_FrameCounters.numTransientAcquisitions;
+            if (allocated)
+                ++m_FrameCounters.numTransientAllocations;
+            return *this;
+        }
+
+        FrameProfiler& RenderContext::getProfiler() { return m_Profiler; }
+
+        RenderContext& RenderContext::beginFrame()
+        {
+            resetStateChangeCounters();
+            m_FrameCounters = {};
+            m_Profiler.beginFrame();
+            m_UniformRing.beginFrame();
+            return *this;
+        }
+
+        RenderContext& RenderContext::endFrame()
+        {
+            m_Profiler.endFrame(m_FrameCounters, m_StateChangeCounters);
+            m_UniformRing.endFrame();
+            m_StagingRing.fence();
+            m_StagingRing.reclaim(false);
+            return *this;
+        }
+
+        StagingRing& RenderContext::getStagingRing() { return m_StagingRing; }
+
+        UniformAllocation RenderContext::allocateUniform(GLsizeiptr size) { return m_UniformRing.allocate(size); }
+
+        std::optional<GLintptr> RenderContext::stage(const void* data, GLsizeiptr size)
+        {
+            // Already filled in place (e.g. by a worker thread)
+            if (m_StagingRing.contains(data))
+                return m_StagingRing.getOffset(data);
+            if (size <= 0 || size > m_StagingRing.getCapacity())
+                return std::nullopt;
+
+            auto allocation = m_StagingRing.allocate(size);
+            // Only wait on fences of previous frames, regions of this frame may still be written to
+            if (!allocation && m_StagingRing.reclaim(true))
+                allocation = m_StagingRing.allocate(size);
+            if (!allocation)
+                return std::nullopt;
+
+            memcpy(allocation.data, data, size);
+            return allocation.offset;
+        }
+
         RenderContext& RenderContext::setViewport(const Rect2D& rect)
         {
             auto& current = m_CurrentPipeline.m_Viewport;
-            if (rect != current)
+            if (trackStateChange(rect != current))
             {
                 glViewport(rect.offset.x, rect.offset.y, rect.extent.width, rect.extent.height);
                 current = rect;
@@ -1977,7 +4771,7 @@ namespace vgfw
         RenderContext& RenderContext::setScissor(const Rect2D& rect)
         {
             auto& current = m_CurrentPipeline.m_Scissor;
-            if (rect != current)
+            if (trackStateChange(rect != current))
             {
                 glScissor(rect.offset.x, rect.offset.y, rect.extent.width, rect.extent.height);
                 current = rect;
@@ -1985,11 +4779,11 @@ namespace vgfw
             return *this;
         }
 
-        Buffer RenderContext::createBuffer(GLsizeiptr size, const void* data)
+        Buffer RenderContext::createBuffer(GLsizeiptr size, const void* data, GLbitfield flags)
         {
             GLuint buffer;
             glCreateBuffers(1, &buffer);
-            glNamedBufferStorage(buffer, size, data, GL_DYNAMIC_STORAGE_BIT);
+            glNamedBufferStorage(buffer, size, data, flags);
 
             return {buffer, size};
         }
@@ -2027,20 +4821,58 @@ namespace vgfw
                                                     const std::string&                fragSource,
                                                     const std::optional<std::string>& geomSource)
         {
-            return createShaderProgram({
-                createShaderObject(GL_VERTEX_SHADER, vertSource),
-                geomSource ? createShaderObject(GL_GEOMETRY_SHADER, *geomSource) : GL_NONE,
-                createShaderObject(GL_FRAGMENT_SHADER, fragSource),
-            });
+            return createGraphicsProgramAsync(vertSource, fragSource, geomSource).get();
         }
 
         GLuint RenderContext::createComputeProgram(const std::string& compSource)
         {
-            return createShaderProgram({
-                createShaderObject(GL_COMPUTE_SHADER, compSource),
+            return createComputeProgramAsync(compSource).get();
+        }
+
+        ProgramHandle RenderContext::createGraphicsProgramAsync(const std::string&                vertSource,
+                                                                const std::string&                fragSource,
+                                                                const std::optional<std::string>& geomSource)
+        {
+            return submitProgram({
+                {GL_VERTEX_SHADER, vertSource},
+                {GL_GEOMETRY_SHADER, geomSource ? std::string_view {*geomSource} : std::string_view {}},
+                {GL_FRAGMENT_SHADER, fragSource},
             });
         }
 
+        ProgramHandle RenderContext::createComputeProgramAsync(const std::string& compSource)
+        {
+            return submitProgram({{GL_COMPUTE_SHADER, compSource}});
+        }
+
+        void RenderContext::setProgramCacheDirectory(const std::filesystem::path& directory)
+        {
+            s_ProgramCacheDirectory.clear();
+            if (directory.empty())
+                return;
+
+            GLint numFormats {0};
+            glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &numFormats);
+            if (numFormats == 0)
+            {
+                VGFW_WARN("[RenderContext] Driver exposes no program binary formats, program cache disabled");
+                return;
+            }
+
+            std::error_code ec;
+            std::filesystem::create_directories(directory, ec);
+            if (ec)
+            {
+                VGFW_WARN("[RenderContext] Could not create program cache directory {0}: {1}",
+                          directory.string(),
+                          ec.message());
+                return;
+            }
+
+            s_ProgramCacheDirectory = directory;
+            VGFW_TRACE("[RenderContext] Program cache directory: {0}", directory.string());
+        }
+
         Texture RenderContext::createTexture2D(Extent2D    extent,
                                                PixelFormat pixelFormat,
                                                uint32_t    numMipLevels,
@@ -2070,6 +4902,36 @@ namespace vgfw
             return createImmutableTexture({size, size}, 0, pixelFormat, 6, numMipLevels, numLayers);
         }
 
+        Texture RenderContext::createTextureView(const Texture& texture, PixelFormat pixelFormat)
+        {
+            assert(texture && pixelFormat != PixelFormat::eUnknown);
+
+            // Cube faces count as layers of a view
+            auto numLayers = std::max(texture.m_NumLayers, 1u);
+            if (texture.m_Type == GL_TEXTURE_CUBE_MAP || texture.m_Type == GL_TEXTURE_CUBE_MAP_ARRAY)
+                numLayers *= 6;
+
+            // A view needs a name that has never been bound, glCreateTextures would give it a target
+            GLuint id {GL_NONE};
+            glGenTextures(1, &id);
+            glTextureView(id,
+                          texture.m_Type,
+                          texture.m_Id,
+                          static_cast<GLenum>(pixelFormat),
+                          0,
+                          texture.m_NumMipLevels,
+                          0,
+                          numLayers);
+
+            return Texture {id,
+                            texture.m_Type,
+                            pixelFormat,
+                            texture.m_Extent,
+                            texture.m_Depth,
+                            texture.m_NumMipLevels,
+                            texture.m_NumLayers};
+        }
+
         RenderContext& RenderContext::generateMipmaps(Texture& texture)
         {
             assert(texture);
@@ -2137,21 +4999,136 @@ namespace vgfw
             return *this;
         }
 
-        RenderContext&
-        RenderContext::upload(Texture& texture, GLint mipLevel, glm::uvec2 dimensions, const ImageData& image)
+        // @return Bytes read by glTextureSubImage* for the given region, 0 if unknown
+        static GLsizeiptr
+        getImageDataSize(const Texture& texture, const glm::uvec3& dimensions, GLsizei layer, const ImageData& image)
         {
-            return upload(texture, mipLevel, {dimensions, 0}, 0, 0, image);
-        }
-
-        RenderContext& RenderContext::upload(Texture&         texture,
-                                             GLint            mipLevel,
-                                             GLint            face,
-                                             glm::uvec2       dimensions,
+            GLsizeiptr numComponents {0};
+            switch (image.format)
+            {
+                case GL_RED:
+                case GL_GREEN:
+                case GL_BLUE:
+                case GL_RED_INTEGER:
+                case GL_DEPTH_COMPONENT:
+                case GL_STENCIL_INDEX:
+                    numComponents = 1;
+                    break;
+                case GL_RG:
+                case GL_RG_INTEGER:
+                case GL_DEPTH_STENCIL:
+                    numComponents = 2;
+                    break;
+                case GL_RGB:
+                case GL_BGR:
+                case GL_RGB_INTEGER:
+                    numComponents = 3;
+                    break;
+                case GL_RGBA:
+                case GL_BGRA:
+                case GL_RGBA_INTEGER:
+                    numComponents = 4;
+                    break;
+            }
+
+            GLsizeiptr pixelSize {0};
+            switch (image.dataType)
+            {
+                case GL_BYTE:
+                case GL_UNSIGNED_BYTE:
+                    pixelSize = numComponents;
+                    break;
+                case GL_SHORT:
+                case GL_UNSIGNED_SHORT:
+                case GL_HALF_FLOAT:
+                    pixelSize = numComponents * 2;
+                    break;
+                case GL_INT:
+                case GL_UNSIGNED_INT:
+                case GL_FLOAT:
+                    pixelSize = numComponents * 4;
+                    break;
+                // Packed, the whole pixel in one value
+                case GL_UNSIGNED_INT_24_8:
+                case GL_UNSIGNED_INT_2_10_10_10_REV:
+                case GL_UNSIGNED_INT_10F_11F_11F_REV:
+                    pixelSize = 4;
+                    break;
+            }
+
+            // Mirrors the regions in upload() below
+            GLsizeiptr height {1}, depth {1};
+            switch (texture.getType())
+            {
+                case GL_TEXTURE_1D_ARRAY:
+                    height = layer;
+                    break;
+                case GL_TEXTURE_2D:
+                case GL_TEXTURE_2D_ARRAY:
+                case GL_TEXTURE_CUBE_MAP:
+                    height = dimensions.y;
+                    break;
+                case GL_TEXTURE_3D:
+                    height = dimensions.y;
+                    depth  = dimensions.z;
+                    break;
+                case GL_TEXTURE_CUBE_MAP_ARRAY:
+                    height = dimensions.y;
+                    depth  = 6 * texture.getNumLayers();
+                    break;
+            }
+
+            return pixelSize * dimensions.x * height * depth;
+        }
+
+        RenderContext&
+        RenderContext::upload(Texture& texture, GLint mipLevel, glm::uvec2 dimensions, const ImageData& image)
+        {
+            return upload(texture, mipLevel, {dimensions, 0}, 0, 0, image);
+        }
+
+        RenderContext& RenderContext::upload(Texture&         texture,
+                                             GLint            mipLevel,
+                                             GLint            face,
+                                             glm::uvec2       dimensions,
                                              const ImageData& image)
         {
             return upload(texture, mipLevel, {dimensions, 0}, face, 0, image);
         }
 
+        RenderContext& RenderContext::upload(Texture&                   texture,
+                                             GLint                      mipLevel,
+                                             glm::uvec2                 dimensions,
+                                             const CompressedImageData& image)
+        {
+            assert(texture && texture.m_Type == GL_TEXTURE_2D && isCompressed(texture.m_PixelFormat));
+            assert(image.data != nullptr && image.size >= calcCompressedSize(texture.m_PixelFormat, dimensions));
+
+            const void* data {image.data};
+            const auto  stagingOffset = stage(image.data, image.size);
+            m_FrameCounters.uploadedBytes += image.size;
+            if (stagingOffset.has_value())
+            {
+                glBindBuffer(GL_PIXEL_UNPACK_BUFFER, m_StagingRing.getId());
+                data = reinterpret_cast<const void*>(*stagingOffset);
+            }
+
+            glCompressedTextureSubImage2D(texture.m_Id,
+                                          mipLevel,
+                                          0,
+                                          0,
+                                          dimensions.x,
+                                          dimensions.y,
+                                          static_cast<GLenum>(texture.m_PixelFormat),
+                                          image.size,
+                                          data);
+
+            if (stagingOffset.has_value())
+                glBindBuffer(GL_PIXEL_UNPACK_BUFFER, GL_NONE);
+
+            return *this;
+        }
+
         RenderContext& RenderContext::upload(Texture&          texture,
                                              GLint             mipLevel,
                                              const glm::uvec3& dimensions,
@@ -2161,15 +5138,25 @@ namespace vgfw
         {
             assert(texture && image.pixels != nullptr);
 
+            // Pixels go through the staging ring (as a pixel unpack buffer offset) when it has room
+            const void* pixels {image.pixels};
+            const auto  size          = getImageDataSize(texture, dimensions, layer, image);
+            const auto  stagingOffset = stage(image.pixels, size);
+            m_FrameCounters.uploadedBytes += size;
+            if (stagingOffset.has_value())
+            {
+                glBindBuffer(GL_PIXEL_UNPACK_BUFFER, m_StagingRing.getId());
+                pixels = reinterpret_cast<const void*>(*stagingOffset);
+            }
+
             switch (texture.m_Type)
             {
                 case GL_TEXTURE_1D:
-                    glTextureSubImage1D(
-                        texture.m_Id, mipLevel, 0, dimensions.x, image.format, image.dataType, image.pixels);
+                    glTextureSubImage1D(texture.m_Id, mipLevel, 0, dimensions.x, image.format, image.dataType, pixels);
                     break;
                 case GL_TEXTURE_1D_ARRAY:
                     glTextureSubImage2D(
-                        texture.m_Id, mipLevel, 0, 0, dimensions.x, layer, image.format, image.dataType, image.pixels);
+                        texture.m_Id, mipLevel, 0, 0, dimensions.x, layer, image.format, image.dataType, pixels);
                     break;
                 case GL_TEXTURE_2D:
                     glTextureSubImage2D(texture.m_Id,
@@ -2180,7 +5167,7 @@ namespace vgfw
                                         dimensions.y,
                                         image.format,
                                         image.dataType,
-                                        image.pixels);
+                                        pixels);
                     break;
                 case GL_TEXTURE_2D_ARRAY:
                     glTextureSubImage3D(texture.m_Id,
@@ -2193,7 +5180,7 @@ namespace vgfw
                                         1,
                                         image.format,
                                         image.dataType,
-                                        image.pixels);
+                                        pixels);
                     break;
                 case GL_TEXTURE_3D:
                     glTextureSubImage3D(texture.m_Id,
@@ -2206,7 +5193,7 @@ namespace vgfw
                                         dimensions.z,
                                         image.format,
                                         image.dataType,
-                                        image.pixels);
+                                        pixels);
                     break;
                 case GL_TEXTURE_CUBE_MAP:
                     glTextureSubImage3D(texture.m_Id,
@@ -2219,7 +5206,7 @@ namespace vgfw
                                         1,
                                         image.format,
                                         image.dataType,
-                                        image.pixels);
+                                        pixels);
                     break;
                 case GL_TEXTURE_CUBE_MAP_ARRAY: {
                     const auto zoffset = (layer * 6) + face; // desired layer-face
@@ -2234,13 +5221,17 @@ namespace vgfw
                                         6 * texture.m_NumLayers,
                                         image.format,
                                         image.dataType,
-                                        image.pixels);
+                                        pixels);
                 }
                 break;
 
                 default:
                     assert(false);
             }
+
+            if (stagingOffset.has_value())
+                glBindBuffer(GL_PIXEL_UNPACK_BUFFER, GL_NONE);
+
             return *this;
         }
 
@@ -2259,7 +5250,13 @@ namespace vgfw
             assert(buffer);
 
             if (size > 0 && data != nullptr)
-                glNamedBufferSubData(buffer.m_Id, offset, size, data);
+            {
+                m_FrameCounters.uploadedBytes += size;
+                if (const auto stagingOffset = stage(data, size); stagingOffset.has_value())
+                    glCopyNamedBufferSubData(m_StagingRing.getId(), buffer.m_Id, *stagingOffset, offset, size);
+                else
+                    glNamedBufferSubData(buffer.m_Id, offset, size, data);
+            }
 
             return *this;
         }
@@ -2291,6 +5288,7 @@ namespace vgfw
         {
             if (buffer)
             {
+                forgetBuffer(buffer.m_Id);
                 glDeleteBuffers(1, &buffer.m_Id);
                 buffer = {};
             }
@@ -2302,9 +5300,9 @@ namespace vgfw
         {
             if (texture)
             {
+                releaseFramebuffers(texture.m_Id);
+                forgetTexture(texture.m_Id);
                 glDeleteTextures(1, &texture.m_Id);
-                if (texture.m_View != GL_NONE)
-                    glDeleteTextures(1, &texture.m_View);
                 texture = {};
             }
             return *this;
@@ -2312,13 +5310,53 @@ namespace vgfw
 
         RenderContext& RenderContext::destroy(GraphicsPipeline& gp)
         {
-            if (gp.m_Program != GL_NONE)
+            // Not through getProgram, which waits for a pending program and throws if it failed to build
+            destroyProgram(gp.m_Program);
+            gp.m_Program = GL_NONE;
+            if (gp.m_PendingProgram)
+                destroy(gp.m_PendingProgram);
+            gp.m_VAO = GL_NONE;
+
+            return *this;
+        }
+
+        RenderContext& RenderContext::destroy(ProgramHandle& program)
+        {
+            if (!program)
+                return *this;
+
+            auto& state = *program.m_State;
+            if (state.linked)
             {
-                glDeleteProgram(gp.m_Program);
-                gp.m_Program = GL_NONE;
+                destroyProgram(state.program);
             }
-            gp.m_VAO = GL_NONE;
+            else if (state.program != GL_NONE)
+            {
+                for (auto shader : state.shaders)
+                    glDeleteShader(shader);
+                glDeleteProgram(state.program);
+            }
+            // Pipelines built from it may still share the state
+            state   = {.released = true};
+            program = {};
+
+            return *this;
+        }
+
+        RenderContext& RenderContext::destroyProgram(GLuint program)
+        {
+            if (program != GL_NONE)
+            {
+                // The name may be recycled by the next program
+                if (m_CurrentPipeline.m_Program == program)
+                {
+                    m_CurrentPipeline.m_Program = GL_NONE;
+                    m_CurrentUniforms           = nullptr;
+                }
+                s_UniformTables.erase(program);
 
+                glDeleteProgram(program);
+            }
             return *this;
         }
 
@@ -2326,7 +5364,14 @@ namespace vgfw
         {
             setShaderProgram(computeProgram);
             glDispatchCompute(numGroups.x, numGroups.y, numGroups.z);
+            ++m_FrameCounters.numDispatches;
+
+            return *this;
+        }
 
+        RenderContext& RenderContext::memoryBarrier(GLbitfield barriers)
+        {
+            glMemoryBarrier(barriers);
             return *this;
         }
 
@@ -2334,26 +5379,7 @@ namespace vgfw
         {
             assert(!m_RenderingStarted);
 
-            GLuint framebuffer;
-            glCreateFramebuffers(1, &framebuffer);
-            if (renderingInfo.depthAttachment.has_value())
-            {
-                attachTexture(framebuffer, GL_DEPTH_ATTACHMENT, *renderingInfo.depthAttachment);
-            }
-            for (size_t i {0}; i < renderingInfo.colorAttachments.size(); ++i)
-            {
-                attachTexture(framebuffer, GL_COLOR_ATTACHMENT0 + i, renderingInfo.colorAttachments[i]);
-            }
-            if (const auto n = renderingInfo.colorAttachments.size(); n > 0)
-            {
-                std::vector<GLenum> colorBuffers(n);
-                std::iota(colorBuffers.begin(), colorBuffers.end(), GL_COLOR_ATTACHMENT0);
-                glNamedFramebufferDrawBuffers(framebuffer, colorBuffers.size(), colorBuffers.data());
-            }
-#ifdef _DEBUG
-            const auto status = glCheckNamedFramebufferStatus(framebuffer, GL_DRAW_FRAMEBUFFER);
-            assert(GL_FRAMEBUFFER_COMPLETE == status);
-#endif
+            const auto framebuffer = getFramebuffer(renderingInfo);
 
             glBindFramebuffer(GL_DRAW_FRAMEBUFFER, framebuffer);
             setViewport(renderingInfo.area);
@@ -2410,7 +5436,8 @@ namespace vgfw
         {
             assert(m_RenderingStarted && frameBufferID != GL_NONE);
 
-            glDeleteFramebuffers(1, &frameBufferID);
+            // The framebuffer is owned by the cache, so just unbind it
+            glBindFramebuffer(GL_DRAW_FRAMEBUFFER, GL_NONE);
             m_RenderingStarted = false;
 
             return *this;
@@ -2418,12 +5445,16 @@ namespace vgfw
 
         RenderContext& RenderContext::bindGraphicsPipeline(const GraphicsPipeline& gp)
         {
+            // Compare whole state groups first, rebinding the same pipeline is the common case. Only the setters count
+            // state changes, a group holds several of them.
+            if (gp.m_DepthStencilState != m_CurrentPipeline.m_DepthStencilState)
             {
                 const auto& state = gp.m_DepthStencilState;
                 setDepthTest(state.depthTest, state.depthCompareOp);
                 setDepthWrite(state.depthWrite);
             }
 
+            if (gp.m_RasterizerState != m_CurrentPipeline.m_RasterizerState)
             {
                 const auto& state = gp.m_RasterizerState;
                 setPolygonMode(state.polygonMode);
@@ -2433,75 +5464,128 @@ namespace vgfw
                 setScissorTest(state.scissorTest);
             }
 
-            for (int32_t i {0}; i < gp.m_BlendStates.size(); ++i)
-                setBlendState(i, gp.m_BlendStates[i]);
+            if (gp.m_BlendStates != m_CurrentPipeline.m_BlendStates)
+            {
+                for (int32_t i {0}; i < gp.m_BlendStates.size(); ++i)
+                    setBlendState(i, gp.m_BlendStates[i]);
+            }
 
             setVertexArray(gp.m_VAO);
-            setShaderProgram(gp.m_Program);
+            setShaderProgram(gp.getProgram());
 
             return *this;
         }
 
-        RenderContext& RenderContext::setUniform1f(const std::string& name, float f)
+        UniformHandle RenderContext::getUniform(GLuint program, std::string_view name)
+        {
+            if (const auto it = s_UniformTables.find(program); it != s_UniformTables.cend())
+                return it->second.find(name);
+            return {};
+        }
+
+        RenderContext& RenderContext::setUniform1f(std::string_view name, float f)
+        {
+            return setUniform1f(findUniform(name), f);
+        }
+
+        RenderContext& RenderContext::setUniform1i(std::string_view name, int32_t i)
+        {
+            return setUniform1i(findUniform(name), i);
+        }
+
+        RenderContext& RenderContext::setUniform1ui(std::string_view name, uint32_t i)
         {
-            const auto location = glGetUniformLocation(m_CurrentPipeline.m_Program, name.data());
-            if (location != GL_INVALID_INDEX)
-                glProgramUniform1f(m_CurrentPipeline.m_Program, location, f);
+            return setUniform1ui(findUniform(name), i);
+        }
+
+        RenderContext& RenderContext::setUniformVec3(std::string_view name, const glm::vec3& v)
+        {
+            return setUniformVec3(findUniform(name), v);
+        }
+
+        RenderContext& RenderContext::setUniformVec4(std::string_view name, const glm::vec4& v)
+        {
+            return setUniformVec4(findUniform(name), v);
+        }
+
+        RenderContext& RenderContext::setUniformMat3(std::string_view name, const glm::mat3& m)
+        {
+            return setUniformMat3(findUniform(name), m);
+        }
+
+        RenderContext& RenderContext::setUniformMat4(std::string_view name, const glm::mat4& m)
+        {
+            return setUniformMat4(findUniform(name), m);
+        }
+
+        RenderContext& RenderContext::setUniform1f(UniformHandle uniform, float f)
+        {
+            if (uniform)
+            {
+                assert(uniform.program == m_CurrentPipeline.m_Program);
+                glProgramUniform1f(m_CurrentPipeline.m_Program, uniform.location, f);
+            }
             return *this;
         }
 
-        RenderContext& RenderContext::setUniform1i(const std::string& name, int32_t i)
+        RenderContext& RenderContext::setUniform1i(UniformHandle uniform, int32_t i)
         {
-            const auto location = glGetUniformLocation(m_CurrentPipeline.m_Program, name.data());
-            if (location != GL_INVALID_INDEX)
-                glProgramUniform1i(m_CurrentPipeline.m_Program, location, i);
+            if (uniform)
+            {
+                assert(uniform.program == m_CurrentPipeline.m_Program);
+                glProgramUniform1i(m_CurrentPipeline.m_Program, uniform.location, i);
+            }
             return *this;
         }
 
-        RenderContext& RenderContext::setUniform1ui(const std::string& name, uint32_t i)
+        RenderContext& RenderContext::setUniform1ui(UniformHandle uniform, uint32_t i)
         {
-            const auto location = glGetUniformLocation(m_CurrentPipeline.m_Program, name.data());
-            if (location != GL_INVALID_INDEX)
-                glProgramUniform1ui(m_CurrentPipeline.m_Program, location, i);
+            if (uniform)
+            {
+                assert(uniform.program == m_CurrentPipeline.m_Program);
+                glProgramUniform1ui(m_CurrentPipeline.m_Program, uniform.location, i);
+            }
             return *this;
         }
 
-        RenderContext& RenderContext::setUniformVec3(const std::string& name, const glm::vec3& v)
+        RenderContext& RenderContext::setUniformVec3(UniformHandle uniform, const glm::vec3& v)
         {
-            const auto location = glGetUniformLocation(m_CurrentPipeline.m_Program, name.data());
-            if (location != GL_INVALID_INDEX)
+            if (uniform)
             {
-                glProgramUniform3fv(m_CurrentPipeline.m_Program, location, 1, glm::value_ptr(v));
+                assert(uniform.program == m_CurrentPipeline.m_Program);
+                glProgramUniform3fv(m_CurrentPipeline.m_Program, uniform.location, 1, glm::value_ptr(v));
             }
             return *this;
         }
 
-        RenderContext& RenderContext::setUniformVec4(const std::string& name, const glm::vec4& v)
+        RenderContext& RenderContext::setUniformVec4(UniformHandle uniform, const glm::vec4& v)
         {
-            const auto location = glGetUniformLocation(m_CurrentPipeline.m_Program, name.data());
-            if (location != GL_INVALID_INDEX)
+            if (uniform)
             {
-                glProgramUniform4fv(m_CurrentPipeline.m_Program, location, 1, glm::value_ptr(v));
+                assert(uniform.program == m_CurrentPipeline.m_Program);
+                glProgramUniform4fv(m_CurrentPipeline.m_Program, uniform.location, 1, glm::value_ptr(v));
             }
             return *this;
         }
 
-        RenderContext& RenderContext::setUniformMat3(const std::string& name, const glm::mat3& m)
+        RenderContext& RenderContext::setUniformMat3(UniformHandle uniform, const glm::mat3& m)
         {
-            const auto location = glGetUniformLocation(m_CurrentPipeline.m_Program, name.data());
-            if (location != GL_INVALID_INDEX)
+            if (uniform)
             {
-                glProgramUniformMatrix3fv(m_CurrentPipeline.m_Program, location, 1, GL_FALSE, glm::value_ptr(m));
+                assert(uniform.program == m_CurrentPipeline.m_Program);
+                glProgramUniformMatrix3fv(
+                    m_CurrentPipeline.m_Program, uniform.location, 1, GL_FALSE, glm::value_ptr(m));
             }
             return *this;
         }
 
-        RenderContext& RenderContext::setUniformMat4(const std::string& name, const glm::mat4& m)
+        RenderContext& RenderContext::setUniformMat4(UniformHandle uniform, const glm::mat4& m)
         {
-            const auto location = glGetUniformLocation(m_CurrentPipeline.m_Program, name.data());
-            if (location != GL_INVALID_INDEX)
+            if (uniform)
             {
-                glProgramUniformMatrix4fv(m_CurrentPipeline.m_Program, location, 1, GL_FALSE, glm::value_ptr(m));
+                assert(uniform.program == m_CurrentPipeline.m_Program);
+                glProgramUniformMatrix4fv(
+                    m_CurrentPipeline.m_Program, uniform.location, 1, GL_FALSE, glm::value_ptr(m));
             }
             return *this;
         }
@@ -2517,30 +5601,90 @@ namespace vgfw
         RenderContext& RenderContext::bindTexture(GLuint unit, const Texture& texture, std::optional<GLuint> samplerId)
         {
             assert(texture);
-            glBindTextureUnit(unit, texture.m_Id);
-            if (samplerId.has_value())
+
+            if (unit >= m_TextureUnits.size())
+                m_TextureUnits.resize(unit + 1);
+            auto& current = m_TextureUnits[unit];
+
+            if (trackStateChange(texture.m_Id != current.texture))
+            {
+                glBindTextureUnit(unit, texture.m_Id);
+                current.texture = texture.m_Id;
+            }
+            if (samplerId.has_value() && trackStateChange(*samplerId != current.sampler))
+            {
                 glBindSampler(unit, *samplerId);
+                current.sampler = *samplerId;
+            }
             return *this;
         }
 
         RenderContext& RenderContext::bindUniformBuffer(GLuint index, const UniformBuffer& buffer)
         {
             assert(buffer);
-            glBindBufferBase(GL_UNIFORM_BUFFER, index, buffer.m_Id);
+
+            if (index >= m_UniformBufferBindings.size())
+                m_UniformBufferBindings.resize(index + 1);
+            auto& current = m_UniformBufferBindings[index];
+
+            if (const BufferBinding binding {.buffer = buffer.m_Id};
+                trackStateChange(binding.buffer != current.buffer || current.size != 0))
+            {
+                glBindBufferBase(GL_UNIFORM_BUFFER, index, buffer.m_Id);
+                current = binding;
+            }
+            return *this;
+        }
+
+        RenderContext&
+        RenderContext::bindUniformBuffer(GLuint index, const UniformBuffer& buffer, GLintptr offset, GLsizeiptr size)
+        {
+            assert(buffer && size > 0);
+
+            if (index >= m_UniformBufferBindings.size())
+                m_UniformBufferBindings.resize(index + 1);
+            auto& current = m_UniformBufferBindings[index];
+
+            if (const BufferBinding binding {.buffer = buffer.m_Id, .offset = offset, .size = size};
+                trackStateChange(binding.buffer != current.buffer || binding.offset != current.offset ||
+                                 binding.size != current.size))
+            {
+                glBindBufferRange(GL_UNIFORM_BUFFER, index, buffer.m_Id, offset, size);
+                current = binding;
+            }
             return *this;
         }
 
+        RenderContext& RenderContext::bindUniformBuffer(GLuint index, const UniformAllocation& allocation)
+        {
+            assert(allocation);
+            return bindUniformBuffer(index, *allocation.buffer, allocation.offset, allocation.size);
+        }
+
         RenderContext& RenderContext::bindStorageBuffer(GLuint index, const StorageBuffer& buffer)
         {
             assert(buffer);
-            glBindBufferBase(GL_SHADER_STORAGE_BUFFER, index, buffer.m_Id);
+
+            if (index >= m_StorageBufferBindings.size())
+                m_StorageBufferBindings.resize(index + 1);
+            auto& current = m_StorageBufferBindings[index];
+
+            if (const BufferBinding binding {.buffer = buffer.m_Id};
+                trackStateChange(binding.buffer != current.buffer || current.size != 0))
+            {
+                glBindBufferBase(GL_SHADER_STORAGE_BUFFER, index, buffer.m_Id);
+                current = binding;
+            }
             return *this;
         }
 
         RenderContext& RenderContext::bindMeshPrimitiveMaterialBuffer(GLuint                         index,
                                                                       const resource::MeshPrimitive& meshPrimitive)
         {
-            return bindUniformBuffer(index, *meshPrimitive.materialBuffer);
+            return bindUniformBuffer(index,
+                                     *meshPrimitive.materialBuffer,
+                                     meshPrimitive.materialOffset,
+                                     sizeof(resource::PrimitiveMaterial));
         }
 
         RenderContext& RenderContext::bindMeshPrimitiveTextures(GLuint                         startUnit,
@@ -2560,9 +5704,12 @@ namespace vgfw
                                            OptionalReference<const IndexBuffer>  indexBuffer,
                                            uint32_t                              numIndices,
                                            uint32_t                              numVertices,
-                                           uint32_t                              numInstances)
+                                           uint32_t                              numInstances,
+                                           uint32_t                              firstIndex,
+                                           int32_t                               baseVertex)
         {
             VGFW_PROFILE_FUNCTION
+            ++m_FrameCounters.numDrawCalls;
             if (vertexBuffer.has_value())
                 setVertexBuffer(*vertexBuffer);
 
@@ -2570,7 +5717,14 @@ namespace vgfw
             {
                 assert(indexBuffer.has_value());
                 setIndexBuffer(*indexBuffer);
-                glDrawElementsInstanced(GL_TRIANGLES, numIndices, GL_UNSIGNED_INT, nullptr, numInstances);
+
+                const auto indexSize = static_cast<GLsizei>(indexBuffer->get().getIndexType());
+                glDrawElementsInstancedBaseVertex(GL_TRIANGLES,
+                                                  numIndices,
+                                                  getIndexDataType(indexSize),
+                                                  reinterpret_cast<const void*>(GLintptr {firstIndex} * indexSize),
+                                                  numInstances,
+                                                  baseVertex);
             }
             else
             {
@@ -2579,25 +5733,166 @@ namespace vgfw
             return *this;
         }
 
-        RenderContext& RenderContext::drawMeshPrimitive(const resource::MeshPrimitive& meshPrimitive)
+        RenderContext& RenderContext::drawMeshPrimitive(const resource::MeshPrimitive& meshPrimitive,
+                                                        uint32_t                       lod,
+                                                        uint32_t                       numInstances)
         {
             VGFW_PROFILE_FUNCTION
-            meshPrimitive.draw(*this);
+            meshPrimitive.draw(*this, numInstances, lod);
+            return *this;
+        }
+
+        RenderContext& RenderContext::drawMeshPrimitiveInstanced(const resource::MeshPrimitive& meshPrimitive,
+                                                                 const VertexBuffer&            instanceBuffer,
+                                                                 uint32_t                       numInstances)
+        {
+            VGFW_PROFILE_FUNCTION
+            assert(numInstances <= instanceBuffer.getCapacity());
+            setInstanceBuffer(instanceBuffer);
+            meshPrimitive.draw(*this, numInstances);
+            return *this;
+        }
+
+        RenderContext& RenderContext::drawIndirect(OptionalReference<const VertexBuffer> vertexBuffer,
+                                                   OptionalReference<const IndexBuffer>  indexBuffer,
+                                                   const Buffer&                         commandBuffer,
+                                                   GLintptr                              offset)
+        {
+            VGFW_PROFILE_FUNCTION
+            ++m_FrameCounters.numDrawCalls;
+            if (vertexBuffer.has_value())
+                setVertexBuffer(*vertexBuffer);
+            setDrawIndirectBuffer(commandBuffer);
+
+            if (indexBuffer.has_value())
+            {
+                setIndexBuffer(*indexBuffer);
+                glDrawElementsIndirect(GL_TRIANGLES,
+                                       getIndexDataType(static_cast<GLsizei>(indexBuffer->get().getIndexType())),
+                                       reinterpret_cast<const void*>(offset));
+            }
+            else
+            {
+                glDrawArraysIndirect(GL_TRIANGLES, reinterpret_cast<const void*>(offset));
+            }
+            return *this;
+        }
+
+        RenderContext& RenderContext::multiDrawElementsIndirect(const VertexBuffer& vertexBuffer,
+                                                                const IndexBuffer&  indexBuffer,
+                                                                const Buffer&       commandBuffer,
+                                                                uint32_t            numDraws,
+                                                                GLintptr            offset)
+        {
+            VGFW_PROFILE_FUNCTION
+            ++m_FrameCounters.numDrawCalls;
+            assert(offset + GLsizeiptr {numDraws} * sizeof(DrawElementsIndirectCommand) <= commandBuffer.getSize());
+
+            setVertexBuffer(vertexBuffer);
+            setIndexBuffer(indexBuffer);
+            setDrawIndirectBuffer(commandBuffer);
+
+            glMultiDrawElementsIndirect(GL_TRIANGLES,
+                                        getIndexDataType(static_cast<GLsizei>(indexBuffer.getIndexType())),
+                                        reinterpret_cast<const void*>(offset),
+                                        numDraws,
+                                        0);
+            return *this;
+        }
+
+        RenderContext& RenderContext::multiDrawElementsIndirectCount(const VertexBuffer& vertexBuffer,
+                                                                     const IndexBuffer&  indexBuffer,
+                                                                     const Buffer&       commandBuffer,
+                                                                     const Buffer&       countBuffer,
+                                                                     uint32_t            maxDraws,
+                                                                     GLintptr            offset,
+                                                                     GLintptr            countOffset)
+        {
+            VGFW_PROFILE_FUNCTION
+            ++m_FrameCounters.numDrawCalls;
+            assert(hasIndirectCount());
+            assert(offset + GLsizeiptr {maxDraws} * sizeof(DrawElementsIndirectCommand) <= commandBuffer.getSize());
+            assert(countOffset + GLsizeiptr {sizeof(GLuint)} <= countBuffer.getSize());
+
+            setVertexBuffer(vertexBuffer);
+            setIndexBuffer(indexBuffer);
+            setDrawIndirectBuffer(commandBuffer);
+            setParameterBuffer(countBuffer);
+
+            const auto indexDataType = getIndexDataType(static_cast<GLsizei>(indexBuffer.getIndexType()));
+            if (GLAD_GL_VERSION_4_6)
+            {
+                glMultiDrawElementsIndirectCount(
+                    GL_TRIANGLES, indexDataType, reinterpret_cast<const void*>(offset), countOffset, maxDraws, 0);
+            }
+            else
+            {
+                glMultiDrawElementsIndirectCountARB(
+                    GL_TRIANGLES, indexDataType, reinterpret_cast<const void*>(offset), countOffset, maxDraws, 0);
+            }
             return *this;
         }
 
+        bool RenderContext::hasShaderDrawParameters()
+        {
+            return GLAD_GL_VERSION_4_6 || GLAD_GL_ARB_shader_draw_parameters;
+        }
+
+        bool RenderContext::hasIndirectCount() { return GLAD_GL_VERSION_4_6 || GLAD_GL_ARB_indirect_parameters; }
+
+        bool RenderContext::hasVertexShaderLayer()
+        {
+            return GLAD_GL_ARB_shader_viewport_layer_array || GLAD_GL_AMD_vertex_shader_layer;
+        }
+
+        bool RenderContext::hasBindlessTextures() { return GLAD_GL_ARB_bindless_texture; }
+
+        void RenderContext::setParameterBuffer(const Buffer& buffer)
+        {
+            if (trackStateChange(m_ParameterBuffer != buffer.m_Id))
+            {
+                glBindBuffer(GL_PARAMETER_BUFFER, buffer.m_Id);
+                m_ParameterBuffer = buffer.m_Id;
+            }
+        }
+
+        GLuint64 RenderContext::makeTextureResident(const Texture& texture)
+        {
+            assert(texture && hasBindlessTextures());
+
+            auto [it, inserted] = m_ResidentTextureHandles.try_emplace(texture.m_Id, 0);
+            if (inserted)
+            {
+                it->second = glGetTextureHandleARB(texture.m_Id);
+                glMakeTextureHandleResidentARB(it->second);
+            }
+            return it->second;
+        }
+
+        void RenderContext::setDrawIndirectBuffer(const Buffer& buffer)
+        {
+            // Not part of the VAO state, so a single shadow value is enough
+            if (trackStateChange(m_DrawIndirectBuffer != buffer.m_Id))
+            {
+                glBindBuffer(GL_DRAW_INDIRECT_BUFFER, buffer.m_Id);
+                m_DrawIndirectBuffer = buffer.m_Id;
+            }
+        }
+
         GLuint RenderContext::createVertexArray(const VertexAttributes& attributes)
         {
             GLuint vao;
             glCreateVertexArrays(1, &vao);
 
+            uint32_t instanceDivisor {0};
             for (const auto& [location, attribute] : attributes)
             {
                 const auto [type, size, normalized] = statAttribute(attribute.vertType);
                 assert(type != GL_INVALID_INDEX);
 
                 glEnableVertexArrayAttrib(vao, location);
-                if (attribute.vertType == VertexAttribute::Type::eInt4)
+                if (attribute.vertType == VertexAttribute::Type::eInt ||
+                    attribute.vertType == VertexAttribute::Type::eInt4)
                 {
                     glVertexArrayAttribIFormat(vao, location, size, type, attribute.offset);
                 }
@@ -2605,8 +5900,21 @@ namespace vgfw
                 {
                     glVertexArrayAttribFormat(vao, location, size, type, normalized, attribute.offset);
                 }
-                glVertexArrayAttribBinding(vao, location, 0);
+
+                if (attribute.divisor > 0)
+                {
+                    // The divisor belongs to the binding, so all instance attributes must share it
+                    assert(instanceDivisor == 0 || instanceDivisor == attribute.divisor);
+                    instanceDivisor = attribute.divisor;
+                    glVertexArrayAttribBinding(vao, location, kInstanceBinding);
+                }
+                else
+                {
+                    glVertexArrayAttribBinding(vao, location, kVertexBinding);
+                }
             }
+            if (instanceDivisor > 0)
+                glVertexArrayBindingDivisor(vao, kInstanceBinding, instanceDivisor);
             return vao;
         }
 
@@ -2689,24 +5997,6 @@ namespace vgfw
             };
         }
 
-        void RenderContext::createFaceView(Texture& cubeMap, GLuint mipLevel, GLuint layer, GLuint face)
-        {
-            assert(cubeMap.m_Type == GL_TEXTURE_CUBE_MAP || cubeMap.m_Type == GL_TEXTURE_CUBE_MAP_ARRAY);
-
-            if (cubeMap.m_View != GL_NONE)
-                glDeleteTextures(1, &cubeMap.m_View);
-            glGenTextures(1, &cubeMap.m_View);
-
-            glTextureView(cubeMap.m_View,
-                          GL_TEXTURE_2D,
-                          cubeMap.m_Id,
-                          static_cast<GLenum>(cubeMap.m_PixelFormat),
-                          mipLevel,
-                          1,
-                          (layer * 6) + face,
-                          1);
-        }
-
         void RenderContext::attachTexture(GLuint framebuffer, GLenum attachment, const AttachmentInfo& info)
         {
             const auto& [image, mipLevel, maybeLayer, maybeFace, _] = info;
@@ -2715,8 +6005,12 @@ namespace vgfw
             {
                 case GL_TEXTURE_CUBE_MAP:
                 case GL_TEXTURE_CUBE_MAP_ARRAY:
-                    createFaceView(image, mipLevel, maybeLayer.value_or(0), maybeFace.value_or(0));
-                    glNamedFramebufferTexture(framebuffer, attachment, image.m_View, 0);
+                    // Address the face as a layer-face, a cached framebuffer must not depend on a transient view
+                    glNamedFramebufferTextureLayer(framebuffer,
+                                                   attachment,
+                                                   image.m_Id,
+                                                   mipLevel,
+                                                   (maybeLayer.value_or(0) * 6) + maybeFace.value_or(0));
                     break;
 
                 case GL_TEXTURE_2D:
@@ -2738,73 +6032,416 @@ namespace vgfw
             }
         }
 
-        GLuint RenderContext::createShaderProgram(std::initializer_list<GLuint> shaders)
-        {
-            const auto program = glCreateProgram();
+        GLuint RenderContext::getFramebuffer(const RenderingInfo& renderingInfo)
+        {
+            FramebufferKey key;
+            const auto     addAttachment = [&key](GLenum attachment, const AttachmentInfo& info) {
+                key.push_back({
+                    .attachment = attachment,
+                    .texture    = info.image.m_Id,
+                    .mipLevel   = info.mipLevel,
+                    .layer      = info.layer.value_or(~0u),
+                    .face       = info.face.value_or(~0u),
+                });
+            };
 
-            for (auto shader : shaders)
-                if (shader != GL_NONE)
-                    glAttachShader(program, shader);
+            if (renderingInfo.depthAttachment.has_value())
+                addAttachment(GL_DEPTH_ATTACHMENT, *renderingInfo.depthAttachment);
+            for (size_t i {0}; i < renderingInfo.colorAttachments.size(); ++i)
+                addAttachment(GL_COLOR_ATTACHMENT0 + i, renderingInfo.colorAttachments[i]);
 
-            glLinkProgram(program);
+            if (const auto it = m_Framebuffers.find(key); it != m_Framebuffers.cend())
+                return it->second;
 
-            GLint status;
-            glGetProgramiv(program, GL_LINK_STATUS, &status);
-            if (GL_FALSE == status)
+            GLuint framebuffer {GL_NONE};
+            glCreateFramebuffers(1, &framebuffer);
+            if (renderingInfo.depthAttachment.has_value())
+                attachTexture(framebuffer, GL_DEPTH_ATTACHMENT, *renderingInfo.depthAttachment);
+            for (size_t i {0}; i < renderingInfo.colorAttachments.size(); ++i)
+                attachTexture(framebuffer, GL_COLOR_ATTACHMENT0 + i, renderingInfo.colorAttachments[i]);
+            if (const auto n = renderingInfo.colorAttachments.size(); n > 0)
             {
-                GLint infoLogLength;
-                glGetProgramiv(program, GL_INFO_LOG_LENGTH, &infoLogLength);
-                assert(infoLogLength > 0);
-                std::string infoLog("", infoLogLength);
-                glGetProgramInfoLog(program, infoLogLength, nullptr, infoLog.data());
+                std::vector<GLenum> colorBuffers(n);
+                std::iota(colorBuffers.begin(), colorBuffers.end(), GL_COLOR_ATTACHMENT0);
+                glNamedFramebufferDrawBuffers(framebuffer, colorBuffers.size(), colorBuffers.data());
+            }
+#ifdef _DEBUG
+            const auto status = glCheckNamedFramebufferStatus(framebuffer, GL_DRAW_FRAMEBUFFER);
+            assert(GL_FRAMEBUFFER_COMPLETE == status);
+#endif
 
-                VGFW_ERROR("[ShaderInfoLog] {0}", infoLog);
+            VGFW_TRACE("[RenderContext] Created FBO: {0}", framebuffer);
+            return m_Framebuffers.emplace(std::move(key), framebuffer).first->second;
+        }
 
-                throw std::runtime_error {infoLog};
-            }
-            for (auto shader : shaders)
+        void RenderContext::releaseFramebuffers(GLuint texture)
+        {
+            // Texture names can be recycled by the driver, so drop every framebuffer that references this one
+            auto it = m_Framebuffers.begin();
+            while (it != m_Framebuffers.end())
             {
-                if (shader != GL_NONE)
+                const auto& attachments = it->first;
+                if (std::any_of(attachments.cbegin(), attachments.cend(), [texture](const auto& a) {
+                        return a.texture == texture;
+                    }))
                 {
-                    glDetachShader(program, shader);
-                    glDeleteShader(shader);
+                    glDeleteFramebuffers(1, &it->second);
+                    it = m_Framebuffers.erase(it);
+                }
+                else
+                {
+                    ++it;
                 }
             }
+        }
 
-            return program;
+        bool RenderContext::hasParallelShaderCompile()
+        {
+            return GLAD_GL_KHR_parallel_shader_compile || GLAD_GL_ARB_parallel_shader_compile;
         }
 
-        GLuint RenderContext::createShaderObject(GLenum type, const std::string& shaderSource)
+        ProgramHandle RenderContext::submitProgram(std::initializer_list<ShaderStageSource> stages)
         {
-            auto          id = glCreateShader(type);
-            const GLchar* strings {shaderSource.data()};
-            glShaderSource(id, 1, &strings, nullptr);
-            glCompileShader(id);
+            ProgramHandle handle {};
+            handle.m_State = std::make_shared<ProgramHandle::State>();
+            auto& state    = *handle.m_State;
+
+            state.cacheKey   = getProgramCacheKey(stages);
+            state.sourceHash = getProgramSourceHash(stages);
+            if (state.program = loadProgramBinary(state.cacheKey, state.sourceHash); state.program != GL_NONE)
+            {
+                state.linked = true;
+                return handle;
+            }
+
+            state.program = glCreateProgram();
+            if (!s_ProgramCacheDirectory.empty())
+                glProgramParameteri(state.program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+
+            for (const auto& [type, source] : stages)
+            {
+                if (source.empty())
+                    continue;
+
+                const auto shader = createShaderObject(type, source);
+                glAttachShader(state.program, shader);
+                state.shaders.push_back(shader);
+            }
+
+            // No status queries here, any of them would wait for the compiler
+            glLinkProgram(state.program);
+
+            return handle;
+        }
+
+        GLuint RenderContext::finalizeProgram(ProgramHandle::State& state)
+        {
+            if (state.linked)
+                return state.program;
+            if (state.program == GL_NONE)
+                throw std::runtime_error {"Program failed to build"};
+
+            const auto releaseShaders = [&state] {
+                for (auto shader : state.shaders)
+                {
+                    glDetachShader(state.program, shader);
+                    glDeleteShader(shader);
+                }
+                state.shaders.clear();
+            };
 
             GLint status;
-            glGetShaderiv(id, GL_COMPILE_STATUS, &status);
+            glGetProgramiv(state.program, GL_LINK_STATUS, &status);
             if (GL_FALSE == status)
             {
-                GLint infoLogLength;
-                glGetShaderiv(id, GL_INFO_LOG_LENGTH, &infoLogLength);
-                assert(infoLogLength > 0);
-                std::string infoLog("", infoLogLength);
-                glGetShaderInfoLog(id, infoLogLength, nullptr, infoLog.data());
+                std::string infoLog;
+
+                // A stage that failed to compile is the real error, the link log only repeats it
+                for (auto shader : state.shaders)
+                {
+                    glGetShaderiv(shader, GL_COMPILE_STATUS, &status);
+                    if (GL_FALSE == status)
+                    {
+                        GLint infoLogLength;
+                        glGetShaderiv(shader, GL_INFO_LOG_LENGTH, &infoLogLength);
+                        assert(infoLogLength > 0);
+                        infoLog.assign(infoLogLength, '\0');
+                        glGetShaderInfoLog(shader, infoLogLength, nullptr, infoLog.data());
+                        break;
+                    }
+                }
+                if (infoLog.empty())
+                {
+                    GLint infoLogLength;
+                    glGetProgramiv(state.program, GL_INFO_LOG_LENGTH, &infoLogLength);
+                    assert(infoLogLength > 0);
+                    infoLog.assign(infoLogLength, '\0');
+                    glGetProgramInfoLog(state.program, infoLogLength, nullptr, infoLog.data());
+                }
 
                 VGFW_ERROR("[ShaderInfoLog] {0}", infoLog);
+
+                releaseShaders();
+                glDeleteProgram(state.program);
+                state.program  = GL_NONE;
+                state.released = true;
+
                 throw std::runtime_error {infoLog};
-            };
+            }
+            releaseShaders();
+
+            s_UniformTables[state.program].reflect(state.program);
+            storeProgramBinary(state.cacheKey, state.sourceHash, state.program);
+            state.linked = true;
+
+            return state.program;
+        }
+
+        GLuint RenderContext::createShaderObject(GLenum type, std::string_view shaderSource)
+        {
+            auto          id = glCreateShader(type);
+            const GLchar* strings {shaderSource.data()};
+            const GLint   length {static_cast<GLint>(shaderSource.size())};
+            glShaderSource(id, 1, &strings, &length);
+            glCompileShader(id);
 
             return id;
         }
 
+        // Binaries are only valid for the driver that produced them
+        static std::string getProgramBinaryDriver()
+        {
+            const auto getString = [](GLenum name) {
+                return std::string_view {reinterpret_cast<const char*>(glGetString(name))};
+            };
+            return std::string {getString(GL_VENDOR)} + "\n" + std::string {getString(GL_RENDERER)} + "\n" +
+                   std::string {getString(GL_VERSION)};
+        }
+
+        std::size_t RenderContext::getProgramCacheKey(std::initializer_list<ShaderStageSource> stages)
+        {
+            std::size_t key {0};
+            utils::hashCombine(key, getProgramBinaryDriver());
+            for (const auto& [type, source] : stages)
+                utils::hashCombine(key, type, source);
+            return key;
+        }
+
+        uint64_t RenderContext::getProgramSourceHash(std::initializer_list<ShaderStageSource> stages)
+        {
+            // FNV-1a over every stage, independent of the key (a file name) so that a colliding key is caught
+            uint64_t   h {0xcbf29ce484222325};
+            const auto hashBytes = [&h](const void* data, std::size_t size) {
+                const auto* bytes = static_cast<const std::byte*>(data);
+                for (std::size_t i = 0; i < size; ++i)
+                    h = (h ^ static_cast<uint64_t>(bytes[i])) * 0x100000001b3;
+            };
+            for (const auto& [type, source] : stages)
+            {
+                const uint64_t length {source.size()};
+                hashBytes(&type, sizeof(type));
+                hashBytes(&length, sizeof(length));
+                hashBytes(source.data(), source.size());
+            }
+            return h;
+        }
+
+        // Followed by the driver string (see getProgramBinaryDriver) and the binary
+        struct ProgramBinaryHeader
+        {
+            uint32_t magic {0};
+            uint32_t version {0};
+            GLenum   format {GL_NONE};
+            GLsizei  size {0};
+            uint32_t driverLength {0};
+            uint64_t sourceHash {0};
+
+            static constexpr uint32_t kMagic {0x56475042}; // "VGPB"
+            static constexpr uint32_t kVersion {2};
+        };
+
+        static std::filesystem::path getProgramBinaryPath(const std::filesystem::path& directory, std::size_t key)
+        {
+            return directory / (std::to_string(key) + ".bin");
+        }
+
+        GLuint RenderContext::loadProgramBinary(std::size_t key, uint64_t sourceHash)
+        {
+            if (s_ProgramCacheDirectory.empty())
+                return GL_NONE;
+
+            const auto    path = getProgramBinaryPath(s_ProgramCacheDirectory, key);
+            std::ifstream file(path, std::ios::binary);
+            if (!file.is_open())
+                return GL_NONE;
+
+            ProgramBinaryHeader header;
+            file.read(reinterpret_cast<char*>(&header), sizeof(header));
+
+            // Checked before the driver sees the binary, not every driver rejects a foreign one gracefully
+            const auto        driver = getProgramBinaryDriver();
+            std::vector<char> binary;
+            if (file && header.magic == ProgramBinaryHeader::kMagic &&
+                header.version == ProgramBinaryHeader::kVersion && header.sourceHash == sourceHash &&
+                header.driverLength == driver.size() && header.size > 0)
+            {
+                std::string storedDriver(header.driverLength, '\0');
+                file.read(storedDriver.data(), storedDriver.size());
+                if (file && storedDriver == driver)
+                {
+                    binary.resize(header.size);
+                    file.read(binary.data(), header.size);
+                }
+            }
+            file.close();
+
+            GLuint program {GL_NONE};
+            if (!binary.empty() && file)
+            {
+                program = glCreateProgram();
+                glProgramBinary(program, header.format, binary.data(), header.size);
+
+                GLint status;
+                glGetProgramiv(program, GL_LINK_STATUS, &status);
+                if (GL_FALSE == status)
+                {
+                    glDeleteProgram(program);
+                    program = GL_NONE;
+                }
+            }
+
+            if (program == GL_NONE)
+            {
+                // Corrupted, truncated or rejected by the driver (e.g. after an update), compile from source
+                VGFW_TRACE("[RenderContext] Discarding program binary: {0}", path.string());
+                std::error_code ec;
+                std::filesystem::remove(path, ec);
+                return GL_NONE;
+            }
+
+            VGFW_TRACE("[RenderContext] Loaded program binary: {0}", path.string());
+            s_UniformTables[program].reflect(program);
+            return program;
+        }
+
+        void RenderContext::storeProgramBinary(std::size_t key, uint64_t sourceHash, GLuint program)
+        {
+            if (s_ProgramCacheDirectory.empty())
+                return;
+
+            GLint size {0};
+            glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &size);
+            if (size <= 0)
+                return;
+
+            const auto          driver = getProgramBinaryDriver();
+            ProgramBinaryHeader header {
+                .magic        = ProgramBinaryHeader::kMagic,
+                .version      = ProgramBinaryHeader::kVersion,
+                .driverLength = static_cast<uint32_t>(driver.size()),
+                .sourceHash   = sourceHash,
+            };
+            std::vector<char> binary(size);
+            glGetProgramBinary(program, size, &header.size, &header.format, binary.data());
+            if (header.size <= 0)
+                return;
+
+            // Written next to it and renamed into place, a reader (or a crash) never sees a partial binary. Unique per
+            // thread, programs with the same key may be linked by several contexts
+            const auto path     = getProgramBinaryPath(s_ProgramCacheDirectory, key);
+            auto       tempPath = path;
+            tempPath += ".tmp" + std::to_string(std::hash<std::thread::id> {}(std::this_thread::get_id()));
+
+            std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+            if (!file.is_open())
+            {
+                VGFW_WARN("[RenderContext] Could not write program binary: {0}", tempPath.string());
+                return;
+            }
+            file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+            file.write(driver.data(), driver.size());
+            file.write(binary.data(), header.size);
+            file.close();
+
+            std::error_code ec;
+            if (!file)
+            {
+                VGFW_WARN("[RenderContext] Could not write program binary: {0}", tempPath.string());
+                std::filesystem::remove(tempPath, ec);
+                return;
+            }
+
+            std::filesystem::rename(tempPath, path, ec);
+            if (ec)
+            {
+                VGFW_WARN("[RenderContext] Could not replace program binary {0}: {1}", path.string(), ec.message());
+                std::filesystem::remove(tempPath, ec);
+            }
+        }
+
+        UniformHandle RenderContext::findUniform(std::string_view name) const
+        {
+            if (m_CurrentUniforms)
+                return m_CurrentUniforms->find(name);
+
+            // Program was not linked by us, ask the driver
+            const auto program = m_CurrentPipeline.m_Program;
+            return {glGetUniformLocation(program, std::string {name}.c_str()), program};
+        }
+
+        bool RenderContext::trackStateChange(bool changed)
+        {
+            ++(changed ? m_StateChangeCounters.issued : m_StateChangeCounters.skipped);
+            return changed;
+        }
+
+        void RenderContext::forgetTexture(GLuint texture)
+        {
+            // GL unbinds deleted objects, and the name may be recycled
+            for (auto& binding : m_TextureUnits)
+                if (binding.texture == texture)
+                    binding.texture = GL_NONE;
+
+            if (const auto it = m_ResidentTextureHandles.find(texture); it != m_ResidentTextureHandles.cend())
+            {
+                glMakeTextureHandleNonResidentARB(it->second);
+                m_ResidentTextureHandles.erase(it);
+            }
+        }
+
+        void RenderContext::forgetBuffer(GLuint buffer)
+        {
+            for (auto* bindings : {&m_UniformBufferBindings, &m_StorageBufferBindings})
+                for (auto& binding : *bindings)
+                    if (binding.buffer == buffer)
+                        binding = {};
+
+            for (auto& [_, binding] : m_VertexArrayBindings)
+            {
+                if (binding.vertexBuffer == buffer)
+                    binding.vertexBuffer = GL_NONE;
+                if (binding.instanceBuffer == buffer)
+                    binding.instanceBuffer = GL_NONE;
+                if (binding.indexBuffer == buffer)
+                    binding.indexBuffer = GL_NONE;
+            }
+
+            if (m_DrawIndirectBuffer == buffer)
+                m_DrawIndirectBuffer = GL_NONE;
+            if (m_ParameterBuffer == buffer)
+                m_ParameterBuffer = GL_NONE;
+        }
+
         void RenderContext::setShaderProgram(GLuint program)
         {
             assert(program != GL_NONE);
-            if (auto& current = m_CurrentPipeline.m_Program; current != program)
+            if (auto& current = m_CurrentPipeline.m_Program; trackStateChange(current != program))
             {
                 glUseProgram(program);
                 current = program;
+
+                const auto it     = s_UniformTables.find(program);
+                m_CurrentUniforms = it != s_UniformTables.cend() ? &it->second : nullptr;
             }
         }
 
@@ -2813,36 +6450,66 @@ namespace vgfw
             if (GL_NONE == vao)
                 vao = m_DummyVAO;
 
-            if (auto& current = m_CurrentPipeline.m_VAO; vao != current)
+            if (auto& current = m_CurrentPipeline.m_VAO; trackStateChange(vao != current))
             {
                 glBindVertexArray(vao);
                 current = vao;
             }
         }
 
-        void RenderContext::setVertexBuffer(const VertexBuffer& vertexBuffer) const
+        void RenderContext::setVertexBuffer(const VertexBuffer& vertexBuffer)
         {
             const auto vao = m_CurrentPipeline.m_VAO;
             assert(vertexBuffer && vao != GL_NONE);
-            glVertexArrayVertexBuffer(vao, 0, vertexBuffer.m_Id, 0, vertexBuffer.getStride());
+
+            auto& current = m_VertexArrayBindings[vao];
+            if (trackStateChange(vertexBuffer.m_Id != current.vertexBuffer ||
+                                 vertexBuffer.getStride() != current.stride))
+            {
+                glVertexArrayVertexBuffer(vao, kVertexBinding, vertexBuffer.m_Id, 0, vertexBuffer.getStride());
+                current.vertexBuffer = vertexBuffer.m_Id;
+                current.stride       = vertexBuffer.getStride();
+            }
+        }
+
+        void RenderContext::setInstanceBuffer(const VertexBuffer& instanceBuffer)
+        {
+            const auto vao = m_CurrentPipeline.m_VAO;
+            assert(instanceBuffer && vao != GL_NONE);
+
+            auto& current = m_VertexArrayBindings[vao];
+            if (trackStateChange(instanceBuffer.m_Id != current.instanceBuffer ||
+                                 instanceBuffer.getStride() != current.instanceStride))
+            {
+                glVertexArrayVertexBuffer(vao, kInstanceBinding, instanceBuffer.m_Id, 0, instanceBuffer.getStride());
+                current.instanceBuffer = instanceBuffer.m_Id;
+                current.instanceStride = instanceBuffer.getStride();
+            }
         }
 
-        void RenderContext::setIndexBuffer(const IndexBuffer& indexBuffer) const
+        void RenderContext::setIndexBuffer(const IndexBuffer& indexBuffer)
         {
             const auto vao = m_CurrentPipeline.m_VAO;
             assert(indexBuffer && vao != GL_NONE);
-            glVertexArrayElementBuffer(vao, indexBuffer.m_Id);
+
+            auto& current = m_VertexArrayBindings[vao];
+            if (trackStateChange(indexBuffer.m_Id != current.indexBuffer))
+            {
+                glVertexArrayElementBuffer(vao, indexBuffer.m_Id);
+                current.indexBuffer = indexBuffer.m_Id;
+            }
         }
 
         void RenderContext::setDepthTest(bool enabled, CompareOp depthFunc)
         {
             auto& current = m_CurrentPipeline.m_DepthStencilState;
-            if (enabled != current.depthTest)
+            if (trackStateChange(enabled != current.depthTest))
             {
                 enabled ? glEnable(GL_DEPTH_TEST) : glDisable(GL_DEPTH_TEST);
                 current.depthTest = enabled;
             }
-            if (enabled && depthFunc != current.depthCompareOp)
+            // Set even with the test off, so that the cache always matches the pipeline state it is compared with
+            if (trackStateChange(depthFunc != current.depthCompareOp))
             {
                 glDepthFunc(static_cast<GLenum>(depthFunc));
                 current.depthCompareOp = depthFunc;
@@ -2852,7 +6519,7 @@ namespace vgfw
         void RenderContext::setDepthWrite(bool enabled)
         {
             auto& current = m_CurrentPipeline.m_DepthStencilState;
-            if (enabled != current.depthWrite)
+            if (trackStateChange(enabled != current.depthWrite))
             {
                 glDepthMask(enabled);
                 current.depthWrite = enabled;
@@ -2862,7 +6529,7 @@ namespace vgfw
         void RenderContext::setPolygonMode(PolygonMode polygonMode)
         {
             auto& current = m_CurrentPipeline.m_RasterizerState.polygonMode;
-            if (polygonMode != current)
+            if (trackStateChange(polygonMode != current))
             {
                 glPolygonMode(GL_FRONT_AND_BACK, static_cast<GLenum>(polygonMode));
                 current = polygonMode;
@@ -2872,7 +6539,7 @@ namespace vgfw
         void RenderContext::setPolygonOffset(std::optional<PolygonOffset> polygonOffset)
         {
             auto& current = m_CurrentPipeline.m_RasterizerState;
-            if (polygonOffset != current.polygonOffset)
+            if (trackStateChange(polygonOffset != current.polygonOffset))
             {
                 const auto offsetCap = getPolygonOffsetCap(current.polygonMode);
                 if (polygonOffset.has_value())
@@ -2891,7 +6558,7 @@ namespace vgfw
         void RenderContext::setCullMode(CullMode cullMode)
         {
             auto& current = m_CurrentPipeline.m_RasterizerState.cullMode;
-            if (cullMode != current)
+            if (trackStateChange(cullMode != current))
             {
                 if (cullMode != CullMode::eNone)
                 {
@@ -2910,7 +6577,7 @@ namespace vgfw
         void RenderContext::setDepthClamp(bool enabled)
         {
             auto& current = m_CurrentPipeline.m_RasterizerState.depthClampEnable;
-            if (enabled != current)
+            if (trackStateChange(enabled != current))
             {
                 enabled ? glEnable(GL_DEPTH_CLAMP) : glDisable(GL_DEPTH_CLAMP);
                 current = enabled;
@@ -2920,7 +6587,7 @@ namespace vgfw
         void RenderContext::setScissorTest(bool enabled)
         {
             auto& current = m_CurrentPipeline.m_RasterizerState.scissorTest;
-            if (enabled != current)
+            if (trackStateChange(enabled != current))
             {
                 enabled ? glEnable(GL_SCISSOR_TEST) : glDisable(GL_SCISSOR_TEST);
                 current = enabled;
@@ -2930,7 +6597,7 @@ namespace vgfw
         void RenderContext::setBlendState(GLuint index, const BlendState& state)
         {
             auto& current = m_CurrentPipeline.m_BlendStates[index];
-            if (state != current)
+            if (trackStateChange(state != current))
             {
                 if (state.enabled != current.enabled)
                 {
@@ -2987,65 +6654,149 @@ namespace vgfw
                 static_cast<TransientResources*>(allocator)->releaseTexture(desc, handle);
             }
 
-            void heartbeat(auto& objects, auto& pools, float dt, auto&& deleter)
+            // Ages the pooled resources, the expired ones are destroyed and dropped from their pools
+            static void heartbeat(auto& pools, float dt, auto&& expired, auto&& deleter)
             {
-                constexpr auto kMaxIdleTime = 1.0f; // in seconds
+                pools.forEach([&](std::size_t, auto& pool) {
+                    std::erase_if(pool, [&](auto& entry) {
+                        entry.idleTime += dt;
+                        ++entry.idleFrames;
+                        if (!expired(entry))
+                            return false;
+
+                        deleter(*entry.resource);
+                        VGFW_TRACE("[TransientResources] Released resource: {0}", fmt::ptr(entry.resource));
+                        return true;
+                    });
+                });
+            }
 
-                auto poolIt = pools.begin();
-                while (poolIt != pools.end())
-                {
-                    auto& [_, pool] = *poolIt;
-                    if (pool.empty())
-                    {
-                        poolIt = pools.erase(poolIt);
-                    }
-                    else
+            // Oldest pooled resource that is still alive, nullptr when there is none
+            static auto* findLeastRecentlyUsed(auto& pools)
+            {
+                decltype(&pools.find(0)->front()) oldest {nullptr};
+                pools.forEach([&](std::size_t, auto& pool) {
+                    for (auto& entry : pool)
                     {
-                        auto objectIt = pool.begin();
-                        while (objectIt != pool.cend())
-                        {
-                            auto& [object, idleTime] = *objectIt;
-                            idleTime += dt;
-                            if (idleTime >= kMaxIdleTime)
-                            {
-                                deleter(*object);
-                                VGFW_TRACE("[TransientResources] Released resource: {0}", fmt::ptr(object));
-                                objectIt = pool.erase(objectIt);
-                            }
-                            else
-                            {
-                                ++objectIt;
-                            }
-                        }
-                        ++poolIt;
+                        if (*entry.resource && (!oldest || entry.idleTime > oldest->idleTime))
+                            oldest = &entry;
                     }
+                });
+                return oldest;
+            }
+
+            static void removeDestroyed(auto& objects, auto& pools)
+            {
+                pools.forEach([](std::size_t, auto& pool) {
+                    std::erase_if(pool, [](const auto& entry) { return !(*entry.resource); });
+                });
+                pools.eraseIf([](std::size_t, const auto& pool) { return pool.empty(); });
+
+                std::erase_if(objects, [](const auto& object) { return !(*object); });
+            }
+
+            // Formats of a view class can share storage through glTextureView, depth formats only alias themselves
+            static uint32_t getViewClass(PixelFormat format)
+            {
+                switch (format)
+                {
+                    case PixelFormat::eDepth16:
+                    case PixelFormat::eDepth24:
+                    case PixelFormat::eDepth32F:
+                        return static_cast<uint32_t>(format);
+
+                    default:
+                        return getBytesPerPixel(format);
+                }
+            }
+            static std::size_t getAliasKey(const FrameGraphTexture::Desc& desc)
+            {
+                std::size_t h {0};
+                vgfw::utils::hashCombine(h,
+                                         desc.extent.width,
+                                         desc.extent.height,
+                                         desc.depth,
+                                         desc.numMipLevels,
+                                         desc.layers,
+                                         getViewClass(desc.format));
+                return h;
+            }
+
+            static SamplerInfo makeSamplerInfo(const FrameGraphTexture::Desc& desc)
+            {
+                glm::vec4 borderColor {0.0f};
+                auto      addressMode = SamplerAddressMode::eClampToEdge;
+                switch (desc.wrap)
+                {
+                    case WrapMode::eClampToEdge:
+                        addressMode = SamplerAddressMode::eClampToEdge;
+                        break;
+                    case WrapMode::eClampToOpaqueBlack:
+                        addressMode = SamplerAddressMode::eClampToBorder;
+                        borderColor = glm::vec4 {0.0f, 0.0f, 0.0f, 1.0f};
+                        break;
+                    case WrapMode::eClampToOpaqueWhite:
+                        addressMode = SamplerAddressMode::eClampToBorder;
+                        borderColor = glm::vec4 {1.0f};
+                        break;
                 }
-                objects.erase(std::remove_if(objects.begin(), objects.end(), [](auto& object) { return !(*object); }),
-                              objects.end());
+                SamplerInfo samplerInfo {
+                    .minFilter    = desc.filter,
+                    .mipmapMode   = desc.numMipLevels > 1 ? MipmapMode::eNearest : MipmapMode::eNone,
+                    .magFilter    = desc.filter,
+                    .addressModeS = addressMode,
+                    .addressModeT = addressMode,
+                    .addressModeR = addressMode,
+                    .borderColor  = borderColor,
+                };
+                if (desc.shadowSampler)
+                    samplerInfo.compareOperator = CompareOp::eLessOrEqual;
+                return samplerInfo;
             }
 
-            TransientResources::TransientResources(RenderContext& rc) : m_RenderContext {rc} {}
+            TransientResources::TextureStorage::operator bool() const { return static_cast<bool>(texture); }
+
+            TransientResources::TransientResources(RenderContext& rc) : TransientResources {rc, Policy {}} {}
+            TransientResources::TransientResources(RenderContext& rc, const Policy& policy) :
+                m_RenderContext {rc}, m_Policy {policy}
+            {}
             TransientResources::~TransientResources()
             {
-                for (auto& texture : m_Textures)
-                    m_RenderContext.destroy(*texture);
+                for (auto& storage : m_Textures)
+                    destroy(*storage);
                 for (auto& buffer : m_Buffers)
-                    m_RenderContext.destroy(*buffer);
+                    destroy(*buffer);
             }
 
             void TransientResources::update(float dt)
             {
                 VGFW_PROFILE_FUNCTION
-                const auto deleter = [&](auto& object) { m_RenderContext.destroy(object); };
-                heartbeat(m_Textures, m_TexturePools, dt, deleter);
-                heartbeat(m_Buffers, m_BufferPools, dt, deleter);
+                const auto expired = [this](const auto& entry) {
+                    return entry.idleTime >= m_Policy.maxIdleTime && entry.idleFrames >= m_Policy.minIdleFrames;
+                };
+                heartbeat(m_TexturePools, dt, expired, [this](TextureStorage& storage) { destroy(storage); });
+                heartbeat(m_BufferPools, dt, expired, [this](Buffer& buffer) { destroy(buffer); });
+
+                if (m_Policy.maxPooledBytes > 0)
+                    evictOverBudget();
+
+                removeDestroyed(m_Textures, m_TexturePools);
+                removeDestroyed(m_Buffers, m_BufferPools);
+
+                // Every transient is released by now, the next frame starts from zero
+                m_Stats.peakBytes = m_FramePeakBytes;
+                m_FramePeakBytes  = m_BytesInUse;
             }
 
+            void TransientResources::setPolicy(const Policy& policy) { m_Policy = policy; }
+            const TransientResources::Policy& TransientResources::getPolicy() const { return m_Policy; }
+
             Texture* TransientResources::acquireTexture(const FrameGraphTexture::Desc& desc)
             {
                 const auto h    = std::hash<FrameGraphTexture::Desc> {}(desc);
-                auto&      pool = m_TexturePools[h];
+                auto&      pool = m_TexturePools[getAliasKey(desc)];
 
+                TextureStorage* storage {nullptr};
                 if (pool.empty())
                 {
                     Texture texture;
@@ -3058,54 +6809,131 @@ namespace vgfw
                         texture =
                             m_RenderContext.createTexture2D(desc.extent, desc.format, desc.numMipLevels, desc.layers);
                     }
-
-                    glm::vec4 borderColor {0.0f};
-                    auto      addressMode = SamplerAddressMode::eClampToEdge;
-                    switch (desc.wrap)
-                    {
-                        case WrapMode::eClampToEdge:
-                            addressMode = SamplerAddressMode::eClampToEdge;
-                            break;
-                        case WrapMode::eClampToOpaqueBlack:
-                            addressMode = SamplerAddressMode::eClampToBorder;
-                            borderColor = glm::vec4 {0.0f, 0.0f, 0.0f, 1.0f};
-                            break;
-                        case WrapMode::eClampToOpaqueWhite:
-                            addressMode = SamplerAddressMode::eClampToBorder;
-                            borderColor = glm::vec4 {1.0f};
-                            break;
-                    }
-                    SamplerInfo samplerInfo {
-                        .minFilter    = desc.filter,
-                        .mipmapMode   = desc.numMipLevels > 1 ? MipmapMode::eNearest : MipmapMode::eNone,
-                        .magFilter    = desc.filter,
-                        .addressModeS = addressMode,
-                        .addressModeT = addressMode,
-                        .addressModeR = addressMode,
-                        .borderColor  = borderColor,
-                    };
-                    if (desc.shadowSampler)
-                        samplerInfo.compareOperator = CompareOp::eLessOrEqual;
-                    m_RenderContext.setupSampler(texture, samplerInfo);
-
-                    m_Textures.push_back(std::make_unique<Texture>(std::move(texture)));
-                    auto* ptr = m_Textures.back().get();
-                    VGFW_TRACE("[TransientResources] Created texture: {0}", fmt::ptr(ptr));
-                    return ptr;
+                    m_RenderContext.setupSampler(texture, makeSamplerInfo(desc));
+
+                    const auto size = calcTextureSize(texture);
+                    m_Textures.push_back(std::make_unique<TextureStorage>(std::move(texture), h, size));
+                    storage = m_Textures.back().get();
+
+                    m_Stats.textureBytes += size;
+                    ++m_Stats.numTextures;
+                    ++m_Stats.numMisses;
+                    m_RenderContext.countTransientAcquisition(true);
+                    ++m_Stats.numCreations;
+                    VGFW_TRACE("[TransientResources] Created texture: {0}", fmt::ptr(storage));
                 }
                 else
                 {
-                    auto* texture = pool.back().resource;
-                    pool.pop_back();
-                    return texture;
+                    ++m_Stats.numHits;
+                    m_RenderContext.countTransientAcquisition(false);
+
+                    // Prefer a storage made for this exact desc, any other one is aliased through a view
+                    auto it = std::find_if(
+                        pool.begin(), pool.end(), [h](const auto& entry) { return entry.resource->descHash == h; });
+                    if (it == pool.end())
+                        it = std::prev(pool.end());
+
+                    storage = it->resource;
+                    pool.erase(it);
                 }
+
+                auto* texture = getTextureView(*storage, desc);
+                m_AcquiredTextures.emplace(texture, storage);
+                trackUsage(storage->size);
+                return texture;
             }
             void TransientResources::releaseTexture(const FrameGraphTexture::Desc& desc, Texture* texture)
+            {
+                const auto it = m_AcquiredTextures.find(texture);
+                assert(it != m_AcquiredTextures.end());
+
+                auto* storage = it->second;
+                m_AcquiredTextures.erase(it);
+
+                m_TexturePools[getAliasKey(desc)].push_back({storage});
+                trackUsage(-storage->size);
+            }
+
+            Texture* TransientResources::getTextureView(TextureStorage& storage, const FrameGraphTexture::Desc& desc)
             {
                 const auto h = std::hash<FrameGraphTexture::Desc> {}(desc);
-                m_TexturePools[h].push_back({texture, 0.0f});
+                if (h == storage.descHash)
+                    return &storage.texture;
+
+                const auto it = std::find_if(
+                    storage.views.begin(), storage.views.end(), [h](const auto& view) { return view.first == h; });
+                if (it != storage.views.end())
+                    return it->second.get();
+
+                // Sampler state lives in the view, so a desc that differs only by sampler gets a view too
+                auto view = m_RenderContext.createTextureView(storage.texture, desc.format);
+                m_RenderContext.setupSampler(view, makeSamplerInfo(desc));
+
+                storage.views.emplace_back(h, std::make_unique<Texture>(std::move(view)));
+                ++m_Stats.numTextureViews;
+                ++m_Stats.numCreations;
+
+                auto* ptr = storage.views.back().second.get();
+                VGFW_TRACE("[TransientResources] Created texture view: {0} (of {1}, {2})",
+                           fmt::ptr(ptr),
+                           fmt::ptr(&storage),
+                           toString(desc.format));
+                return ptr;
+            }
+
+            void TransientResources::destroy(TextureStorage& storage)
+            {
+                for (auto& [_, view] : storage.views)
+                    m_RenderContext.destroy(*view);
+
+                m_Stats.numTextureViews -= static_cast<uint32_t>(storage.views.size());
+                m_Stats.textureBytes -= storage.size;
+                --m_Stats.numTextures;
+
+                storage.views.clear();
+                m_RenderContext.destroy(storage.texture);
+            }
+            void TransientResources::destroy(Buffer& buffer)
+            {
+                m_Stats.bufferBytes -= buffer.getSize();
+                --m_Stats.numBuffers;
+
+                m_RenderContext.destroy(buffer);
+            }
+
+            void TransientResources::trackUsage(GLsizeiptr delta)
+            {
+                m_BytesInUse += delta;
+                m_FramePeakBytes = std::max(m_FramePeakBytes, m_BytesInUse);
+            }
+
+            void TransientResources::evictOverBudget()
+            {
+                // Resources that are in use can not go, so the budget is only met as far as the idle ones allow
+                while (m_Stats.textureBytes + m_Stats.bufferBytes > m_Policy.maxPooledBytes)
+                {
+                    auto* texture = findLeastRecentlyUsed(m_TexturePools);
+                    auto* buffer  = findLeastRecentlyUsed(m_BufferPools);
+                    if (texture && (!buffer || texture->idleTime >= buffer->idleTime))
+                    {
+                        destroy(*texture->resource);
+                        VGFW_TRACE("[TransientResources] Evicted texture: {0}", fmt::ptr(texture->resource));
+                    }
+                    else if (buffer)
+                    {
+                        destroy(*buffer->resource);
+                        VGFW_TRACE("[TransientResources] Evicted buffer: {0}", fmt::ptr(buffer->resource));
+                    }
+                    else
+                    {
+                        break;
+                    }
+                    ++m_Stats.numEvictions;
+                }
             }
 
+            const TransientResources::Stats& TransientResources::getStats() const { return m_Stats; }
+
             Buffer* TransientResources::acquireBuffer(const FrameGraphBuffer::Desc& desc)
             {
                 const auto h    = std::hash<FrameGraphBuffer::Desc> {}(desc);
@@ -3115,20 +6943,32 @@ namespace vgfw
                     auto buffer = m_RenderContext.createBuffer(desc.size);
                     m_Buffers.push_back(std::make_unique<Buffer>(std::move(buffer)));
                     auto* ptr = m_Buffers.back().get();
+
+                    m_Stats.bufferBytes += ptr->getSize();
+                    ++m_Stats.numBuffers;
+                    ++m_Stats.numMisses;
+                    m_RenderContext.countTransientAcquisition(true);
+                    ++m_Stats.numCreations;
                     VGFW_TRACE("[TransientResources] Created buffer: {0}", fmt::ptr(ptr));
+                    trackUsage(ptr->getSize());
                     return ptr;
                 }
                 else
                 {
+                    ++m_Stats.numHits;
+                    m_RenderContext.countTransientAcquisition(false);
+
                     auto* buffer = pool.back().resource;
                     pool.pop_back();
+                    trackUsage(buffer->getSize());
                     return buffer;
                 }
             }
             void TransientResources::releaseBuffer(const FrameGraphBuffer::Desc& desc, Buffer* buffer)
             {
                 const auto h = std::hash<FrameGraphBuffer::Desc> {}(desc);
-                m_BufferPools[h].push_back({std::move(buffer), 0.0f});
+                trackUsage(-buffer->getSize());
+                m_BufferPools[h].push_back({buffer});
             }
 
             FrameGraphResource importTexture(FrameGraph& fg, const std::string& name, Texture* texture)
@@ -3415,12 +7255,76 @@ namespace vgfw
                 ImGui_ImplGlfw_Shutdown();
                 ImGui::DestroyContext();
             }
+
+            void drawProfilerOverlay(const FrameProfiler& profiler)
+            {
+                ImGui::Begin("Frame Profiler");
+
+                const auto* frame = profiler.getLastFrame();
+                if (!frame)
+                {
+                    ImGui::Text("No frame read back yet");
+                    ImGui::End();
+                    return;
+                }
+
+                const auto& history = profiler.getHistory();
+
+                std::vector<float> gpuTimes;
+                gpuTimes.reserve(history.size());
+                for (const auto& f : history)
+                    gpuTimes.push_back(std::max(f.gpuTime, 0.0f));
+                ImGui::PlotLines("GPU ms", gpuTimes.data(), static_cast<int>(gpuTimes.size()));
+
+                ImGui::Text("Frame %llu: %.2f ms CPU, %.2f ms GPU",
+                            static_cast<unsigned long long>(frame->index),
+                            frame->cpuTime,
+                            frame->gpuTime);
+
+                const auto& counters = frame->counters;
+                ImGui::Text("%u draw calls, %u dispatches, %u state changes (%u filtered)",
+                            counters.numDrawCalls,
+                            counters.numDispatches,
+                            frame->stateChanges.issued,
+                            frame->stateChanges.skipped);
+                ImGui::Text("Uploaded %.1f KiB, %u transients acquired (%u allocated)",
+                            counters.uploadedBytes / 1024.0f,
+                            counters.numTransientAcquisitions,
+                            counters.numTransientAllocations);
+
+                if (ImGui::BeginTable("Scopes", 3, ImGuiTableFlags_RowBg | ImGuiTableFlags_BordersInnerV))
+                {
+                    ImGui::TableSetupColumn("Scope");
+                    ImGui::TableSetupColumn("CPU ms");
+                    ImGui::TableSetupColumn("GPU ms");
+                    ImGui::TableHeadersRow();
+                    for (const auto& scope : frame->scopes)
+                    {
+                        ImGui::TableNextRow();
+                        ImGui::TableNextColumn();
+                        ImGui::Indent(scope.depth * 8.0f);
+                        ImGui::TextUnformatted(scope.name.c_str());
+                        ImGui::Unindent(scope.depth * 8.0f);
+                        ImGui::TableNextColumn();
+                        ImGui::Text("%.3f", scope.cpuTime);
+                        ImGui::TableNextColumn();
+                        if (scope.gpuTime < 0.0f)
+                            ImGui::TextUnformatted("-");
+                        else
+                            ImGui::Text("%.3f", scope.gpuTime);
+                    }
+                    ImGui::EndTable();
+                }
+
+                ImGui::End();
+            }
         } // namespace imgui
 
         void init(const RendererInitInfo& initInfo)
         {
             g_GraphicsContext.init(initInfo.window);
             g_RenderContext = std::make_shared<RenderContext>();
+            RenderContext::setProgramCacheDirectory(initInfo.programCacheDirectory);
 
             imgui::init(initInfo.enableImGuiDocking);
 
@@ -3430,6 +7334,7 @@ namespace vgfw
         void beginFrame()
         {
             VGFW_PROFILE_FUNCTION
+            g_RenderContext->beginFrame();
             imgui::beginFrame();
         }
 
@@ -3437,6 +7342,7 @@ namespace vgfw
         {
             VGFW_PROFILE_FUNCTION
             imgui::endFrame();
+            g_RenderContext->endFrame();
         }
 
         void present()
@@ -3460,134 +7366,1631 @@ namespace vgfw
     namespace resource
     {
         void MeshPrimitive::build(renderer::VertexFormat::Builder& vertexFormatBuilder, renderer::RenderContext& rc)
+        {
+            prepare(vertexFormatBuilder);
+            upload(rc);
+        }
+
+        void MeshPrimitive::prepare(renderer::VertexFormat::Builder& vertexFormatBuilder)
         {
             vertexFormat = vertexFormatBuilder.build();
             indexCount   = indices.size();
 
-            bool hasNormal    = !record.normals.empty();
-            bool hasTexCoords = !record.texcoords.empty();
-            bool hasTangent   = !record.tangents.empty();
+            // Streaming loaders (glTF) interleave straight into vertices and set the bounds themselves
+            if (!record.positions.empty())
+                interleaveRecord();
+
+            if (ownerModel && ownerModel->meshOptimization.enabled)
+                optimizeMesh(*this, ownerModel->meshOptimization);
+            if (ownerModel && ownerModel->meshLods.enabled)
+                generateLods(*this, ownerModel->meshLods);
+            if (ownerModel && ownerModel->meshQuantization.enabled)
+                quantizeMesh(*this, ownerModel->meshQuantization);
+        }
+
+        void MeshPrimitive::interleaveRecord()
+        {
+            const bool hasNormal    = !record.normals.empty();
+            const bool hasTexCoords = !record.texcoords.empty();
+            const bool hasTangent   = !record.tangents.empty();
+
+            const float floatMax = std::numeric_limits<float>::max();
 
-            float floatMax = std::numeric_limits<float>::max();
+            aabb.min = glm::vec3 {floatMax};
+            aabb.max = glm::vec3 {-floatMax};
 
-            aabb.min = {floatMax, floatMax, floatMax};
-            aabb.max = {-floatMax, -floatMax, -floatMax};
+            vertices.resize(std::size_t {vertexCount} * vertexFormat->getStride() / sizeof(float));
+            auto* out = vertices.data();
 
             for (uint32_t v = 0; v < vertexCount; ++v)
             {
-                // clang-format off
-                // update AABB
-                if (record.positions[v].x < aabb.min.x) aabb.min.x = record.positions[v].x;
-                if (record.positions[v].y < aabb.min.y) aabb.min.y = record.positions[v].y;
-                if (record.positions[v].z < aabb.min.z) aabb.min.z = record.positions[v].z;
-
-                if (record.positions[v].x > aabb.max.x) aabb.max.x = record.positions[v].x;
-                if (record.positions[v].y > aabb.max.y) aabb.max.y = record.positions[v].y;
-                if (record.positions[v].z > aabb.max.z) aabb.max.z = record.positions[v].z;
-                // clang-format on
+                const auto& position = record.positions[v];
+                aabb.min             = glm::min(aabb.min, position);
+                aabb.max             = glm::max(aabb.max, position);
 
-                // fill position
-                vertices.push_back(record.positions[v].x);
-                vertices.push_back(record.positions[v].y);
-                vertices.push_back(record.positions[v].z);
-
-                // fill normal
+                out = std::copy_n(glm::value_ptr(position), 3, out);
                 if (hasNormal)
-                {
-                    vertices.push_back(record.normals[v].x);
-                    vertices.push_back(record.normals[v].y);
-                    vertices.push_back(record.normals[v].z);
-                }
-
-                // fill uv
+                    out = std::copy_n(glm::value_ptr(record.normals[v]), 3, out);
                 if (hasTexCoords)
-                {
-                    vertices.push_back(record.texcoords[v].x);
-                    vertices.push_back(record.texcoords[v].y);
-                }
+                    out = std::copy_n(glm::value_ptr(record.texcoords[v]), 2, out);
+                if (hasTangent)
+                    out = std::copy_n(glm::value_ptr(record.tangents[v]), 4, out);
+            }
+            assert(out == vertices.data() + vertices.size());
+
+            record = {};
+        }
+
+        void MeshPrimitive::upload(renderer::RenderContext& rc) { upload(rc, vertices.data(), indices); }
+
+        void
+        MeshPrimitive::upload(renderer::RenderContext& rc, const void* vertexData, std::span<const uint32_t> indexData)
+        {
+            assert(vertexFormat && indexData.size() == getNumStoredIndices());
+
+            if (ownerModel && ownerModel->geometryArena)
+            {
+                auto& arena = *ownerModel->geometryArena;
+
+                auto geometry = arena.add(*vertexFormat, vertexData, vertexCount, indexData, indexType);
+                vertexBuffer  = std::move(geometry.vertexBuffer);
+                indexBuffer   = std::move(geometry.indexBuffer);
+                baseVertex    = geometry.baseVertex;
+                firstIndex    = geometry.firstIndex;
+
+                auto materialAllocation = arena.addUniform(&material, sizeof(PrimitiveMaterial));
+                materialBuffer          = std::move(materialAllocation.buffer);
+                materialOffset          = materialAllocation.offset;
+            }
+            else
+            {
+                // Load index buffer & vertex buffer
+                const auto indices = renderer::narrowIndices(indexData, indexType);
+
+                auto indexBuf  = rc.createIndexBuffer(indexType, indexData.size(), indices.data());
+                auto vertexBuf = rc.createVertexBuffer(vertexFormat->getStride(), vertexCount, vertexData);
+
+                indexBuffer  = std::shared_ptr<renderer::IndexBuffer>(new renderer::IndexBuffer {std::move(indexBuf)},
+                                                                     renderer::RenderContext::ResourceDeleter {rc});
+                vertexBuffer = std::shared_ptr<renderer::VertexBuffer>(
+                    new renderer::VertexBuffer {std::move(vertexBuf)}, renderer::RenderContext::ResourceDeleter {rc});
+
+                // Load material buffer
+                auto materialBuf = rc.createBuffer(sizeof(PrimitiveMaterial), &material);
+                materialBuffer   = std::shared_ptr<renderer::Buffer>(new renderer::Buffer {std::move(materialBuf)},
+                                                                   renderer::RenderContext::ResourceDeleter {rc});
+            }
+
+            releaseCpuData();
+        }
+
+        void MeshPrimitive::releaseCpuData()
+        {
+            const auto retain = ownerModel ? ownerModel->retainMeshData : MeshDataRetention {};
+
+            // Swapped out rather than cleared, so that the capacity goes too
+            if (!retain.vertices)
+                std::vector<float> {}.swap(vertices);
+            if (!retain.indices)
+                std::vector<uint32_t> {}.swap(indices);
+        }
+
+        void MeshPrimitive::draw(renderer::RenderContext& rc, uint32_t numInstances, uint32_t lod) const
+        {
+            assert(vertexBuffer && indexBuffer);
+
+            const auto range = getLod(lod);
+            rc.draw(*vertexBuffer,
+                    *indexBuffer,
+                    range.indexCount,
+                    vertexCount,
+                    numInstances,
+                    firstIndex + range.firstIndex,
+                    baseVertex);
+        }
+
+        MeshLod MeshPrimitive::getLod(uint32_t lod) const
+        {
+            if (lods.empty())
+                return {.indexCount = indexCount};
+            return lods[std::min<std::size_t>(lod, lods.size() - 1)];
+        }
+
+        uint32_t MeshPrimitive::getNumLods() const { return std::max<uint32_t>(static_cast<uint32_t>(lods.size()), 1); }
+
+        uint32_t MeshPrimitive::getNumStoredIndices() const
+        {
+            return lods.empty() ? indexCount : lods.back().firstIndex + lods.back().indexCount;
+        }
+
+        // -------- mesh optimization --------
+
+        static constexpr uint32_t kNoVertex {std::numeric_limits<uint32_t>::max()};
+
+        // Bitwise identical vertices become one (kept in order of first occurrence), @return the new vertex count
+        static uint32_t weldVertices(std::vector<float>&    vertices,
+                                     std::vector<uint32_t>& indices,
+                                     uint32_t               vertexCount,
+                                     uint32_t               stride)
+        {
+            const auto numFloats = stride / sizeof(float);
+            auto*      data      = vertices.data();
+
+            const auto hashVertex = [&](uint32_t v) {
+                const auto* bytes = reinterpret_cast<const std::byte*>(data + v * numFloats);
+
+                uint64_t h {0xcbf29ce484222325};
+                for (uint32_t i = 0; i < stride; ++i)
+                    h = (h ^ static_cast<uint64_t>(bytes[i])) * 0x100000001b3;
+                return h;
+            };
+
+            // Open addressing over the unique vertices, which are compacted to the front as they are found
+            std::vector<uint32_t> table(std::bit_ceil(std::max(vertexCount * 2u, 16u)), kNoVertex);
+            const auto            mask = table.size() - 1;
+
+            std::vector<uint32_t> remap(vertexCount);
+            uint32_t              numUnique {0};
+            for (uint32_t v = 0; v < vertexCount; ++v)
+            {
+                auto slot = hashVertex(v) & mask;
+                while (table[slot] != kNoVertex &&
+                       std::memcmp(data + table[slot] * numFloats, data + v * numFloats, stride) != 0)
+                    slot = (slot + 1) & mask;
+
+                if (table[slot] == kNoVertex)
+                {
+                    if (numUnique != v)
+                        std::memcpy(data + numUnique * numFloats, data + v * numFloats, stride);
+                    table[slot] = numUnique++;
+                }
+                remap[v] = table[slot];
+            }
+
+            for (auto& index : indices)
+                index = remap[index];
+            vertices.resize(numUnique * numFloats);
+
+            return numUnique;
+        }
+
+        // Tom Forsyth, Linear-Speed Vertex Cache Optimisation: greedily emits the triangle whose vertices score
+        // best, a vertex scores by its position in a simulated LRU cache and by how many triangles still need it
+        static void optimizeVertexCache(std::vector<uint32_t>& indices, uint32_t vertexCount)
+        {
+            constexpr uint32_t kCacheSize {32};
+
+            const auto numTriangles = static_cast<uint32_t>(indices.size() / 3);
+
+            // Triangles of each vertex, the first numRemaining[v] of its range are not emitted yet
+            std::vector<uint32_t> numRemaining(vertexCount, 0);
+            for (const auto index : indices)
+                ++numRemaining[index];
+
+            std::vector<uint32_t> firstTriangle(vertexCount + 1, 0);
+            for (uint32_t v = 0; v < vertexCount; ++v)
+                firstTriangle[v + 1] = firstTriangle[v] + numRemaining[v];
+
+            std::vector<uint32_t> adjacency(indices.size());
+            {
+                std::vector<uint32_t> fill(firstTriangle.cbegin(), firstTriangle.cend() - 1);
+                for (uint32_t i = 0; i < indices.size(); ++i)
+                    adjacency[fill[indices[i]]++] = i / 3;
+            }
+
+            const auto calcScore = [](int32_t cachePosition, uint32_t numTriangles) {
+                if (numTriangles == 0)
+                    return -1.0f;
+
+                float score {0.0f};
+                if (cachePosition >= 0)
+                {
+                    // The last triangle's vertices score the same, whichever order the next one uses them in
+                    score = cachePosition < 3 ?
+                                0.75f :
+                                std::pow(1.0f - static_cast<float>(cachePosition - 3) / (kCacheSize - 3), 1.5f);
+                }
+                return score + 2.0f / std::sqrt(static_cast<float>(numTriangles));
+            };
+
+            std::vector<int32_t> cachePositions(vertexCount, -1);
+            std::vector<float>   vertexScores(vertexCount);
+            for (uint32_t v = 0; v < vertexCount; ++v)
+                vertexScores[v] = calcScore(-1, numRemaining[v]);
+
+            std::vector<float> triangleScores(numTriangles);
+            std::vector<bool>  emitted(numTriangles, false);
+            for (uint32_t t = 0; t < numTriangles; ++t)
+            {
+                triangleScores[t] =
+                    vertexScores[indices[t * 3]] + vertexScores[indices[t * 3 + 1]] + vertexScores[indices[t * 3 + 2]];
+            }
+
+            std::vector<uint32_t> result;
+            result.reserve(indices.size());
+
+            std::array<uint32_t, kCacheSize + 3> cache {};
+            uint32_t                             cacheCount {0};
+
+            auto     best = static_cast<int64_t>(
+                std::max_element(triangleScores.cbegin(), triangleScores.cend()) - triangleScores.cbegin());
+            uint32_t nextTriangle {0}; // When the cache has nothing left to offer
+            while (result.size() < indices.size())
+            {
+                if (best < 0)
+                {
+                    while (emitted[nextTriangle])
+                        ++nextTriangle;
+                    best = nextTriangle;
+                }
+                emitted[best] = true;
+
+                const auto* triangle = &indices[best * 3];
+                for (uint32_t k = 0; k < 3; ++k)
+                {
+                    const auto v = triangle[k];
+                    result.push_back(v);
+
+                    auto*      first = &adjacency[firstTriangle[v]];
+                    const auto it    = std::find(first, first + numRemaining[v], static_cast<uint32_t>(best));
+                    std::swap(*it, first[--numRemaining[v]]);
+                }
+
+                // The triangle's vertices move to the front, the ones pushed out of the cache lose their position
+                std::array<uint32_t, kCacheSize + 3> newCache {};
+                uint32_t                             newCacheCount {0};
+                for (uint32_t k = 0; k < 3; ++k)
+                {
+                    if (std::find(newCache.cbegin(), newCache.cbegin() + newCacheCount, triangle[k]) ==
+                        newCache.cbegin() + newCacheCount)
+                        newCache[newCacheCount++] = triangle[k];
+                }
+                for (uint32_t i = 0; i < cacheCount; ++i)
+                {
+                    if (std::find(triangle, triangle + 3, cache[i]) == triangle + 3)
+                        newCache[newCacheCount++] = cache[i];
+                }
+
+                for (uint32_t i = 0; i < newCacheCount; ++i)
+                {
+                    const auto v      = newCache[i];
+                    cachePositions[v] = i < kCacheSize ? static_cast<int32_t>(i) : -1;
+                    vertexScores[v]   = calcScore(cachePositions[v], numRemaining[v]);
+                }
+
+                // The next one is the best among the triangles of the touched vertices
+                best = -1;
+                float bestScore {-1.0f};
+                for (uint32_t i = 0; i < newCacheCount; ++i)
+                {
+                    const auto v = newCache[i];
+                    for (uint32_t j = 0; j < numRemaining[v]; ++j)
+                    {
+                        const auto t      = adjacency[firstTriangle[v] + j];
+                        triangleScores[t] = vertexScores[indices[t * 3]] + vertexScores[indices[t * 3 + 1]] +
+                                            vertexScores[indices[t * 3 + 2]];
+                        if (triangleScores[t] > bestScore)
+                        {
+                            best      = t;
+                            bestScore = triangleScores[t];
+                        }
+                    }
+                }
+
+                cacheCount = std::min(newCacheCount, kCacheSize);
+                cache      = newCache;
+            }
+
+            indices.swap(result);
+        }
+
+        // Sander et al., Fast Triangle Reordering for Vertex Locality and Reduced Overdraw: the cache optimized order
+        // is split into clusters (where the cache starts over, and wherever a cluster is already about as efficient
+        // as the whole), then clusters facing away from the mesh center draw first
+        static void optimizeOverdraw(std::vector<uint32_t>& indices,
+                                     std::span<const float> vertices,
+                                     uint32_t               vertexCount,
+                                     uint32_t               stride,
+                                     int32_t                positionOffset,
+                                     float                  threshold)
+        {
+            constexpr uint32_t kCacheSize {16}; // FIFO, like the hardware
+
+            const auto numTriangles = static_cast<uint32_t>(indices.size() / 3);
+
+            std::vector<uint32_t> cacheTimes(vertexCount, 0);
+            uint32_t              time {kCacheSize + 1};
+
+            const auto resetCache = [&] { time += kCacheSize + 1; };
+            const auto simulate   = [&](uint32_t t) {
+                uint32_t numMisses {0};
+                for (uint32_t k = 0; k < 3; ++k)
+                {
+                    const auto v = indices[t * 3 + k];
+                    if (time - cacheTimes[v] > kCacheSize)
+                    {
+                        cacheTimes[v] = time++;
+                        ++numMisses;
+                    }
+                }
+                return numMisses;
+            };
+
+            std::vector<uint32_t> hardBoundaries;
+            for (uint32_t t = 0; t < numTriangles; ++t)
+            {
+                if (simulate(t) == 3 || t == 0)
+                    hardBoundaries.push_back(t);
+            }
+            hardBoundaries.push_back(numTriangles);
+
+            std::vector<uint32_t> clusters;
+            for (std::size_t h = 0; h + 1 < hardBoundaries.size(); ++h)
+            {
+                const auto start = hardBoundaries[h];
+                const auto end   = hardBoundaries[h + 1];
+
+                resetCache();
+                uint32_t numClusterMisses {0};
+                for (auto t = start; t < end; ++t)
+                    numClusterMisses += simulate(t);
+
+                // Misses per triangle
+                const auto maxMissRatio = threshold * numClusterMisses / (end - start);
+
+                resetCache();
+                clusters.push_back(start);
+                uint32_t numMisses {0}, numRunTriangles {0};
+                for (auto t = start; t < end; ++t)
+                {
+                    numMisses += simulate(t);
+                    ++numRunTriangles;
+                    if (t + 1 < end && static_cast<float>(numMisses) / numRunTriangles <= maxMissRatio)
+                    {
+                        clusters.push_back(t + 1);
+                        numMisses = numRunTriangles = 0;
+                    }
+                }
+            }
+            clusters.push_back(numTriangles);
+
+            const auto* bytes       = reinterpret_cast<const std::byte*>(vertices.data());
+            const auto  getPosition = [&](uint32_t v) {
+                glm::vec3 position;
+                std::memcpy(&position, bytes + std::size_t {v} * stride + positionOffset, sizeof(position));
+                return position;
+            };
+
+            // Area weighted, the cross product is twice the area
+            struct Cluster
+            {
+                glm::vec3 centroid {0.0f};
+                glm::vec3 normal {0.0f};
+                float     area {0.0f};
+                float     sortKey {0.0f};
+                uint32_t  start {0};
+                uint32_t  end {0};
+            };
+            std::vector<Cluster> clusterInfos(clusters.size() - 1);
+
+            glm::vec3 meshCentroid {0.0f};
+            float     meshArea {0.0f};
+            for (std::size_t c = 0; c < clusterInfos.size(); ++c)
+            {
+                auto& cluster = clusterInfos[c];
+                cluster.start = clusters[c];
+                cluster.end   = clusters[c + 1];
+                for (auto t = cluster.start; t < cluster.end; ++t)
+                {
+                    const auto p0 = getPosition(indices[t * 3]);
+                    const auto p1 = getPosition(indices[t * 3 + 1]);
+                    const auto p2 = getPosition(indices[t * 3 + 2]);
+
+                    const auto normal = glm::cross(p1 - p0, p2 - p0);
+                    const auto area   = glm::length(normal);
+
+                    cluster.centroid += (p0 + p1 + p2) * (area / 3.0f);
+                    cluster.normal += normal;
+                    cluster.area += area;
+                }
+                meshCentroid += cluster.centroid;
+                meshArea += cluster.area;
+            }
+            if (meshArea > 0.0f)
+                meshCentroid /= meshArea;
+
+            for (auto& cluster : clusterInfos)
+            {
+                if (cluster.area > 0.0f)
+                    cluster.centroid /= cluster.area;
+
+                const auto normalLength = glm::length(cluster.normal);
+                if (normalLength > 0.0f)
+                    cluster.sortKey = glm::dot(cluster.centroid - meshCentroid, cluster.normal / normalLength);
+            }
+            std::stable_sort(clusterInfos.begin(), clusterInfos.end(), [](const Cluster& lhs, const Cluster& rhs) {
+                return lhs.sortKey > rhs.sortKey;
+            });
+
+            std::vector<uint32_t> result;
+            result.reserve(indices.size());
+            for (const auto& cluster : clusterInfos)
+                result.insert(result.end(), indices.cbegin() + cluster.start * 3, indices.cbegin() + cluster.end * 3);
+
+            indices.swap(result);
+        }
+
+        // Vertices in the order the indices first use them, @return the new vertex count
+        static uint32_t optimizeVertexFetch(std::vector<float>&    vertices,
+                                            std::vector<uint32_t>& indices,
+                                            uint32_t               vertexCount,
+                                            uint32_t               stride)
+        {
+            const auto numFloats = stride / sizeof(float);
+
+            std::vector<uint32_t> remap(vertexCount, kNoVertex);
+            uint32_t              numUsed {0};
+            for (auto& index : indices)
+            {
+                if (remap[index] == kNoVertex)
+                    remap[index] = numUsed++;
+                index = remap[index];
+            }
+
+            std::vector<float> reordered(numUsed * numFloats);
+            for (uint32_t v = 0; v < vertexCount; ++v)
+            {
+                if (remap[v] != kNoVertex)
+                    std::copy_n(vertices.cbegin() + v * numFloats, numFloats, reordered.begin() + remap[v] * numFloats);
+            }
+            vertices.swap(reordered);
+
+            return numUsed;
+        }
+
+        void optimizeMesh(MeshPrimitive& meshPrimitive, const MeshOptimization& options)
+        {
+            VGFW_PROFILE_FUNCTION
+
+            auto& vertices = meshPrimitive.vertices;
+            auto& indices  = meshPrimitive.indices;
+            if (!meshPrimitive.vertexFormat || vertices.empty() || indices.size() % 3 != 0)
+                return;
+
+            const auto stride      = meshPrimitive.vertexFormat->getStride();
+            auto       numVertices = meshPrimitive.vertexCount;
+            assert(vertices.size() * sizeof(float) == std::size_t {numVertices} * stride);
+
+            if (options.weldVertices)
+                numVertices = weldVertices(vertices, indices, numVertices, stride);
+
+            if (options.optimizeVertexCache)
+            {
+                optimizeVertexCache(indices, numVertices);
+
+                // Clusters are sorted by their position and facing, so positions have to be plain floats
+                const auto& attributes = meshPrimitive.vertexFormat->getAttributes();
+                const auto  position   = attributes.find(static_cast<int32_t>(renderer::AttributeLocation::ePosition));
+                if (options.overdrawThreshold > 0.0f && position != attributes.cend() &&
+                    position->second.vertType == renderer::VertexAttribute::Type::eFloat3)
+                {
+                    optimizeOverdraw(
+                        indices, vertices, numVertices, stride, position->second.offset, options.overdrawThreshold);
+                }
+            }
+
+            if (options.optimizeVertexFetch)
+                numVertices = optimizeVertexFetch(vertices, indices, numVertices, stride);
+
+            meshPrimitive.vertexCount = numVertices;
+            meshPrimitive.indexCount  = static_cast<uint32_t>(indices.size());
+            meshPrimitive.indexType   = options.compactIndices && numVertices <= 0x10000 ?
+                                            renderer::IndexType::eUInt16 :
+                                            renderer::IndexType::eUInt32;
+        }
+
+        // -------- mesh LODs --------
+
+        // Rossignac and Borrel, Multi-Resolution 3D Approximations for Rendering Complex Scenes: vertices snap to the
+        // vertex of their grid cell closest to the cell average, triangles that collapse (or repeat) are dropped
+        static void clusterVertices(std::span<const uint32_t>  indices,
+                                    std::span<const glm::vec3> positions,
+                                    const math::AABB&          aabb,
+                                    uint32_t                   gridSize,
+                                    std::vector<uint32_t>&     result)
+        {
+            const auto extent   = aabb.getExtent();
+            const auto cellSize = std::max(std::max(extent.x, extent.y), std::max(extent.z, 1e-6f)) / gridSize;
+
+            const auto getCell = [&](const glm::vec3& position) {
+                const auto cell = glm::min(glm::uvec3 {glm::max((position - aabb.min) / cellSize, glm::vec3 {0.0f})},
+                                           glm::uvec3 {gridSize - 1});
+                return (uint64_t {cell.z} * gridSize + cell.y) * gridSize + cell.x;
+            };
+
+            struct Cell
+            {
+                glm::vec3 sum {0.0f};
+                uint32_t  numVertices {0};
+                uint32_t  vertex {kNoVertex};
+                float     distance {std::numeric_limits<float>::max()};
+            };
+            std::unordered_map<uint64_t, uint32_t> cellIds;
+            std::vector<Cell>                      cells;
+
+            std::vector<uint32_t> vertexCells(positions.size(), kNoVertex);
+            for (const auto index : indices)
+            {
+                if (vertexCells[index] != kNoVertex)
+                    continue;
+
+                const auto [it, inserted] = cellIds.try_emplace(getCell(positions[index]), cells.size());
+                if (inserted)
+                    cells.emplace_back();
+
+                vertexCells[index] = it->second;
+                cells[it->second].sum += positions[index];
+                ++cells[it->second].numVertices;
+            }
+            for (uint32_t v = 0; v < vertexCells.size(); ++v)
+            {
+                if (vertexCells[v] == kNoVertex)
+                    continue;
+
+                auto&      cell     = cells[vertexCells[v]];
+                const auto distance = glm::distance(positions[v], cell.sum / static_cast<float>(cell.numVertices));
+                if (distance < cell.distance)
+                {
+                    cell.vertex   = v;
+                    cell.distance = distance;
+                }
+            }
+
+            result.clear();
+            std::set<std::array<uint32_t, 3>> triangles;
+            for (std::size_t i = 0; i + 2 < indices.size(); i += 3)
+            {
+                std::array<uint32_t, 3> triangle;
+                for (uint32_t k = 0; k < 3; ++k)
+                    triangle[k] = cells[vertexCells[indices[i + k]]].vertex;
+
+                if (triangle[0] == triangle[1] || triangle[1] == triangle[2] || triangle[2] == triangle[0])
+                    continue;
+
+                // Rotated to start at the smallest index, the winding stays
+                auto key = triangle;
+                std::rotate(key.begin(), std::min_element(key.begin(), key.end()), key.end());
+                if (triangles.insert(key).second)
+                    result.insert(result.end(), triangle.cbegin(), triangle.cend());
+            }
+        }
+
+        void generateLods(MeshPrimitive& meshPrimitive, const MeshLodGeneration& options)
+        {
+            VGFW_PROFILE_FUNCTION
+
+            auto& indices = meshPrimitive.indices;
+            const auto maxLods = std::min(options.maxLods, MeshLodGeneration::kMaxLods);
+            if (!meshPrimitive.vertexFormat || meshPrimitive.vertices.empty() || indices.size() % 3 != 0 || maxLods < 2)
+                return;
+
+            const auto& attributes = meshPrimitive.vertexFormat->getAttributes();
+            const auto  position   = attributes.find(static_cast<int32_t>(renderer::AttributeLocation::ePosition));
+            if (position == attributes.cend() || position->second.vertType != renderer::VertexAttribute::Type::eFloat3)
+                return;
+
+            const auto  stride = meshPrimitive.vertexFormat->getStride();
+            const auto* bytes  = reinterpret_cast<const std::byte*>(meshPrimitive.vertices.data());
+
+            std::vector<glm::vec3> positions(meshPrimitive.vertexCount);
+            for (uint32_t v = 0; v < meshPrimitive.vertexCount; ++v)
+            {
+                std::memcpy(
+                    &positions[v], bytes + std::size_t {v} * stride + position->second.offset, sizeof(glm::vec3));
+            }
+
+            const auto& aabb     = meshPrimitive.aabb;
+            const auto  extent   = aabb.getExtent();
+            const auto  diagonal = std::max(glm::length(extent), 1e-6f);
+
+            auto& lods = meshPrimitive.lods;
+            lods.assign(1, {.indexCount = meshPrimitive.indexCount});
+
+            const auto minIndices = options.minTriangles * 3;
+
+            std::vector<uint32_t> lodIndices, candidate;
+            uint32_t              maxGridSize {1024};
+            while (lods.size() < maxLods)
+            {
+                const auto& previous = lods.back();
+                const auto  target   = static_cast<uint32_t>(previous.indexCount * options.reduction);
+                const std::span<const uint32_t> source {indices.data() + previous.firstIndex, previous.indexCount};
+
+                // The finest grid that reaches the target, the triangle count grows with the grid size (mostly)
+                uint32_t lo {1}, hi {maxGridSize}, gridSize {0};
+                while (lo <= hi)
+                {
+                    const auto mid = lo + (hi - lo) / 2;
+                    clusterVertices(source, positions, aabb, mid, candidate);
+                    if (candidate.size() <= target)
+                    {
+                        gridSize = mid;
+                        lodIndices.swap(candidate);
+                        lo = mid + 1;
+                    }
+                    else
+                    {
+                        hi = mid - 1;
+                    }
+                }
+                if (gridSize == 0 || lodIndices.size() < minIndices)
+                    break;
+
+                const auto cellSize = std::max(std::max(extent.x, extent.y), extent.z) / gridSize;
+                lods.push_back({
+                    .firstIndex = static_cast<uint32_t>(indices.size()),
+                    .indexCount = static_cast<uint32_t>(lodIndices.size()),
+                    .error      = std::max(cellSize * std::sqrt(3.0f) / diagonal, previous.error),
+                });
+                indices.insert(indices.end(), lodIndices.cbegin(), lodIndices.cend());
+                maxGridSize = gridSize;
+            }
+
+            // Just the full mesh
+            if (lods.size() == 1)
+                lods.clear();
+        }
+
+        uint32_t selectLod(const MeshPrimitive& meshPrimitive, const LodSelection& selection)
+        {
+            const auto& lods = meshPrimitive.lods;
+            if (lods.size() < 2)
+                return 0;
+
+            const auto bounds = meshPrimitive.aabb.transform(meshPrimitive.modelMatrix);
+
+            // To the closest point of the box, 0 inside it
+            const auto offset   = glm::abs(selection.cameraPosition - bounds.getCenter()) - bounds.getExtent() * 0.5f;
+            const auto distance = glm::length(glm::max(offset, glm::vec3 {0.0f}));
+            if (distance <= 0.0f)
+                return 0;
+
+            const auto projectedSize = glm::length(bounds.getExtent()) * selection.projectionScale / distance;
+            const auto maxError      = selection.threshold * std::exp2(selection.bias);
+
+            uint32_t lod {0};
+            while (lod + 1 < lods.size() && lods[lod + 1].error * projectedSize <= maxError)
+                ++lod;
+            return lod;
+        }
+
+        // -------- mesh quantization --------
+
+        void quantizeMesh(MeshPrimitive& meshPrimitive, const MeshQuantization& options)
+        {
+            VGFW_PROFILE_FUNCTION
+
+            using Location = renderer::AttributeLocation;
+            using Type     = renderer::VertexAttribute::Type;
+
+            if (!meshPrimitive.vertexFormat || meshPrimitive.vertices.empty())
+                return;
+
+            const auto quantizedType = [&](int32_t location, Type type) {
+                switch (static_cast<Location>(location))
+                {
+                    case Location::ePosition:
+                        return options.positions && type == Type::eFloat3 ? Type::eShort4_Norm : type;
+                    case Location::eNormal_Color:
+                        return options.normals && type == Type::eFloat3 ? Type::eInt2_10_10_10_Rev_Norm : type;
+                    case Location::eTangent:
+                        return options.normals && type == Type::eFloat4 ? Type::eInt2_10_10_10_Rev_Norm : type;
+                    case Location::eTexCoords:
+                        return options.texCoords && type == Type::eFloat2 ? Type::eHalf2 : type;
+
+                    default:
+                        return type;
+                }
+            };
+
+            const auto& attributes = meshPrimitive.vertexFormat->getAttributes();
+
+            renderer::VertexFormat::Builder vertexFormatBuilder {};
+            renderer::VertexAttributes      quantizedAttributes;
+
+            int32_t attributeOffset {0};
+            for (const auto& [location, attribute] : attributes)
+            {
+                const renderer::VertexAttribute quantized {.vertType = quantizedType(location, attribute.vertType),
+                                                           .offset   = attributeOffset};
+                vertexFormatBuilder.setAttribute(static_cast<Location>(location), quantized);
+                quantizedAttributes.emplace(location, quantized);
+                attributeOffset += renderer::getSize(quantized.vertType);
+            }
+            if (std::equal(attributes.cbegin(),
+                           attributes.cend(),
+                           quantizedAttributes.cbegin(),
+                           [](const auto& lhs, const auto& rhs) { return lhs.second.vertType == rhs.second.vertType; }))
+                return;
+
+            // Uniform scale, so that the dequantization keeps normals perpendicular
+            const auto center = meshPrimitive.aabb.getCenter();
+            const auto extent = glm::max(meshPrimitive.aabb.max - meshPrimitive.aabb.min, glm::vec3 {0.0f});
+            const auto scale  = std::max(std::max(extent.x, extent.y), std::max(extent.z, 1e-6f)) * 0.5f;
+
+            const auto stride          = meshPrimitive.vertexFormat->getStride();
+            const auto quantizedStride = static_cast<uint32_t>(attributeOffset);
+            assert(quantizedStride % sizeof(float) == 0);
+
+            const auto numFloats = std::size_t {meshPrimitive.vertexCount} * quantizedStride / sizeof(float);
+
+            const auto*        src = reinterpret_cast<const std::byte*>(meshPrimitive.vertices.data());
+            std::vector<float> quantizedVertices(numFloats);
+            auto*              dst = reinterpret_cast<std::byte*>(quantizedVertices.data());
+
+            for (uint32_t v = 0; v < meshPrimitive.vertexCount; ++v)
+            {
+                for (const auto& [location, attribute] : attributes)
+                {
+                    const auto* in  = src + std::size_t {v} * stride + attribute.offset;
+                    auto*       out = dst + std::size_t {v} * quantizedStride + quantizedAttributes[location].offset;
+
+                    glm::vec4 value {0.0f};
+                    std::memcpy(&value, in, std::min<int32_t>(renderer::getSize(attribute.vertType), sizeof(value)));
+
+                    switch (quantizedAttributes[location].vertType)
+                    {
+                        case Type::eShort4_Norm: {
+                            const auto packed = glm::packSnorm4x16({(glm::vec3 {value} - center) / scale, 1.0f});
+                            std::memcpy(out, &packed, sizeof(packed));
+                            break;
+                        }
+                        case Type::eInt2_10_10_10_Rev_Norm: {
+                            // Tangent handedness is +-1, which 2 bits hold exactly
+                            const auto direction = glm::vec3 {value};
+                            const auto length    = glm::length(direction);
+                            const auto packed    = glm::packSnorm3x10_1x2(
+                                {length > 0.0f ? direction / length : direction, glm::sign(value.w)});
+                            std::memcpy(out, &packed, sizeof(packed));
+                            break;
+                        }
+                        case Type::eHalf2: {
+                            const auto packed = glm::packHalf2x16({value.x, value.y});
+                            std::memcpy(out, &packed, sizeof(packed));
+                            break;
+                        }
+
+                        default:
+                            std::memcpy(out, in, renderer::getSize(attribute.vertType));
+                    }
+                }
+            }
+
+            meshPrimitive.vertices.swap(quantizedVertices);
+            meshPrimitive.vertexFormat = vertexFormatBuilder.build();
+
+            const auto position = quantizedAttributes.find(static_cast<int32_t>(Location::ePosition));
+            if (position != quantizedAttributes.cend() && position->second.vertType == Type::eShort4_Norm)
+            {
+                meshPrimitive.dequantization = glm::scale(glm::translate(glm::mat4 {1.0f}, center), glm::vec3 {scale});
+                meshPrimitive.modelMatrix *= meshPrimitive.dequantization;
+
+                meshPrimitive.aabb.min = (meshPrimitive.aabb.min - center) / scale;
+                meshPrimitive.aabb.max = (meshPrimitive.aabb.max - center) / scale;
+            }
+        }
+
+        void Model::bindMeshPrimitiveTextures(uint32_t                 primitiveIndex,
+                                              uint32_t                 startUnit,
+                                              renderer::RenderContext& rc,
+                                              std::optional<GLuint>    samplerId) const
+        {
+            assert(primitiveIndex >= 0 && primitiveIndex < meshPrimitives.size());
+
+            const auto& primitive = meshPrimitives[primitiveIndex];
+
+            for (uint32_t i = 0; i < primitive.textureIndices.size(); ++i)
+            {
+                const auto& texture = *textures[primitive.textureIndices[i]];
+
+                // Bound means needed, streamed textures get their missing mips
+                io::getTextureManager().request(texture);
+                rc.bindTexture(startUnit + i, texture, samplerId);
+            }
+        }
+
+        DrawCommandBuilder::DrawCommandBuilder(renderer::RenderContext& rc) : m_RenderContext {rc} {}
+
+        DrawCommandBuilder::~DrawCommandBuilder()
+        {
+            m_RenderContext.destroy(m_CommandBuffer).destroy(m_DrawDataBuffer).destroy(m_BoundsBuffer);
+        }
+
+        DrawCommandBuilder& DrawCommandBuilder::build(const Model& model)
+        {
+            VGFW_PROFILE_FUNCTION
+
+            std::vector<const MeshPrimitive*> primitives;
+            primitives.reserve(model.meshPrimitives.size());
+            for (const auto& primitive : model.meshPrimitives)
+            {
+                if (primitive.vertexBuffer && primitive.indexBuffer && primitive.indexCount > 0)
+                    primitives.push_back(&primitive);
+            }
+
+            // Textures have to be bound per batch unless every one of them is resident
+            m_Bindless = renderer::RenderContext::hasBindlessTextures();
+
+            static const std::vector<uint32_t> kNoTextures;
+            const auto                         batchKey = [this](const MeshPrimitive* p) {
+                return std::tie(p->vertexBuffer, p->indexBuffer, m_Bindless ? kNoTextures : p->textureIndices);
+            };
+            std::stable_sort(primitives.begin(), primitives.end(), [&](const auto* lhs, const auto* rhs) {
+                return batchKey(lhs) < batchKey(rhs);
+            });
+
+            std::vector<renderer::DrawElementsIndirectCommand> commands;
+            std::vector<DrawData>                               drawData;
+            std::vector<DrawBounds>                             bounds;
+            commands.reserve(primitives.size());
+            drawData.reserve(primitives.size());
+            bounds.reserve(primitives.size());
+
+            m_Batches.clear();
+            m_Bounds.clear();
+            m_Bounds.reserve(static_cast<uint32_t>(primitives.size()));
+            for (const auto* primitive : primitives)
+            {
+                if (m_Batches.empty() || batchKey(m_Batches.back().primitive) != batchKey(primitive))
+                {
+                    m_Batches.push_back({
+                        .vertexFormat = primitive->vertexFormat.get(),
+                        .vertexBuffer = primitive->vertexBuffer.get(),
+                        .indexBuffer  = primitive->indexBuffer.get(),
+                        .primitive    = primitive,
+                        .index        = static_cast<uint32_t>(m_Batches.size()),
+                        .firstCommand = static_cast<uint32_t>(commands.size()),
+                    });
+                }
+                auto& batch = m_Batches.back();
+                ++batch.numCommands;
+
+                const auto worldBounds = primitive->aabb.transform(primitive->modelMatrix);
+                m_Bounds.add(worldBounds);
+                bounds.push_back({
+                    .center       = worldBounds.getCenter(),
+                    .batchIndex   = batch.index,
+                    .extent       = worldBounds.getExtent() * 0.5f,
+                    .firstCommand = batch.firstCommand,
+                });
+
+                commands.push_back({
+                    .count        = primitive->indexCount,
+                    .firstIndex   = primitive->firstIndex,
+                    .baseVertex   = primitive->baseVertex,
+                    .baseInstance = static_cast<uint32_t>(commands.size()),
+                });
+                auto& data = drawData.emplace_back(
+                    DrawData {.modelMatrix = primitive->modelMatrix, .material = primitive->material});
+                if (m_Bindless)
+                {
+                    const auto& material = primitive->material;
+                    const std::array slots {
+                        material.baseColorTextureIndex,
+                        material.metallicRoughnessTextureIndex,
+                        material.normalTextureIndex,
+                        material.occlusionTextureIndex,
+                        material.emissiveTextureIndex,
+                    };
+                    for (std::size_t slot = 0; slot < slots.size(); ++slot)
+                    {
+                        if (slots[slot] != -1)
+                            data.textureHandles[slot] = m_RenderContext.makeTextureResident(
+                                *model.textures[primitive->textureIndices[slots[slot]]]);
+                    }
+                }
+            }
+
+            const auto ensureCapacity = [&](renderer::Buffer& buffer, GLsizeiptr size) {
+                if (buffer.getSize() < size)
+                {
+                    m_RenderContext.destroy(buffer);
+                    buffer = renderer::RenderContext::createBuffer(size);
+                }
+            };
+
+            m_NumCommands = static_cast<uint32_t>(commands.size());
+
+            const auto commandsSize = static_cast<GLsizeiptr>(commands.size() * sizeof(commands[0]));
+            const auto drawDataSize = static_cast<GLsizeiptr>(drawData.size() * sizeof(drawData[0]));
+            const auto boundsSize   = static_cast<GLsizeiptr>(bounds.size() * sizeof(bounds[0]));
+            if (commandsSize > 0)
+            {
+                ensureCapacity(m_CommandBuffer, commandsSize);
+                ensureCapacity(m_DrawDataBuffer, drawDataSize);
+                ensureCapacity(m_BoundsBuffer, boundsSize);
+                m_RenderContext.upload(m_CommandBuffer, 0, commandsSize, commands.data())
+                    .upload(m_DrawDataBuffer, 0, drawDataSize, drawData.data())
+                    .upload(m_BoundsBuffer, 0, boundsSize, bounds.data());
+            }
+
+            VGFW_TRACE("[DrawCommandBuilder] {0} primitives recorded into {1} batches",
+                       commands.size(),
+                       m_Batches.size());
+
+            m_Primitives = std::move(primitives);
+            m_Commands   = std::move(commands);
+
+            return *this;
+        }
+
+        DrawCommandBuilder& DrawCommandBuilder::selectLods(const LodSelection& selection)
+        {
+            VGFW_PROFILE_FUNCTION
+
+            bool changed {false};
+            for (std::size_t i = 0; i < m_Commands.size(); ++i)
+            {
+                const auto* primitive = m_Primitives[i];
+                const auto  lod       = primitive->getLod(selectLod(*primitive, selection));
+
+                auto& command = m_Commands[i];
+                changed |= command.firstIndex != primitive->firstIndex + lod.firstIndex;
+                command.count      = lod.indexCount;
+                command.firstIndex = primitive->firstIndex + lod.firstIndex;
+            }
+
+            if (changed)
+            {
+                m_RenderContext.upload(m_CommandBuffer,
+                                       0,
+                                       static_cast<GLsizeiptr>(m_Commands.size() * sizeof(m_Commands[0])),
+                                       m_Commands.data());
+            }
+            return *this;
+        }
+
+        bool DrawCommandBuilder::isBindless() const { return m_Bindless; }
+
+        const std::vector<DrawBatch>& DrawCommandBuilder::getBatches() const { return m_Batches; }
+
+        uint32_t DrawCommandBuilder::getNumCommands() const { return m_NumCommands; }
+
+        const renderer::Buffer& DrawCommandBuilder::getCommandBuffer() const { return m_CommandBuffer; }
+
+        const renderer::StorageBuffer& DrawCommandBuilder::getDrawDataBuffer() const { return m_DrawDataBuffer; }
+
+        const renderer::StorageBuffer& DrawCommandBuilder::getBoundsBuffer() const { return m_BoundsBuffer; }
+
+        const culling::BoundsList& DrawCommandBuilder::getBounds() const { return m_Bounds; }
+
+        void DrawCommandBuilder::writeLayeredCommands(std::span<const uint32_t>                        viewMasks,
+                                                      std::span<renderer::DrawElementsIndirectCommand> commands) const
+        {
+            VGFW_PROFILE_FUNCTION
+            assert(viewMasks.size() == m_Commands.size() && commands.size() >= m_Commands.size());
+
+            for (std::size_t i = 0; i < m_Commands.size(); ++i)
+            {
+                commands[i]               = m_Commands[i];
+                commands[i].instanceCount = static_cast<uint32_t>(std::popcount(viewMasks[i]));
+            }
+        }
+
+        void DrawCommandBuilder::draw(const DrawBatch& batch) const { draw(batch, m_CommandBuffer); }
+
+        void DrawCommandBuilder::draw(const DrawBatch& batch, const renderer::Buffer& commandBuffer) const
+        {
+            const auto offset = GLintptr {batch.firstCommand} * sizeof(renderer::DrawElementsIndirectCommand);
+            m_RenderContext.multiDrawElementsIndirect(
+                *batch.vertexBuffer, *batch.indexBuffer, commandBuffer, batch.numCommands, offset);
+        }
+
+        void DrawCommandBuilder::draw(const DrawBatch&         batch,
+                                      const renderer::Buffer& commandBuffer,
+                                      const renderer::Buffer& countBuffer) const
+        {
+            const auto offset = GLintptr {batch.firstCommand} * sizeof(renderer::DrawElementsIndirectCommand);
+            m_RenderContext.multiDrawElementsIndirectCount(*batch.vertexBuffer,
+                                                           *batch.indexBuffer,
+                                                           commandBuffer,
+                                                           countBuffer,
+                                                           batch.numCommands,
+                                                           offset,
+                                                           GLintptr {batch.index} * sizeof(GLuint));
+        }
+    } // namespace resource
+
+    namespace io
+    {
+        struct DecodedImage
+        {
+            int32_t width {0};
+            int32_t height {0};
+            int32_t numChannels {0};
+            bool    hdr {false};
+
+            std::unique_ptr<void, void (*)(void*)> pixels {nullptr, stbi_image_free};
+        };
+
+        // Block compressed, with the mip chain it was authored with, uploaded as is
+        struct CompressedImage
+        {
+            renderer::PixelFormat pixelFormat {renderer::PixelFormat::eUnknown};
+            uint32_t              width {0};
+            uint32_t              height {0};
+
+            std::vector<std::byte>                           data;   // The whole file
+            std::vector<std::pair<std::size_t, std::size_t>> levels; // Offset and size in data, largest first
+        };
+
+        static std::size_t getTextureKey(const std::filesystem::path& texturePath)
+        {
+            return std::filesystem::hash_value(std::filesystem::absolute(texturePath));
+        }
+
+        // Safe to call from any thread
+        static DecodedImage decodeImage(const std::filesystem::path& texturePath, bool flip)
+        {
+            stbi_set_flip_vertically_on_load_thread(flip);
+
+            auto* f = stbi__fopen(texturePath.string().c_str(), "rb");
+            if (!f)
+                throw std::runtime_error("Could not open file: " + texturePath.string());
+
+            DecodedImage image {};
+            image.hdr = stbi_is_hdr_from_file(f);
+
+            auto* pixels =
+                image.hdr ?
+                    reinterpret_cast<void*>(
+                        stbi_loadf_from_file(f, &image.width, &image.height, &image.numChannels, 0)) :
+                    reinterpret_cast<void*>(stbi_load_from_file(f, &image.width, &image.height, &image.numChannels, 0));
+            fclose(f);
+            if (!pixels)
+                throw std::runtime_error("Could not decode image: " + texturePath.string());
+
+            image.pixels.reset(pixels);
+            return image;
+        }
+
+        static glm::uvec2 getMipSize(const CompressedImage& image, uint32_t level)
+        {
+            return {std::max(image.width >> level, 1u), std::max(image.height >> level, 1u)};
+        }
+
+        static bool isCompressedImage(const std::filesystem::path& texturePath)
+        {
+            const auto ext = texturePath.extension();
+            return ext == ".dds" || ext == ".ktx2";
+        }
+
+        static std::vector<std::byte> readFileAllBytes(const std::filesystem::path& filePath)
+        {
+            std::ifstream fileStream(filePath, std::ios::binary | std::ios::ate);
+            if (!fileStream.is_open())
+                throw std::runtime_error("Could not open file: " + filePath.string());
+
+            std::vector<std::byte> bytes(static_cast<std::size_t>(fileStream.tellg()));
+            fileStream.seekg(0);
+            fileStream.read(reinterpret_cast<char*>(bytes.data()), bytes.size());
+            return bytes;
+        }
+
+        template<typename T>
+        static T readPOD(std::span<const std::byte> bytes, std::size_t offset)
+        {
+            if (offset > bytes.size() || sizeof(T) > bytes.size() - offset)
+                throw std::runtime_error("Truncated file");
+
+            T value;
+            std::memcpy(&value, bytes.data() + offset, sizeof(T));
+            return value;
+        }
+
+        // Before anything is sized from the header, getMipSize shifts by the level
+        static void validateCompressedImage(const CompressedImage& image, uint32_t numLevels, const std::string& name)
+        {
+            if (image.width == 0 || image.height == 0)
+                throw std::runtime_error("Empty image file: " + name);
+            if (numLevels > renderer::calcMipLevels(std::max(image.width, image.height)))
+                throw std::runtime_error("Too many mip levels in image file: " + name);
+        }
+
+        // Levels are tightly packed, from offset on
+        static void
+        addCompressedLevels(CompressedImage& image, std::size_t offset, uint32_t numLevels, const std::string& name)
+        {
+            for (uint32_t level = 0; level < numLevels; ++level)
+            {
+                const auto mipSize = getMipSize(image, level);
+                const auto size    = static_cast<std::size_t>(renderer::calcCompressedSize(image.pixelFormat, mipSize));
+                if (offset + size > image.data.size())
+                    throw std::runtime_error("Truncated image file: " + name);
+
+                image.levels.emplace_back(offset, size);
+                offset += size;
+            }
+        }
+
+        // https://learn.microsoft.com/en-us/windows/win32/direct3ddds/dds-header, 2D textures only
+        static CompressedImage readDDS(const std::filesystem::path& texturePath)
+        {
+            constexpr uint32_t kMagic        = 0x20534444; // "DDS "
+            constexpr uint32_t kHeaderSize   = 124;
+            constexpr uint32_t kFlagMipCount = 0x20000;
+            constexpr uint32_t kFlagFourCC   = 0x4;
+            constexpr uint32_t kCaps2Cubemap = 0x200;
+            constexpr uint32_t kCaps2Volume  = 0x200000;
+
+            constexpr auto makeFourCC = [](const char (&code)[5]) {
+                return uint32_t(code[0]) | uint32_t(code[1]) << 8 | uint32_t(code[2]) << 16 | uint32_t(code[3]) << 24;
+            };
+
+            const auto name = texturePath.generic_string();
+
+            CompressedImage image {.data = readFileAllBytes(texturePath)};
+            const auto&     bytes = image.data;
+
+            if (readPOD<uint32_t>(bytes, 0) != kMagic || readPOD<uint32_t>(bytes, 4) != kHeaderSize)
+                throw std::runtime_error("Not a DDS file: " + name);
+
+            const auto flags    = readPOD<uint32_t>(bytes, 8);
+            image.height        = readPOD<uint32_t>(bytes, 12);
+            image.width         = readPOD<uint32_t>(bytes, 16);
+            const auto mipCount = readPOD<uint32_t>(bytes, 28);
+            const auto pfFlags  = readPOD<uint32_t>(bytes, 80);
+            const auto fourCC   = readPOD<uint32_t>(bytes, 84);
+            const auto caps2    = readPOD<uint32_t>(bytes, 112);
+
+            std::size_t offset = 4 + kHeaderSize;
+
+            if (caps2 & (kCaps2Cubemap | kCaps2Volume))
+                throw std::runtime_error("Only 2D DDS textures are supported: " + name);
+            if (!(pfFlags & kFlagFourCC))
+                throw std::runtime_error("Uncompressed DDS textures are not supported: " + name);
+
+            if (fourCC == makeFourCC("DXT1"))
+                image.pixelFormat = renderer::PixelFormat::eBC1_UNorm;
+            else if (fourCC == makeFourCC("DXT5"))
+                image.pixelFormat = renderer::PixelFormat::eBC3_UNorm;
+            else if (fourCC == makeFourCC("ATI2") || fourCC == makeFourCC("BC5U"))
+                image.pixelFormat = renderer::PixelFormat::eBC5_UNorm;
+            else if (fourCC == makeFourCC("DX10"))
+            {
+                // DDS_HEADER_DXT10, sRGB variants map to UNorm, like 8 bit images do
+                const auto dxgiFormat = readPOD<uint32_t>(bytes, offset);
+                const auto arraySize  = readPOD<uint32_t>(bytes, offset + 12);
+                offset += 20;
+                if (arraySize > 1)
+                    throw std::runtime_error("DDS texture arrays are not supported: " + name);
+
+                switch (dxgiFormat)
+                {
+                    case 71: // DXGI_FORMAT_BC1_UNORM
+                    case 72: // DXGI_FORMAT_BC1_UNORM_SRGB
+                        image.pixelFormat = renderer::PixelFormat::eBC1_UNorm;
+                        break;
+                    case 77: // DXGI_FORMAT_BC3_UNORM
+                    case 78: // DXGI_FORMAT_BC3_UNORM_SRGB
+                        image.pixelFormat = renderer::PixelFormat::eBC3_UNorm;
+                        break;
+                    case 83: // DXGI_FORMAT_BC5_UNORM
+                        image.pixelFormat = renderer::PixelFormat::eBC5_UNorm;
+                        break;
+                    case 98: // DXGI_FORMAT_BC7_UNORM
+                    case 99: // DXGI_FORMAT_BC7_UNORM_SRGB
+                        image.pixelFormat = renderer::PixelFormat::eBC7_UNorm;
+                        break;
+                }
+            }
+            if (image.pixelFormat == renderer::PixelFormat::eUnknown)
+                throw std::runtime_error("Unsupported DDS format: " + name);
+
+            const auto numLevels = (flags & kFlagMipCount) ? std::max(mipCount, 1u) : 1u;
+            validateCompressedImage(image, numLevels, name);
+            addCompressedLevels(image, offset, numLevels, name);
+            return image;
+        }
+
+        // https://registry.khronos.org/KTX/specs/2.0/ktxspec.v2.html, 2D textures without supercompression only
+        static CompressedImage readKTX2(const std::filesystem::path& texturePath)
+        {
+            constexpr std::array<uint8_t, 12> kIdentifier {
+                0xAB, 0x4B, 0x54, 0x58, 0x20, 0x32, 0x30, 0xBB, 0x0D, 0x0A, 0x1A, 0x0A};
+            constexpr std::size_t kLevelIndexOffset = 80;
+
+            const auto name = texturePath.generic_string();
+
+            CompressedImage image {.data = readFileAllBytes(texturePath)};
+            const auto&     bytes = image.data;
+
+            if (bytes.size() < kLevelIndexOffset || std::memcmp(bytes.data(), kIdentifier.data(), kIdentifier.size()))
+                throw std::runtime_error("Not a KTX2 file: " + name);
+
+            const auto vkFormat               = readPOD<uint32_t>(bytes, 12);
+            image.width                       = readPOD<uint32_t>(bytes, 20);
+            image.height                      = readPOD<uint32_t>(bytes, 24);
+            const auto depth                  = readPOD<uint32_t>(bytes, 28);
+            const auto layerCount             = readPOD<uint32_t>(bytes, 32);
+            const auto faceCount              = readPOD<uint32_t>(bytes, 36);
+            const auto levelCount             = std::max(readPOD<uint32_t>(bytes, 40), 1u);
+            const auto supercompressionScheme = readPOD<uint32_t>(bytes, 44);
+
+            if (depth > 0 || layerCount > 0 || faceCount != 1)
+                throw std::runtime_error("Only 2D KTX2 textures are supported: " + name);
+            // BasisLZ/UASTC need a transcoder, Zstandard/ZLIB an inflater, neither is bundled
+            if (supercompressionScheme != 0)
+                throw std::runtime_error("Supercompressed KTX2 textures are not supported: " + name);
+
+            // sRGB variants map to UNorm, like 8 bit images do
+            switch (vkFormat)
+            {
+                case 131: // VK_FORMAT_BC1_RGB_UNORM_BLOCK
+                case 132: // VK_FORMAT_BC1_RGB_SRGB_BLOCK
+                case 133: // VK_FORMAT_BC1_RGBA_UNORM_BLOCK
+                case 134: // VK_FORMAT_BC1_RGBA_SRGB_BLOCK
+                    image.pixelFormat = renderer::PixelFormat::eBC1_UNorm;
+                    break;
+                case 137: // VK_FORMAT_BC3_UNORM_BLOCK
+                case 138: // VK_FORMAT_BC3_SRGB_BLOCK
+                    image.pixelFormat = renderer::PixelFormat::eBC3_UNorm;
+                    break;
+                case 141: // VK_FORMAT_BC5_UNORM_BLOCK
+                    image.pixelFormat = renderer::PixelFormat::eBC5_UNorm;
+                    break;
+                case 145: // VK_FORMAT_BC7_UNORM_BLOCK
+                case 146: // VK_FORMAT_BC7_SRGB_BLOCK
+                    image.pixelFormat = renderer::PixelFormat::eBC7_UNorm;
+                    break;
+
+                default:
+                    throw std::runtime_error("Unsupported KTX2 format: " + name);
+            }
+
+            validateCompressedImage(image, levelCount, name);
+
+            // Unlike DDS, each level has its own offset, the smallest level usually comes first in the file
+            for (uint32_t level = 0; level < levelCount; ++level)
+            {
+                const auto entry  = kLevelIndexOffset + level * 3 * sizeof(uint64_t);
+                const auto offset = static_cast<std::size_t>(readPOD<uint64_t>(bytes, entry));
+                const auto size   = static_cast<std::size_t>(readPOD<uint64_t>(bytes, entry + sizeof(uint64_t)));
+
+                const auto mipSize = getMipSize(image, level);
+                if (offset > bytes.size() || size > bytes.size() - offset ||
+                    size < static_cast<std::size_t>(renderer::calcCompressedSize(image.pixelFormat, mipSize)))
+                    throw std::runtime_error("Truncated image file: " + name);
+
+                image.levels.emplace_back(offset, size);
+            }
+            return image;
+        }
+
+        // Safe to call from any thread
+        static CompressedImage readCompressedImage(const std::filesystem::path& texturePath)
+        {
+            return texturePath.extension() == ".dds" ? readDDS(texturePath) : readKTX2(texturePath);
+        }
+
+        static void setupTexture(renderer::Texture& texture, renderer::RenderContext& rc)
+        {
+            rc.setupSampler(texture,
+                            {
+                                .minFilter     = renderer::TexelFilter::eLinear,
+                                .mipmapMode    = renderer::MipmapMode::eLinear,
+                                .magFilter     = renderer::TexelFilter::eLinear,
+                                .maxAnisotropy = 16.0f,
+                            });
+
+            if (renderer::RenderContext::hasBindlessTextures())
+                rc.makeTextureResident(texture);
+        }
+
+        // From firstLevel down to the smallest mip
+        static renderer::Texture
+        createTexture(const CompressedImage& image, uint32_t firstLevel, renderer::RenderContext& rc)
+        {
+            assert(firstLevel < image.levels.size());
+
+            const auto extent  = getMipSize(image, firstLevel);
+            auto       texture = rc.createTexture2D({extent.x, extent.y},
+                                              image.pixelFormat,
+                                              static_cast<uint32_t>(image.levels.size()) - firstLevel);
+            for (uint32_t level = firstLevel; level < image.levels.size(); ++level)
+            {
+                const auto [offset, size] = image.levels[level];
+                rc.upload(texture,
+                          level - firstLevel,
+                          getMipSize(image, level),
+                          renderer::CompressedImageData {
+                              .data = image.data.data() + offset,
+                              .size = static_cast<GLsizei>(size),
+                          });
+            }
+            return texture;
+        }
+
+        struct TextureManager::StreamedImage
+        {
+            std::size_t                    key {0};
+            std::optional<CompressedImage> image; // Empty when the read failed
+        };
+
+        void TextureManager::setPolicy(const Policy& policy)
+        {
+            std::unique_lock lock {m_Mutex};
+            m_Policy = policy;
+        }
+        TextureManager::Policy TextureManager::getPolicy() const
+        {
+            std::shared_lock lock {m_Mutex};
+            return m_Policy;
+        }
+
+        TextureHandle TextureManager::find(const std::filesystem::path& texturePath) const
+        {
+            const auto key = getTextureKey(texturePath);
+
+            std::shared_lock lock {m_Mutex};
+            const auto*      entry = m_Entries.find(key);
+            return entry ? entry->texture : nullptr;
+        }
+
+        TextureHandle TextureManager::add(const std::filesystem::path& texturePath,
+                                          renderer::Texture&&          texture,
+                                          renderer::RenderContext&     rc,
+                                          uint32_t                     numStreamedMips)
+        {
+            const auto key = getTextureKey(texturePath);
+
+            std::unique_lock lock {m_Mutex};
+            auto&            entry = m_Entries[key];
+            if (entry.texture)
+            {
+                // Another load was first (e.g. two models decoding the same image)
+                rc.destroy(texture);
+                return entry.texture;
+            }
+
+            setupTexture(texture, rc);
+            entry = {
+                .path            = texturePath,
+                .texture         = std::make_shared<renderer::Texture>(std::move(texture)),
+                .numStreamedMips = numStreamedMips,
+            };
+            entry.size = renderer::calcTextureSize(*entry.texture);
+
+            ++m_Stats.numTextures;
+            m_Stats.residentBytes += entry.size;
+            if (numStreamedMips > 0)
+            {
+                m_StreamedKeys.emplace(entry.texture.get(), key);
+                ++m_NumStreamed;
+                ++m_Stats.numStreaming;
+            }
+
+            VGFW_TRACE("[IO] Loaded texture: {0}", texturePath.generic_string());
+
+            return entry.texture;
+        }
+
+        void TextureManager::request(const renderer::Texture& texture)
+        {
+            if (m_NumStreamed.load(std::memory_order_relaxed) == 0)
+                return;
+
+            // Bindings call this every draw, most textures are not streamed or already requested
+            std::size_t key {0};
+            {
+                std::shared_lock lock {m_Mutex};
+                const auto       it = m_StreamedKeys.find(&texture);
+                if (it == m_StreamedKeys.cend())
+                    return;
+                if (const auto* entry = m_Entries.find(it->second); entry->requested || entry->streaming)
+                    return;
+                key = it->second;
+            }
+
+            std::unique_lock lock {m_Mutex};
+            // Streamed in or evicted in between
+            auto* entry = m_Entries.find(key);
+            if (entry && entry->texture.get() == &texture && entry->numStreamedMips > 0)
+                entry->requested = true;
+        }
+
+        void TextureManager::update(renderer::RenderContext& rc)
+        {
+            VGFW_PROFILE_FUNCTION
+
+            std::vector<std::shared_ptr<StreamedImage>> streamedImages;
+            {
+                std::lock_guard lock {m_StreamMutex};
+                streamedImages.swap(m_StreamedImages);
+            }
+
+            std::unique_lock lock {m_Mutex};
+            ++m_FrameIndex;
+
+            // The full texture replaces the low mips in place, so the handles (and Texture pointers) stay valid
+            for (const auto& streamed : streamedImages)
+            {
+                auto* entry = m_Entries.find(streamed->key);
+                if (!entry || !entry->streaming) // Evicted (or replaced) in the meantime
+                    continue;
+
+                if (streamed->image)
+                {
+                    auto texture = createTexture(*streamed->image, 0, rc);
+                    setupTexture(texture, rc);
+                    rc.destroy(*entry->texture);
+                    *entry->texture = std::move(texture);
+
+                    const auto size = renderer::calcTextureSize(*entry->texture);
+                    m_Stats.residentBytes += size - entry->size;
+                    entry->size = size;
+                    ++m_Stats.numStreamedIn;
+                }
+
+                // A failed read is not retried, the texture keeps its low mips
+                m_StreamedKeys.erase(entry->texture.get());
+                entry->numStreamedMips = 0;
+                entry->streaming       = false;
+                --m_NumStreamed;
+                --m_Stats.numStreaming;
+            }
+
+            GLsizeiptr pendingBytes {0};
+            m_Entries.forEach([this, &pendingBytes](std::size_t key, Entry& entry) {
+                if (!entry.requested || entry.streaming)
+                    return;
+
+                // Each mip level is a quarter of the one above it
+                const auto fullSize = entry.size << (2 * entry.numStreamedMips);
+                if (m_Policy.budget > 0 && m_Stats.residentBytes + pendingBytes + fullSize > m_Policy.budget)
+                    return;
+
+                pendingBytes += fullSize;
+                streamIn(key, entry);
+            });
+
+            evict(rc);
+        }
+
+        void TextureManager::clear(renderer::RenderContext& rc)
+        {
+            std::unique_lock lock {m_Mutex};
+            m_Entries.forEach([&rc](std::size_t, Entry& entry) { rc.destroy(*entry.texture); });
+            m_Entries.clear();
+            m_StreamedKeys.clear();
+            m_NumStreamed = 0;
+            m_Stats       = {};
+        }
+
+        TextureManager::Stats TextureManager::getStats() const
+        {
+            std::shared_lock lock {m_Mutex};
+            return m_Stats;
+        }
+
+        void TextureManager::streamIn(std::size_t key, Entry& entry)
+        {
+            entry.requested = false;
+            entry.streaming = true;
+
+            m_Pool.submit([this, key, texturePath = entry.path] {
+                auto streamed = std::make_shared<StreamedImage>(key);
+                try
+                {
+                    streamed->image = readCompressedImage(texturePath);
+                }
+                catch (const std::exception& e)
+                {
+                    VGFW_WARN("[IO] Could not stream texture {0}: {1}", texturePath.generic_string(), e.what());
+                }
+
+                std::lock_guard lock {m_StreamMutex};
+                m_StreamedImages.push_back(std::move(streamed));
+            });
+        }
+
+        void TextureManager::evict(renderer::RenderContext& rc)
+        {
+            m_Stats.numUnused   = 0;
+            m_Stats.unusedBytes = 0;
 
-                // fill tangent
-                if (hasTangent)
+            // Only the manager holds it, nobody else can get a handle without the lock
+            std::vector<std::pair<uint64_t, Entry*>> unused; // {unusedSince, entry}
+            m_Entries.forEach([this, &unused](std::size_t, Entry& entry) {
+                if (entry.texture.use_count() > 1)
                 {
-                    vertices.push_back(record.tangents[v].x);
-                    vertices.push_back(record.tangents[v].y);
-                    vertices.push_back(record.tangents[v].z);
-                    vertices.push_back(record.tangents[v].w);
+                    entry.unusedSince = 0;
+                    return;
                 }
-            }
+                if (entry.unusedSince == 0)
+                    entry.unusedSince = m_FrameIndex;
+
+                ++m_Stats.numUnused;
+                m_Stats.unusedBytes += entry.size;
+                unused.emplace_back(entry.unusedSince, &entry);
+            });
 
-            // Load index buffer & vertex buffer
-            auto indexBuf  = rc.createIndexBuffer(renderer::IndexType::eUInt32, indices.size(), indices.data());
-            auto vertexBuf = rc.createVertexBuffer(vertexFormat->getStride(), vertexCount, vertices.data());
+            const auto isOverBudget = [this] {
+                return m_Stats.unusedBytes > m_Policy.maxUnusedBytes ||
+                       (m_Policy.budget > 0 && m_Stats.residentBytes > m_Policy.budget);
+            };
+            if (unused.empty() || !isOverBudget())
+                return;
 
-            indexBuffer  = std::shared_ptr<renderer::IndexBuffer>(new renderer::IndexBuffer {std::move(indexBuf)},
-                                                                 renderer::RenderContext::ResourceDeleter {rc});
-            vertexBuffer = std::shared_ptr<renderer::VertexBuffer>(new renderer::VertexBuffer {std::move(vertexBuf)},
-                                                                   renderer::RenderContext::ResourceDeleter {rc});
+            // Least recently used first, i.e. the first to lose its last handle
+            std::sort(unused.begin(), unused.end(), [](const auto& a, const auto& b) { return a.first < b.first; });
 
-            // Load material buffer
-            auto materialBuf = rc.createBuffer(sizeof(PrimitiveMaterial), &material);
-            materialBuffer   = std::shared_ptr<renderer::Buffer>(new renderer::Buffer {std::move(materialBuf)},
-                                                               renderer::RenderContext::ResourceDeleter {rc});
+            std::size_t numEvicted {0};
+            for (; numEvicted < unused.size() && isOverBudget(); ++numEvicted)
+            {
+                auto& entry = *unused[numEvicted].second;
+                if (entry.numStreamedMips > 0)
+                {
+                    m_StreamedKeys.erase(entry.texture.get());
+                    --m_NumStreamed;
+                    --m_Stats.numStreaming;
+                }
+                rc.destroy(*entry.texture);
+                entry.texture = nullptr; // Marks it for the erase below
+
+                --m_Stats.numTextures;
+                --m_Stats.numUnused;
+                m_Stats.residentBytes -= entry.size;
+                m_Stats.unusedBytes -= entry.size;
+                ++m_Stats.numEvictions;
+            }
+
+            if (numEvicted > 0)
+                m_Entries.eraseIf([](std::size_t, const Entry& entry) { return !entry.texture; });
         }
 
-        void MeshPrimitive::draw(renderer::RenderContext& rc) const
+        TextureManager& getTextureManager()
         {
-            assert(vertexBuffer && indexBuffer);
-            rc.draw(*vertexBuffer, *indexBuffer, indexCount, vertexCount);
+            static TextureManager textureManager;
+            return textureManager;
         }
 
-        void Model::bindMeshPrimitiveTextures(uint32_t                 primitiveIndex,
-                                              uint32_t                 startUnit,
-                                              renderer::RenderContext& rc,
-                                              std::optional<GLuint>    samplerId) const
+        static TextureHandle createTexture(const std::filesystem::path& texturePath,
+                                           const CompressedImage&       image,
+                                           renderer::RenderContext&     rc)
         {
-            assert(primitiveIndex >= 0 && primitiveIndex < meshPrimitives.size());
+            auto& textureManager = getTextureManager();
 
-            const auto& primitive = meshPrimitives[primitiveIndex];
+            // Another load may have created it while this one was reading
+            if (auto texture = textureManager.find(texturePath))
+                return texture;
 
-            for (uint32_t i = 0; i < primitive.textureIndices.size(); ++i)
+            // Streamed textures start at the first mip that fits the base size
+            const auto getMaxDimension = [](glm::uvec2 size) { return std::max(size.x, size.y); };
+            const auto baseSize = textureManager.getPolicy().streamingBaseSize;
+            uint32_t   firstLevel {0};
+            if (baseSize > 0 && !renderer::RenderContext::hasBindlessTextures())
             {
-                rc.bindTexture(startUnit + i, *textures[primitive.textureIndices[i]], samplerId);
+                const auto numLevels = static_cast<uint32_t>(image.levels.size());
+                while (firstLevel + 1 < numLevels && getMaxDimension(getMipSize(image, firstLevel)) > baseSize)
+                    ++firstLevel;
             }
+
+            return textureManager.add(texturePath, createTexture(image, firstLevel, rc), rc, firstLevel);
         }
-    } // namespace resource
 
-    namespace io
-    {
-        renderer::Texture* loadTexture(const std::filesystem::path& texturePath, renderer::RenderContext& rc, bool flip)
+        static TextureHandle
+        createTexture(const std::filesystem::path& texturePath, const DecodedImage& image, renderer::RenderContext& rc)
         {
-            if (texturePath.empty())
-            {
-                return nullptr;
-            }
-
-            auto       p = std::filesystem::absolute(texturePath);
-            const auto h = std::filesystem::hash_value(p);
-            if (auto it = g_TextureCache.find(h); it != g_TextureCache.cend())
-            {
-                auto extent = it->second->getExtent();
-                assert(extent.width > 0 && extent.height > 0);
-
-                return it->second;
-            }
-
-            stbi_set_flip_vertically_on_load(flip);
-
-            auto* f = stbi__fopen(texturePath.string().c_str(), "rb");
-            assert(f);
-
-            const auto hdr = stbi_is_hdr_from_file(f);
+            // Another load may have created it while this one was decoding
+            if (auto texture = getTextureManager().find(texturePath))
+                return texture;
 
-            int32_t width, height, numChannels;
-            auto*   pixels = hdr ? reinterpret_cast<void*>(stbi_loadf_from_file(f, &width, &height, &numChannels, 0)) :
-                                   reinterpret_cast<void*>(stbi_load_from_file(f, &width, &height, &numChannels, 0));
-            fclose(f);
-            assert(pixels);
+            const auto& [width, height, numChannels, hdr, pixels] = image;
 
             renderer::ImageData imageData {
                 .dataType = static_cast<GLenum>(hdr ? GL_FLOAT : GL_UNSIGNED_BYTE),
-                .pixels   = pixels,
+                .pixels   = pixels.get(),
             };
             renderer::PixelFormat pixelFormat {renderer::PixelFormat::eUnknown};
             switch (numChannels)
@@ -3609,62 +9012,635 @@ namespace vgfw
                     assert(false);
             }
 
-            uint32_t numMipLevels {1u};
-            if (math::isPowerOf2(width) && math::isPowerOf2(height))
-                numMipLevels = renderer::calcMipLevels(glm::max(width, height));
+            // Non power of two sizes round down per level, which GL 4.5 handles fine
+            const auto numMipLevels = renderer::calcMipLevels(glm::max(width, height));
 
             auto texture = rc.createTexture2D(
                 {static_cast<uint32_t>(width), static_cast<uint32_t>(height)}, pixelFormat, numMipLevels);
-            rc.upload(texture, 0, {width, height}, imageData)
-                .setupSampler(texture,
-                              {
-                                  .minFilter     = renderer::TexelFilter::eLinear,
-                                  .mipmapMode    = renderer::MipmapMode::eLinear,
-                                  .magFilter     = renderer::TexelFilter::eLinear,
-                                  .maxAnisotropy = 16.0f,
-                              });
-            stbi_image_free(pixels);
+            rc.upload(texture, 0, {width, height}, imageData);
 
             if (numMipLevels > 1)
                 rc.generateMipmaps(texture);
 
-            auto* newTexture  = new renderer::Texture {std::move(texture)};
-            g_TextureCache[h] = newTexture;
+            return getTextureManager().add(texturePath, std::move(texture), rc);
+        }
+
+        TextureHandle loadTexture(const std::filesystem::path& texturePath, renderer::RenderContext& rc, bool flip)
+        {
+            if (texturePath.empty())
+            {
+                return nullptr;
+            }
+
+            if (auto texture = getTextureManager().find(texturePath))
+                return texture;
 
-            VGFW_TRACE("[IO] Loaded texture: {0}", texturePath.generic_string());
+            if (isCompressedImage(texturePath))
+            {
+                // Flipping would mean swizzling every block, DDS/KTX2 files are expected to be authored top-down
+                if (flip)
+                    VGFW_WARN("[IO] Block compressed textures are not flipped: {0}", texturePath.generic_string());
+                return createTexture(texturePath, readCompressedImage(texturePath), rc);
+            }
+            return createTexture(texturePath, decodeImage(texturePath, flip), rc);
+        }
 
-            return newTexture;
+        static void setupMeshPrimitive(resource::Model& model, uint32_t index, const glm::vec3& scale)
+        {
+            auto& meshPrimitive             = model.meshPrimitives[index];
+            meshPrimitive.ownerModel        = &model;
+            meshPrimitive.indexInOwnerModel = index;
+            meshPrimitive.modelMatrix       = glm::scale(glm::mat4(1.0), scale) * meshPrimitive.dequantization;
         }
 
-        void releaseTexture(const std::filesystem::path& texturePath,
-                            renderer::Texture&           texture,
-                            renderer::RenderContext&     rc)
+        // -------- baked models --------
+        // Native endianness and struct layout, the cache belongs to the machine (and build) that wrote it. Offsets
+        // are from the start of the file, geometry is 16 byte aligned so that it can be handed to GL as mapped.
+
+        static std::filesystem::path g_ModelCacheDirectory;
+
+        void setModelCacheDirectory(const std::filesystem::path& directory)
         {
-            if (texturePath.empty())
+            g_ModelCacheDirectory.clear();
+            if (directory.empty())
+                return;
+
+            std::error_code ec;
+            std::filesystem::create_directories(directory, ec);
+            if (ec)
             {
+                VGFW_WARN(
+                    "[IO] Could not create model cache directory {0}: {1}", directory.generic_string(), ec.message());
                 return;
             }
 
-            auto       p = std::filesystem::absolute(texturePath);
-            const auto h = std::filesystem::hash_value(p);
-            if (auto it = g_TextureCache.find(h); it != g_TextureCache.cend())
+            g_ModelCacheDirectory = directory;
+            VGFW_TRACE("[IO] Model cache directory: {0}", directory.generic_string());
+        }
+
+        struct BakedString
+        {
+            uint64_t offset {0};
+            uint32_t length {0};
+        };
+
+        // Size, write time and hash of a file the model was baked from
+        struct BakedSourceFile
+        {
+            uint64_t size {0};
+            int64_t  time {0};
+            uint64_t hash {0};
+        };
+
+        struct BakedDependency
+        {
+            BakedString     path; // Relative to the model directory
+            BakedSourceFile file;
+        };
+
+        struct BakedModelHeader
+        {
+            static constexpr uint32_t kMagic {0x4D424756}; // "VGBM"
+            static constexpr uint32_t kVersion {5};
+
+            uint32_t magic {0}; // Written last, a partially written file is never valid
+            uint32_t version {kVersion};
+
+            BakedSourceFile source; // The model file
+            // Of the Model settings that change the baked geometry
+            uint64_t settingsHash {0};
+
+            uint32_t numDependencies {0}; // Files the model file refers to, e.g. glTF buffers
+            uint32_t numTextures {0};
+            uint32_t numMaterials {0};
+            uint32_t numFormats {0};
+            uint32_t numPrimitives {0};
+
+            uint64_t dependenciesOffset {0}; // BakedDependency[numDependencies]
+            uint64_t texturesOffset {0};     // BakedString[numTextures], relative to the model directory
+            uint64_t materialsOffset {0};
+            uint64_t formatsOffset {0};
+            uint64_t primitivesOffset {0};
+        };
+
+        struct BakedVertexFormat
+        {
+            struct Attribute
             {
-                rc.destroy(texture);
-                g_TextureCache.erase(h);
+                int32_t                         location;
+                renderer::VertexAttribute::Type type;
+                int32_t                         offset;
+            };
+            uint32_t                  numAttributes {0};
+            std::array<Attribute, 16> attributes {};
+        };
+
+        struct BakedPrimitive
+        {
+            BakedString name;
+
+            uint32_t            formatIndex {0};
+            uint32_t            vertexCount {0};
+            uint32_t            indexCount {0};
+            uint32_t            numStoredIndices {0}; // Of every LOD
+            renderer::IndexType indexType {renderer::IndexType::eUInt32}; // Of the GPU copy, baked as 32-bit
+            int32_t             materialIndex {-1};
+
+            resource::PrimitiveMaterial material {};
+            uint32_t                    numTextureIndices {0};
+            std::array<uint32_t, 5>     textureIndices {};
+
+            uint32_t                          numLods {0};
+            std::array<resource::MeshLod, 8> lods {};
+
+            math::AABB aabb {};
+            glm::mat4  dequantization {1.0f};
+
+            uint64_t vertexOffset {0}; // Blobs of one vertex format are adjacent
+            uint64_t indexOffset {0};
+        };
+        static_assert(std::is_trivially_copyable_v<BakedModelHeader> && std::is_trivially_copyable_v<BakedPrimitive>);
+        // The size is part of the file layout, bump BakedModelHeader::kVersion along with it
+        static_assert(std::tuple_size_v<decltype(BakedPrimitive::lods)> >= resource::MeshLodGeneration::kMaxLods,
+                      "A baked primitive has to hold every generated LOD");
+
+        struct BakedModel
+        {
+            explicit BakedModel(const std::filesystem::path& path) : file {path} {}
+
+            utils::MappedFile file;
+
+            std::vector<std::string>                              texturePaths;
+            std::vector<resource::Material>                       materials;
+            std::vector<std::shared_ptr<renderer::VertexFormat>> formats;
+            std::vector<BakedPrimitive>                           primitives;
+
+            const void*               getVertices(const BakedPrimitive&) const;
+            std::span<const uint32_t> getIndices(const BakedPrimitive&) const;
+        };
+
+        const void* BakedModel::getVertices(const BakedPrimitive& primitive) const
+        {
+            return file.getData().data() + primitive.vertexOffset;
+        }
+        std::span<const uint32_t> BakedModel::getIndices(const BakedPrimitive& primitive) const
+        {
+            return {reinterpret_cast<const uint32_t*>(file.getData().data() + primitive.indexOffset),
+                    primitive.numStoredIndices};
+        }
+
+        // FNV-1a, stable across runs and standard libraries, unlike std::hash
+        static uint64_t hashFile(const std::filesystem::path& filePath)
+        {
+            const utils::MappedFile file {filePath};
+
+            uint64_t h {0xcbf29ce484222325};
+            for (const auto byte : file.getData())
+                h = (h ^ static_cast<uint64_t>(byte)) * 0x100000001b3;
+            return h;
+        }
+
+        static uint64_t getSettingsHash(const resource::Model& model)
+        {
+            const auto& optimization = model.meshOptimization;
+            const auto& quantization = model.meshQuantization;
+
+            std::size_t h {0};
+            if (optimization.enabled)
+            {
+                utils::hashCombine(h,
+                                   optimization.weldVertices,
+                                   optimization.optimizeVertexCache,
+                                   optimization.overdrawThreshold,
+                                   optimization.optimizeVertexFetch,
+                                   optimization.compactIndices);
             }
+            if (quantization.enabled)
+                utils::hashCombine(h, quantization.normals, quantization.texCoords, quantization.positions);
+            if (model.meshLods.enabled)
+                utils::hashCombine(h, model.meshLods.maxLods, model.meshLods.reduction, model.meshLods.minTriangles);
+            return h;
         }
 
-        bool loadOBJ(const std::filesystem::path& modelPath,
-                     resource::Model&             model,
-                     renderer::RenderContext&     rc,
-                     const glm::vec3&             scale)
+        // One file per model and settings, so that loaders with different settings do not replace each other's bake
+        static std::filesystem::path getBakedModelPath(const std::filesystem::path& modelPath,
+                                                       const resource::Model&       model)
+        {
+            const auto key = std::filesystem::hash_value(std::filesystem::absolute(modelPath));
+            return g_ModelCacheDirectory /
+                   (std::to_string(key) + "-" + std::to_string(getSettingsHash(model)) + ".vgbm");
+        }
+
+        static int64_t getSourceTime(const std::filesystem::path& filePath)
+        {
+            return std::filesystem::last_write_time(filePath).time_since_epoch().count();
+        }
+
+        static BakedSourceFile getSourceFile(const std::filesystem::path& filePath)
+        {
+            return {
+                .size = std::filesystem::file_size(filePath),
+                .time = getSourceTime(filePath),
+                .hash = hashFile(filePath),
+            };
+        }
+
+        // A touched but unchanged file (e.g. by a checkout) is still current, it is only hashed then
+        static bool isSourceFileCurrent(const std::filesystem::path& filePath, const BakedSourceFile& baked)
+        {
+            std::error_code ec;
+            const auto      size = std::filesystem::file_size(filePath, ec);
+            if (ec || size != baked.size)
+                return false;
+            return baked.time == getSourceTime(filePath) || baked.hash == hashFile(filePath);
+        }
+
+        // Without overflowing on offsets read from a corrupt file
+        static bool isInFile(std::span<const std::byte> bytes, uint64_t offset, uint64_t size)
+        {
+            return offset <= bytes.size() && size <= bytes.size() - offset;
+        }
+
+        static std::string readBakedString(std::span<const std::byte> bytes, const BakedString& string)
+        {
+            if (!isInFile(bytes, string.offset, string.length))
+                throw std::runtime_error("Truncated file");
+            return std::string {reinterpret_cast<const char*>(bytes.data() + string.offset), string.length};
+        }
+
+        static bool readBakedTables(BakedModel& baked)
+        {
+            const auto bytes  = baked.file.getData();
+            const auto header = readPOD<BakedModelHeader>(bytes, 0);
+
+            for (uint32_t i = 0; i < header.numTextures; ++i)
+            {
+                const auto path = readPOD<BakedString>(bytes, header.texturesOffset + i * sizeof(BakedString));
+                baked.texturePaths.push_back(readBakedString(bytes, path));
+            }
+            // Texture indices are -1 or index Model::textures
+            const auto isTextureIndex = [&header](int index) {
+                return index >= -1 && index < static_cast<int64_t>(header.numTextures);
+            };
+            for (uint32_t i = 0; i < header.numMaterials; ++i)
+            {
+                const auto material =
+                    readPOD<resource::Material>(bytes, header.materialsOffset + i * sizeof(resource::Material));
+                if (!isTextureIndex(material.baseColorTextureIndex) ||
+                    !isTextureIndex(material.metallicRoughnessTextureIndex) ||
+                    !isTextureIndex(material.normalTextureIndex) || !isTextureIndex(material.occlusionTextureIndex) ||
+                    !isTextureIndex(material.emissiveTextureIndex))
+                    return false;
+                baked.materials.push_back(material);
+            }
+            for (uint32_t i = 0; i < header.numFormats; ++i)
+            {
+                const auto format =
+                    readPOD<BakedVertexFormat>(bytes, header.formatsOffset + i * sizeof(BakedVertexFormat));
+
+                renderer::VertexFormat::Builder builder;
+                for (uint32_t a = 0; a < std::min<std::size_t>(format.numAttributes, format.attributes.size()); ++a)
+                {
+                    const auto& [location, type, offset] = format.attributes[a];
+                    builder.setAttribute(static_cast<renderer::AttributeLocation>(location),
+                                         {.vertType = type, .offset = offset});
+                }
+                baked.formats.push_back(builder.build());
+            }
+            for (uint32_t i = 0; i < header.numPrimitives; ++i)
+            {
+                const auto primitive =
+                    readPOD<BakedPrimitive>(bytes, header.primitivesOffset + i * sizeof(BakedPrimitive));
+                if (primitive.formatIndex >= baked.formats.size() ||
+                    primitive.numTextureIndices > primitive.textureIndices.size() ||
+                    primitive.numLods > primitive.lods.size() || (primitive.indexType != renderer::IndexType::eUInt16 &&
+                                                                  primitive.indexType != renderer::IndexType::eUInt32))
+                    return false;
+
+                // Everything applyBakedModel and the upload index with
+                if (!isInFile(bytes, primitive.name.offset, primitive.name.length) || primitive.materialIndex < -1 ||
+                    primitive.materialIndex >= static_cast<int64_t>(header.numMaterials))
+                    return false;
+
+                const auto textureIndices = std::span {primitive.textureIndices}.first(primitive.numTextureIndices);
+                if (std::ranges::any_of(textureIndices,
+                                        [&header](uint32_t index) { return index >= header.numTextures; }))
+                    return false;
+
+                // Slots of the primitive material index its texture indices
+                const auto isSlot = [&primitive](int slot) {
+                    return slot >= -1 && slot < static_cast<int64_t>(primitive.numTextureIndices);
+                };
+                const auto& material = primitive.material;
+                if (!isSlot(material.baseColorTextureIndex) || !isSlot(material.metallicRoughnessTextureIndex) ||
+                    !isSlot(material.normalTextureIndex) || !isSlot(material.occlusionTextureIndex) ||
+                    !isSlot(material.emissiveTextureIndex))
+                    return false;
+
+                const auto isIndexRange = [&primitive](uint64_t firstIndex, uint64_t indexCount) {
+                    return firstIndex + indexCount <= primitive.numStoredIndices;
+                };
+                if (!isIndexRange(0, primitive.indexCount))
+                    return false;
+                for (uint32_t lod = 0; lod < primitive.numLods; ++lod)
+                {
+                    if (!isIndexRange(primitive.lods[lod].firstIndex, primitive.lods[lod].indexCount))
+                        return false;
+                }
+
+                const auto stride     = baked.formats[primitive.formatIndex]->getStride();
+                const auto vertexSize = uint64_t {primitive.vertexCount} * stride;
+                const auto indexSize  = uint64_t {primitive.numStoredIndices} * sizeof(uint32_t);
+                if (!isInFile(bytes, primitive.vertexOffset, vertexSize) ||
+                    !isInFile(bytes, primitive.indexOffset, indexSize) || primitive.indexOffset % alignof(uint32_t))
+                    return false;
+
+                baked.primitives.push_back(primitive);
+            }
+            return true;
+        }
+
+        // @return nullptr when there is no cache, or when the source (or the model settings) changed since it was baked
+        static std::shared_ptr<BakedModel> openBakedModel(const std::filesystem::path& modelPath,
+                                                          const resource::Model&       model)
+        {
+            if (g_ModelCacheDirectory.empty())
+                return nullptr;
+
+            const auto bakedPath = getBakedModelPath(modelPath, model);
+            auto       baked     = std::make_shared<BakedModel>(bakedPath);
+            if (!baked->file)
+                return nullptr;
+
+            try
+            {
+                const auto bytes  = baked->file.getData();
+                const auto header = readPOD<BakedModelHeader>(bytes, 0);
+                if (header.magic != BakedModelHeader::kMagic || header.version != BakedModelHeader::kVersion ||
+                    header.settingsHash != getSettingsHash(model) || !isSourceFileCurrent(modelPath, header.source))
+                    throw std::runtime_error("Stale");
+
+                // External geometry (e.g. a .bin next to a .gltf) changes without the model file
+                for (uint32_t i = 0; i < header.numDependencies; ++i)
+                {
+                    const auto dependency =
+                        readPOD<BakedDependency>(bytes, header.dependenciesOffset + i * sizeof(BakedDependency));
+                    if (!isSourceFileCurrent(modelPath.parent_path() / readBakedString(bytes, dependency.path),
+                                             dependency.file))
+                        throw std::runtime_error("Stale");
+                }
+
+                if (!readBakedTables(*baked))
+                    throw std::runtime_error("Corrupted");
+            }
+            catch (const std::exception& e)
+            {
+                VGFW_TRACE("[IO] Discarding baked model {0}: {1}", bakedPath.generic_string(), e.what());
+                return nullptr;
+            }
+
+            VGFW_TRACE("[IO] Mapped baked model: {0}", bakedPath.generic_string());
+            return baked;
+        }
+
+        // Model primitives must still hold their CPU data, i.e. be prepared but not uploaded. dependencies are the
+        // files the model file refers to (relative to its directory), a change to any of them invalidates the bake
+        static void bakeModel(const std::filesystem::path&              modelPath,
+                              const resource::Model&                    model,
+                              const std::vector<std::filesystem::path>& texturePaths,
+                              const std::vector<std::filesystem::path>& dependencies)
+        {
+            if (g_ModelCacheDirectory.empty())
+                return;
+
+            const auto bakedPath = getBakedModelPath(modelPath, model);
+
+            // A bake that could not be checked for staleness would be served forever
+            std::vector<BakedSourceFile> dependencyFiles;
+            try
+            {
+                for (const auto& dependency : dependencies)
+                    dependencyFiles.push_back(getSourceFile(modelPath.parent_path() / dependency));
+            }
+            catch (const std::exception& e)
+            {
+                VGFW_WARN("[IO] Not baking {0}: {1}", modelPath.generic_string(), e.what());
+                return;
+            }
+
+            // Written next to it and renamed into place: a live BakedModel may still map the previous file, which
+            // must not be truncated under it. Unique per thread, concurrent loaders may bake the same model
+            auto tempPath = bakedPath;
+            tempPath += ".tmp" + std::to_string(std::hash<std::thread::id> {}(std::this_thread::get_id()));
+
+            std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+            if (!file.is_open())
+            {
+                VGFW_WARN("[IO] Could not write baked model: {0}", tempPath.generic_string());
+                return;
+            }
+
+            const auto write = [&file](const void* data, std::size_t size) {
+                while (file.tellp() % 16 != 0)
+                    file.put(0);
+                const auto offset = static_cast<uint64_t>(file.tellp());
+                file.write(static_cast<const char*>(data), size);
+                return offset;
+            };
+            const auto writeString = [&write](const std::string& string) {
+                return BakedString {write(string.data(), string.size()), static_cast<uint32_t>(string.size())};
+            };
+
+            BakedModelHeader header {.source = getSourceFile(modelPath), .settingsHash = getSettingsHash(model)};
+            file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+            std::vector<const renderer::VertexFormat*> formats;
+            std::vector<BakedPrimitive>                primitives(model.meshPrimitives.size());
+            for (uint32_t i = 0; i < primitives.size(); ++i)
+            {
+                const auto& meshPrimitive = model.meshPrimitives[i];
+                assert(meshPrimitive.vertexFormat &&
+                       meshPrimitive.indices.size() == meshPrimitive.getNumStoredIndices());
+
+                auto&       primitive = primitives[i];
+                const auto  it        = std::find(formats.cbegin(), formats.cend(), meshPrimitive.vertexFormat.get());
+
+                primitive.formatIndex       = static_cast<uint32_t>(it - formats.cbegin());
+                primitive.vertexCount       = meshPrimitive.vertexCount;
+                primitive.indexCount        = meshPrimitive.indexCount;
+                primitive.numStoredIndices  = meshPrimitive.getNumStoredIndices();
+                primitive.indexType         = meshPrimitive.indexType;
+                primitive.materialIndex     = meshPrimitive.materialIndex;
+                primitive.material          = meshPrimitive.material;
+                primitive.numTextureIndices = static_cast<uint32_t>(
+                    std::min(meshPrimitive.textureIndices.size(), primitive.textureIndices.size()));
+                std::copy_n(meshPrimitive.textureIndices.cbegin(),
+                            primitive.numTextureIndices,
+                            primitive.textureIndices.begin());
+                primitive.numLods = static_cast<uint32_t>(std::min(meshPrimitive.lods.size(), primitive.lods.size()));
+                std::copy_n(meshPrimitive.lods.cbegin(), primitive.numLods, primitive.lods.begin());
+                primitive.aabb           = meshPrimitive.aabb;
+                primitive.dequantization = meshPrimitive.dequantization;
+                primitive.name           = writeString(meshPrimitive.name);
+
+                if (it == formats.cend())
+                    formats.push_back(meshPrimitive.vertexFormat.get());
+            }
+
+            // Geometry grouped by vertex format
+            for (uint32_t f = 0; f < formats.size(); ++f)
+            {
+                for (uint32_t i = 0; i < primitives.size(); ++i)
+                {
+                    if (primitives[i].formatIndex != f)
+                        continue;
+
+                    const auto& meshPrimitive = model.meshPrimitives[i];
+                    primitives[i].vertexOffset =
+                        write(meshPrimitive.vertices.data(), meshPrimitive.vertices.size() * sizeof(float));
+                    primitives[i].indexOffset =
+                        write(meshPrimitive.indices.data(), meshPrimitive.indices.size() * sizeof(uint32_t));
+                }
+            }
+
+            std::vector<BakedString> textures;
+            for (const auto& texturePath : texturePaths)
+                textures.push_back(writeString(texturePath.generic_string()));
+
+            std::vector<BakedDependency> bakedDependencies;
+            for (uint32_t i = 0; i < dependencies.size(); ++i)
+            {
+                bakedDependencies.push_back(
+                    {.path = writeString(dependencies[i].generic_string()), .file = dependencyFiles[i]});
+            }
+
+            std::vector<BakedVertexFormat> bakedFormats(formats.size());
+            for (uint32_t f = 0; f < formats.size(); ++f)
+            {
+                for (const auto& [location, attribute] : formats[f]->getAttributes())
+                {
+                    auto& bakedFormat = bakedFormats[f];
+                    assert(bakedFormat.numAttributes < bakedFormat.attributes.size() && attribute.divisor == 0);
+                    bakedFormat.attributes[bakedFormat.numAttributes++] = {
+                        location, attribute.vertType, attribute.offset};
+                }
+            }
+
+            header.numDependencies = static_cast<uint32_t>(bakedDependencies.size());
+            header.dependenciesOffset =
+                write(bakedDependencies.data(), bakedDependencies.size() * sizeof(BakedDependency));
+            header.numTextures      = static_cast<uint32_t>(textures.size());
+            header.texturesOffset   = write(textures.data(), textures.size() * sizeof(BakedString));
+            header.numMaterials     = static_cast<uint32_t>(model.materials.size());
+            header.materialsOffset  = write(model.materials.data(), header.numMaterials * sizeof(resource::Material));
+            header.numFormats       = static_cast<uint32_t>(bakedFormats.size());
+            header.formatsOffset    = write(bakedFormats.data(), bakedFormats.size() * sizeof(BakedVertexFormat));
+            header.numPrimitives    = static_cast<uint32_t>(primitives.size());
+            header.primitivesOffset = write(primitives.data(), primitives.size() * sizeof(BakedPrimitive));
+
+            header.magic = BakedModelHeader::kMagic;
+            file.seekp(0);
+            file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+            file.close();
+
+            std::error_code ec;
+            if (!file)
+            {
+                VGFW_WARN("[IO] Could not write baked model: {0}", tempPath.generic_string());
+                std::filesystem::remove(tempPath, ec);
+                return;
+            }
+
+            // Replaces the directory entry only, mappings of the previous file stay valid (POSIX). Fails where a
+            // mapped file cannot be replaced (Windows), the previous bake is then kept until it is unmapped
+            std::filesystem::rename(tempPath, bakedPath, ec);
+            if (ec)
+            {
+                VGFW_WARN("[IO] Could not replace baked model {0}: {1}", bakedPath.generic_string(), ec.message());
+                std::filesystem::remove(tempPath, ec);
+                return;
+            }
+            VGFW_TRACE("[IO] Baked model {0}: {1}", modelPath.generic_string(), bakedPath.generic_string());
+        }
+
+        // CPU side only, may run on any thread
+        static void applyBakedModel(const BakedModel& baked, resource::Model& model, const glm::vec3& scale)
+        {
+            model.materials = baked.materials;
+            model.textures.resize(baked.texturePaths.size());
+            model.meshPrimitives.resize(baked.primitives.size());
+
+            for (uint32_t i = 0; i < baked.primitives.size(); ++i)
+            {
+                const auto& primitive     = baked.primitives[i];
+                auto&       meshPrimitive = model.meshPrimitives[i];
+
+                const auto bytes   = baked.file.getData();
+                meshPrimitive.name = std::string {reinterpret_cast<const char*>(bytes.data() + primitive.name.offset),
+                                                  primitive.name.length};
+
+                meshPrimitive.vertexFormat  = baked.formats[primitive.formatIndex];
+                meshPrimitive.vertexCount   = primitive.vertexCount;
+                meshPrimitive.indexCount    = primitive.indexCount;
+                meshPrimitive.indexType     = primitive.indexType;
+                meshPrimitive.materialIndex = primitive.materialIndex;
+                meshPrimitive.material      = primitive.material;
+                meshPrimitive.textureIndices.assign(primitive.textureIndices.cbegin(),
+                                                    primitive.textureIndices.cbegin() + primitive.numTextureIndices);
+                meshPrimitive.lods.assign(primitive.lods.cbegin(), primitive.lods.cbegin() + primitive.numLods);
+                meshPrimitive.aabb           = primitive.aabb;
+                meshPrimitive.dequantization = primitive.dequantization;
+
+                setupMeshPrimitive(model, i, scale);
+
+                // Only copied when asked for, the upload reads the mapped file
+                if (model.retainMeshData.vertices)
+                {
+                    const auto* vertices = static_cast<const float*>(baked.getVertices(primitive));
+                    const auto  stride   = meshPrimitive.vertexFormat->getStride();
+                    meshPrimitive.vertices.assign(
+                        vertices, vertices + std::size_t {primitive.vertexCount} * stride / sizeof(float));
+                }
+                if (model.retainMeshData.indices)
+                {
+                    const auto indices = baked.getIndices(primitive);
+                    meshPrimitive.indices.assign(indices.begin(), indices.end());
+                }
+            }
+        }
+
+        static void uploadBakedPrimitive(const BakedModel&        baked,
+                                         resource::Model&         model,
+                                         uint32_t                 index,
+                                         renderer::RenderContext& rc)
+        {
+            const auto& primitive = baked.primitives[index];
+            model.meshPrimitives[index].upload(rc, baked.getVertices(primitive), baked.getIndices(primitive));
+        }
+
+        static void loadBakedModel(const std::filesystem::path& modelPath,
+                                   const BakedModel&            baked,
+                                   resource::Model&             model,
+                                   renderer::RenderContext&     rc,
+                                   const glm::vec3&             scale)
+        {
+            applyBakedModel(baked, model, scale);
+
+            for (uint32_t i = 0; i < baked.texturePaths.size(); ++i)
+            {
+                if (!baked.texturePaths[i].empty())
+                    model.textures[i] = loadTexture(modelPath.parent_path() / baked.texturePaths[i], rc, false);
+            }
+            for (uint32_t i = 0; i < baked.primitives.size(); ++i)
+                uploadBakedPrimitive(baked, model, i, rc);
+        }
+
+        static bool parseOBJ(const std::filesystem::path& modelPath, tinyobj::ObjReader& reader)
         {
             std::string              inputfile = modelPath.generic_string();
             tinyobj::ObjReaderConfig readerConfig;
             readerConfig.mtl_search_path = "./"; // Path to material files
 
-            tinyobj::ObjReader reader;
-
             if (!reader.ParseFromFile(inputfile, readerConfig))
             {
                 if (!reader.Error().empty())
@@ -3679,107 +9655,134 @@ namespace vgfw
                 VGFW_WARN("[TinyObjReader] {0}", reader.Warning());
             }
 
-            const auto& attrib    = reader.GetAttrib();
-            const auto& shapes    = reader.GetShapes();
-            const auto& materials = reader.GetMaterials();
-
-            // Loop over shapes
-            for (const auto& shape : shapes)
-            {
-                auto& meshPrimitive = model.meshPrimitives.emplace_back();
+            return true;
+        }
 
-                meshPrimitive.name = shape.name;
+        static void convertOBJShape(const tinyobj::attrib_t&         attrib,
+                                    const tinyobj::shape_t&          shape,
+                                    resource::MeshPrimitive&         meshPrimitive,
+                                    renderer::VertexFormat::Builder& vertexFormatBuilder)
+        {
+            meshPrimitive.name = shape.name;
 
-                auto    vertexFormatBuilder = renderer::VertexFormat::Builder {};
-                int32_t attributeOffset     = 0;
+            int32_t attributeOffset = 0;
 
-                bool hasNormal    = false;
-                bool hasTexCoords = false;
+            bool hasNormal    = false;
+            bool hasTexCoords = false;
 
-                // Loop over faces(polygon)
-                size_t indexOffset = 0;
-                for (size_t f = 0; f < shape.mesh.num_face_vertices.size(); f++)
-                {
-                    size_t fv = static_cast<size_t>(shape.mesh.num_face_vertices[f]);
+            // Faces are de-indexed, so every face vertex becomes a vertex
+            const auto numFaceVertices = shape.mesh.indices.size();
+            meshPrimitive.record.positions.reserve(numFaceVertices);
+            meshPrimitive.record.normals.reserve(attrib.normals.empty() ? 0 : numFaceVertices);
+            meshPrimitive.record.texcoords.reserve(attrib.texcoords.empty() ? 0 : numFaceVertices);
+            meshPrimitive.indices.reserve(numFaceVertices);
 
-                    // Loop over vertices in the face.
-                    for (size_t v = 0; v < fv; v++)
-                    {
-                        // access to vertex
-                        tinyobj::index_t idx = shape.mesh.indices[indexOffset + v];
-                        tinyobj::real_t  vx  = attrib.vertices[3 * static_cast<size_t>(idx.vertex_index) + 0];
-                        tinyobj::real_t  vy  = attrib.vertices[3 * static_cast<size_t>(idx.vertex_index) + 1];
-                        tinyobj::real_t  vz  = attrib.vertices[3 * static_cast<size_t>(idx.vertex_index) + 2];
+            // Loop over faces(polygon)
+            size_t indexOffset = 0;
+            for (size_t f = 0; f < shape.mesh.num_face_vertices.size(); f++)
+            {
+                size_t fv = static_cast<size_t>(shape.mesh.num_face_vertices[f]);
 
-                        meshPrimitive.record.positions.push_back({vx, vy, vz});
+                // Loop over vertices in the face.
+                for (size_t v = 0; v < fv; v++)
+                {
+                    // access to vertex
+                    tinyobj::index_t idx = shape.mesh.indices[indexOffset + v];
+                    tinyobj::real_t  vx  = attrib.vertices[3 * static_cast<size_t>(idx.vertex_index) + 0];
+                    tinyobj::real_t  vy  = attrib.vertices[3 * static_cast<size_t>(idx.vertex_index) + 1];
+                    tinyobj::real_t  vz  = attrib.vertices[3 * static_cast<size_t>(idx.vertex_index) + 2];
 
-                        // Check if `normal_index` is zero or positive. negative = no normal data
-                        if (idx.normal_index >= 0)
-                        {
-                            hasNormal          = true;
-                            tinyobj::real_t nx = attrib.normals[3 * static_cast<size_t>(idx.normal_index) + 0];
-                            tinyobj::real_t ny = attrib.normals[3 * static_cast<size_t>(idx.normal_index) + 1];
-                            tinyobj::real_t nz = attrib.normals[3 * static_cast<size_t>(idx.normal_index) + 2];
+                    meshPrimitive.record.positions.push_back({vx, vy, vz});
 
-                            meshPrimitive.record.normals.push_back({nx, ny, nz});
-                        }
+                    // Check if `normal_index` is zero or positive. negative = no normal data
+                    if (idx.normal_index >= 0)
+                    {
+                        hasNormal          = true;
+                        tinyobj::real_t nx = attrib.normals[3 * static_cast<size_t>(idx.normal_index) + 0];
+                        tinyobj::real_t ny = attrib.normals[3 * static_cast<size_t>(idx.normal_index) + 1];
+                        tinyobj::real_t nz = attrib.normals[3 * static_cast<size_t>(idx.normal_index) + 2];
 
-                        // Check if `texcoord_index` is zero or positive. negative = no texcoord data
-                        if (idx.texcoord_index >= 0)
-                        {
-                            hasTexCoords       = true;
-                            tinyobj::real_t tx = attrib.texcoords[2 * static_cast<size_t>(idx.texcoord_index) + 0];
-                            tinyobj::real_t ty = attrib.texcoords[2 * static_cast<size_t>(idx.texcoord_index) + 1];
+                        meshPrimitive.record.normals.push_back({nx, ny, nz});
+                    }
 
-                            meshPrimitive.record.texcoords.push_back({tx, ty});
-                        }
+                    // Check if `texcoord_index` is zero or positive. negative = no texcoord data
+                    if (idx.texcoord_index >= 0)
+                    {
+                        hasTexCoords       = true;
+                        tinyobj::real_t tx = attrib.texcoords[2 * static_cast<size_t>(idx.texcoord_index) + 0];
+                        tinyobj::real_t ty = attrib.texcoords[2 * static_cast<size_t>(idx.texcoord_index) + 1];
 
-                        meshPrimitive.indices.push_back(meshPrimitive.indices.size());
+                        meshPrimitive.record.texcoords.push_back({tx, ty});
                     }
-                    indexOffset += fv;
-                    meshPrimitive.vertexCount += fv;
+
+                    meshPrimitive.indices.push_back(meshPrimitive.indices.size());
                 }
+                indexOffset += fv;
+                meshPrimitive.vertexCount += fv;
+            }
+
+            vertexFormatBuilder.setAttribute(
+                renderer::AttributeLocation::ePosition,
+                {.vertType = vgfw::renderer::VertexAttribute::Type::eFloat3, .offset = attributeOffset});
+            attributeOffset += sizeof(float) * 3;
 
+            if (hasNormal)
+            {
                 vertexFormatBuilder.setAttribute(
-                    renderer::AttributeLocation::ePosition,
+                    renderer::AttributeLocation::eNormal_Color,
                     {.vertType = vgfw::renderer::VertexAttribute::Type::eFloat3, .offset = attributeOffset});
                 attributeOffset += sizeof(float) * 3;
+            }
 
-                if (hasNormal)
-                {
-                    vertexFormatBuilder.setAttribute(
-                        renderer::AttributeLocation::eNormal_Color,
-                        {.vertType = vgfw::renderer::VertexAttribute::Type::eFloat3, .offset = attributeOffset});
-                    attributeOffset += sizeof(float) * 3;
-                }
+            if (hasTexCoords)
+            {
+                vertexFormatBuilder.setAttribute(
+                    renderer::AttributeLocation::eTexCoords,
+                    {.vertType = vgfw::renderer::VertexAttribute::Type::eFloat2, .offset = attributeOffset});
+                attributeOffset += sizeof(float) * 2;
+            }
+        }
 
-                if (hasTexCoords)
-                {
-                    vertexFormatBuilder.setAttribute(
-                        renderer::AttributeLocation::eTexCoords,
-                        {.vertType = vgfw::renderer::VertexAttribute::Type::eFloat2, .offset = attributeOffset});
-                    attributeOffset += sizeof(float) * 2;
-                }
+        bool loadOBJ(const std::filesystem::path& modelPath,
+                     resource::Model&             model,
+                     renderer::RenderContext&     rc,
+                     const glm::vec3&             scale)
+        {
+            tinyobj::ObjReader reader;
+            if (!parseOBJ(modelPath, reader))
+                return false;
+
+            const auto& attrib = reader.GetAttrib();
+            const auto& shapes = reader.GetShapes();
+
+            // Loop over shapes
+            for (const auto& shape : shapes)
+            {
+                auto& meshPrimitive = model.meshPrimitives.emplace_back();
+
+                auto vertexFormatBuilder = renderer::VertexFormat::Builder {};
+                convertOBJShape(attrib, shape, meshPrimitive, vertexFormatBuilder);
 
-                meshPrimitive.ownerModel        = &model;
-                meshPrimitive.indexInOwnerModel = model.meshPrimitives.size() - 1;
-                meshPrimitive.modelMatrix       = glm::scale(glm::mat4(1.0), scale);
-                meshPrimitive.build(vertexFormatBuilder, rc);
+                setupMeshPrimitive(model, model.meshPrimitives.size() - 1, scale);
+                meshPrimitive.prepare(vertexFormatBuilder);
             }
 
+            bakeModel(modelPath, model, {}, {});
+            for (auto& meshPrimitive : model.meshPrimitives)
+                meshPrimitive.upload(rc);
+
             return true;
         }
 
-        bool loadGLTF(const std::filesystem::path& modelPath,
-                      resource::Model&             model,
-                      renderer::RenderContext&     rc,
-                      const glm::vec3&             scale)
+        static bool parseGLTF(const std::filesystem::path& modelPath, tinygltf::Model& gltfModel)
         {
             tinygltf::TinyGLTF loader;
-            tinygltf::Model    gltfModel;
             std::string        err;
             std::string        warn;
 
+            // Images are decoded by loadTexture (from image.uri), don't let tinygltf decode them a second time
+            loader.SetImageLoader([](auto...) { return true; }, nullptr);
+
             bool        ret = false;
             const auto& ext = modelPath.extension();
 
@@ -3814,17 +9817,35 @@ namespace vgfw
                 return false;
             }
 
-            // Load textures
-            model.textures.resize(gltfModel.textures.size());
+            return true;
+        }
+
+        // Relative to the model, indexed like Model::textures (by image)
+        static std::vector<std::filesystem::path> getGLTFTexturePaths(const tinygltf::Model& gltfModel)
+        {
+            std::vector<std::filesystem::path> texturePaths(gltfModel.textures.size());
             for (const auto& texture : gltfModel.textures)
-            {
-                const auto&              image = gltfModel.images[texture.source];
-                vgfw::renderer::Texture* loadedTexture =
-                    vgfw::io::loadTexture(modelPath.parent_path() / image.uri, rc, false);
-                model.textures[texture.source] = loadedTexture;
-            }
+                texturePaths[texture.source] = gltfModel.images[texture.source].uri;
+            return texturePaths;
+        }
 
-            // Load materials
+        // External buffers and images, data URIs are part of the model file
+        static std::vector<std::filesystem::path> getGLTFDependencies(const tinygltf::Model& gltfModel)
+        {
+            std::vector<std::filesystem::path> dependencies;
+            const auto                         add = [&dependencies](const std::string& uri) {
+                if (!uri.empty() && !uri.starts_with("data:"))
+                    dependencies.emplace_back(uri);
+            };
+            for (const auto& buffer : gltfModel.buffers)
+                add(buffer.uri);
+            for (const auto& image : gltfModel.images)
+                add(image.uri);
+            return dependencies;
+        }
+
+        static void loadGLTFMaterials(const tinygltf::Model& gltfModel, resource::Model& model)
+        {
             model.materials.resize(gltfModel.materials.size());
             for (const auto& material : gltfModel.materials)
             {
@@ -3847,6 +9868,159 @@ namespace vgfw
 
                 model.materials[&material - &gltfModel.materials[0]] = mat;
             }
+        }
+
+        static void convertGLTFPrimitive(const tinygltf::Model&           gltfModel,
+                                         const tinygltf::Mesh&            mesh,
+                                         const tinygltf::Primitive&       primitive,
+                                         const resource::Model&           model,
+                                         resource::MeshPrimitive&         meshPrimitive,
+                                         renderer::VertexFormat::Builder& vertexFormatBuilder)
+        {
+            meshPrimitive.name = mesh.name;
+
+            const tinygltf::Accessor&   indexAccessor   = gltfModel.accessors[primitive.indices];
+            const tinygltf::BufferView& indexBufferView = gltfModel.bufferViews[indexAccessor.bufferView];
+            const tinygltf::Buffer&     indexBuffer     = gltfModel.buffers[indexBufferView.buffer];
+
+            const void* indicesData =
+                indexBuffer.data.data() + indexBufferView.byteOffset + indexAccessor.byteOffset;
+
+            auto& indices = meshPrimitive.indices;
+            indices.resize(indexAccessor.count);
+            switch (indexAccessor.componentType)
+            {
+                case TINYGLTF_COMPONENT_TYPE_UNSIGNED_INT:
+                    std::copy_n(static_cast<const uint32_t*>(indicesData), indices.size(), indices.begin());
+                    break;
+                case TINYGLTF_COMPONENT_TYPE_UNSIGNED_SHORT:
+                    std::copy_n(static_cast<const uint16_t*>(indicesData), indices.size(), indices.begin());
+                    break;
+                case TINYGLTF_COMPONENT_TYPE_UNSIGNED_BYTE:
+                    std::copy_n(static_cast<const uint8_t*>(indicesData), indices.size(), indices.begin());
+                    break;
+            }
+
+            // The vertex format first, its stride sizes the interleaved buffer that the accessors are copied into
+            struct Stream
+            {
+                const tinygltf::Accessor* accessor;
+                int32_t                   offset;
+                int32_t                   size;
+            };
+            std::vector<Stream> streams;
+
+            using Location = renderer::AttributeLocation;
+            using Type     = renderer::VertexAttribute::Type;
+
+            int32_t attributeOffset = 0;
+
+            const auto addStream = [&](const char* name, Location location, Type type, int32_t size) {
+                const auto it = primitive.attributes.find(name);
+                if (it == primitive.attributes.end())
+                    return;
+
+                vertexFormatBuilder.setAttribute(location, {.vertType = type, .offset = attributeOffset});
+                streams.push_back({&gltfModel.accessors[it->second], attributeOffset, size});
+                attributeOffset += size;
+            };
+            addStream("POSITION", Location::ePosition, Type::eFloat3, sizeof(float) * 3);
+            if (streams.empty())
+                throw std::runtime_error("glTF primitive without positions: " + mesh.name);
+
+            addStream("NORMAL", Location::eNormal_Color, Type::eFloat3, sizeof(float) * 3);
+            addStream("TEXCOORD_0", Location::eTexCoords, Type::eFloat2, sizeof(float) * 2);
+            addStream("TANGENT", Location::eTangent, Type::eFloat4, sizeof(float) * 4);
+
+            const auto stride         = static_cast<std::size_t>(attributeOffset);
+            meshPrimitive.vertexCount = streams.front().accessor->count;
+            meshPrimitive.vertices.resize(meshPrimitive.vertexCount * stride / sizeof(float));
+
+            auto* vertexData = reinterpret_cast<std::byte*>(meshPrimitive.vertices.data());
+            for (const auto& [accessor, offset, size] : streams)
+            {
+                const tinygltf::BufferView& bufferView = gltfModel.bufferViews[accessor->bufferView];
+                const tinygltf::Buffer&     buffer     = gltfModel.buffers[bufferView.buffer];
+
+                const auto* src       = buffer.data.data() + bufferView.byteOffset + accessor->byteOffset;
+                const auto  srcStride = bufferView.byteStride > 0 ? bufferView.byteStride : size;
+
+                const auto count = std::min<std::size_t>(accessor->count, meshPrimitive.vertexCount);
+                for (std::size_t i = 0; i < count; ++i)
+                    std::memcpy(vertexData + i * stride + offset, src + i * srcStride, size);
+            }
+
+            const float floatMax = std::numeric_limits<float>::max();
+
+            meshPrimitive.aabb.min = glm::vec3 {floatMax};
+            meshPrimitive.aabb.max = glm::vec3 {-floatMax};
+            for (uint32_t v = 0; v < meshPrimitive.vertexCount; ++v)
+            {
+                glm::vec3 position;
+                std::memcpy(&position, vertexData + v * stride, sizeof(glm::vec3));
+                meshPrimitive.aabb.min = glm::min(meshPrimitive.aabb.min, position);
+                meshPrimitive.aabb.max = glm::max(meshPrimitive.aabb.max, position);
+            }
+
+            // TODO: Additional attributes such as joint indices and weights can be added here
+
+            meshPrimitive.materialIndex = primitive.material;
+
+            const auto& material = model.materials[meshPrimitive.materialIndex];
+
+            uint32_t textureIndex = 0;
+
+            if (material.baseColorTextureIndex != -1)
+            {
+                meshPrimitive.material.baseColorTextureIndex = textureIndex++;
+                meshPrimitive.textureIndices.push_back(material.baseColorTextureIndex);
+            }
+
+            if (material.metallicRoughnessTextureIndex != -1)
+            {
+                meshPrimitive.material.metallicRoughnessTextureIndex = textureIndex++;
+                meshPrimitive.textureIndices.push_back(material.metallicRoughnessTextureIndex);
+            }
+
+            if (material.normalTextureIndex != -1)
+            {
+                meshPrimitive.material.normalTextureIndex = textureIndex++;
+                meshPrimitive.textureIndices.push_back(material.normalTextureIndex);
+            }
+
+            if (material.occlusionTextureIndex != -1)
+            {
+                meshPrimitive.material.occlusionTextureIndex = textureIndex++;
+                meshPrimitive.textureIndices.push_back(material.occlusionTextureIndex);
+            }
+
+            if (material.emissiveTextureIndex != -1)
+            {
+                meshPrimitive.material.emissiveTextureIndex = textureIndex++;
+                meshPrimitive.textureIndices.push_back(material.emissiveTextureIndex);
+            }
+        }
+
+        bool loadGLTF(const std::filesystem::path& modelPath,
+                      resource::Model&             model,
+                      renderer::RenderContext&     rc,
+                      const glm::vec3&             scale)
+        {
+            tinygltf::Model gltfModel;
+            if (!parseGLTF(modelPath, gltfModel))
+                return false;
+
+            // Load textures
+            model.textures.resize(gltfModel.textures.size());
+            const auto texturePaths = getGLTFTexturePaths(gltfModel);
+            for (uint32_t i = 0; i < texturePaths.size(); ++i)
+            {
+                if (!texturePaths[i].empty())
+                    model.textures[i] = vgfw::io::loadTexture(modelPath.parent_path() / texturePaths[i], rc, false);
+            }
+
+            // Load materials
+            loadGLTFMaterials(gltfModel, model);
 
             // Load meshes
             for (const auto& mesh : gltfModel.meshes)
@@ -3857,192 +10031,321 @@ namespace vgfw
                         continue;
 
                     auto& meshPrimitive = model.meshPrimitives.emplace_back();
-                    meshPrimitive.name  = mesh.name;
 
-                    const tinygltf::Accessor&   indexAccessor   = gltfModel.accessors[primitive.indices];
-                    const tinygltf::BufferView& indexBufferView = gltfModel.bufferViews[indexAccessor.bufferView];
-                    const tinygltf::Buffer&     indexBuffer     = gltfModel.buffers[indexBufferView.buffer];
+                    auto vertexFormatBuilder = renderer::VertexFormat::Builder {};
+                    convertGLTFPrimitive(gltfModel, mesh, primitive, model, meshPrimitive, vertexFormatBuilder);
 
-                    const void* indicesData =
-                        indexBuffer.data.data() + indexBufferView.byteOffset + indexAccessor.byteOffset;
+                    setupMeshPrimitive(model, model.meshPrimitives.size() - 1, scale);
+                    meshPrimitive.prepare(vertexFormatBuilder);
+                }
+            }
 
-                    switch (indexAccessor.componentType)
-                    {
-                        case TINYGLTF_COMPONENT_TYPE_UNSIGNED_INT:
-                            for (size_t i = 0; i < indexAccessor.count; ++i)
-                            {
-                                const uint32_t* indices = reinterpret_cast<const uint32_t*>(indicesData);
-                                meshPrimitive.indices.push_back(indices[i]);
-                            }
-                            break;
-                        case TINYGLTF_COMPONENT_TYPE_UNSIGNED_SHORT:
-                            for (size_t i = 0; i < indexAccessor.count; ++i)
-                            {
-                                const uint16_t* indices = reinterpret_cast<const uint16_t*>(indicesData);
-                                meshPrimitive.indices.push_back(indices[i]);
-                            }
-                            break;
-                        case TINYGLTF_COMPONENT_TYPE_UNSIGNED_BYTE:
-                            for (size_t i = 0; i < indexAccessor.count; ++i)
-                            {
-                                const uint8_t* indices = reinterpret_cast<const uint8_t*>(indicesData);
-                                meshPrimitive.indices.push_back(indices[i]);
-                            }
-                            break;
-                    }
+            bakeModel(modelPath, model, texturePaths, getGLTFDependencies(gltfModel));
+            for (auto& meshPrimitive : model.meshPrimitives)
+                meshPrimitive.upload(rc);
 
-                    auto    vertexFormatBuilder = renderer::VertexFormat::Builder {};
-                    int32_t attributeOffset     = 0;
+            return true;
+        }
 
-                    const tinygltf::Accessor& positionAccessor =
-                        gltfModel.accessors[primitive.attributes.find("POSITION")->second];
-                    const tinygltf::BufferView& positionBufferView = gltfModel.bufferViews[positionAccessor.bufferView];
-                    const tinygltf::Buffer&     positionBuffer     = gltfModel.buffers[positionBufferView.buffer];
+        bool loadModel(const std::filesystem::path& modelPath,
+                       resource::Model&             model,
+                       renderer::RenderContext&     rc,
+                       const glm::vec3&             scale)
+        {
+            if (const auto baked = openBakedModel(modelPath, model))
+            {
+                loadBakedModel(modelPath, *baked, model, rc, scale);
+                return true;
+            }
 
-                    for (size_t i = 0; i < positionAccessor.count; ++i)
-                    {
-                        const float* positions = reinterpret_cast<const float*>(
-                            positionBuffer.data.data() + positionBufferView.byteOffset + positionAccessor.byteOffset);
-                        meshPrimitive.record.positions.push_back(
-                            {positions[3 * i + 0], positions[3 * i + 1], positions[3 * i + 2]});
-                    }
+            const auto& ext = modelPath.extension();
+            if (ext == ".obj")
+            {
+                return loadOBJ(modelPath, model, rc, scale);
+            }
+            else if (ext == ".gltf" || ext == ".glb")
+            {
+                return loadGLTF(modelPath, model, rc, scale);
+            }
 
-                    vertexFormatBuilder.setAttribute(
-                        renderer::AttributeLocation::ePosition,
-                        {.vertType = vgfw::renderer::VertexAttribute::Type::eFloat3, .offset = attributeOffset});
-                    attributeOffset += sizeof(float) * 3;
+            return false;
+        }
 
-                    if (primitive.attributes.find("NORMAL") != primitive.attributes.end())
-                    {
-                        const tinygltf::Accessor& normalAccessor =
-                            gltfModel.accessors[primitive.attributes.find("NORMAL")->second];
-                        const tinygltf::BufferView& normalBufferView = gltfModel.bufferViews[normalAccessor.bufferView];
-                        const tinygltf::Buffer&     normalBuffer     = gltfModel.buffers[normalBufferView.buffer];
+        struct ModelLoader::Job
+        {
+            std::filesystem::path path;
+            resource::Model*      model {nullptr};
+            glm::vec3             scale {1.0f};
 
-                        for (size_t i = 0; i < normalAccessor.count; ++i)
-                        {
-                            const float* normals = reinterpret_cast<const float*>(
-                                normalBuffer.data.data() + normalBufferView.byteOffset + normalAccessor.byteOffset);
-                            meshPrimitive.record.normals.push_back(
-                                {normals[3 * i + 0], normals[3 * i + 1], normals[3 * i + 2]});
-                        }
+            std::promise<bool> promise;
 
-                        vertexFormatBuilder.setAttribute(
-                            renderer::AttributeLocation::eNormal_Color,
-                            {.vertType = vgfw::renderer::VertexAttribute::Type::eFloat3, .offset = attributeOffset});
-                        attributeOffset += sizeof(float) * 3;
-                    }
+            // A step only adds new steps before it completes, so the counters meet exactly once
+            std::atomic<uint32_t> numSteps {0};
+            std::atomic<uint32_t> numCompletedSteps {0};
+            std::atomic<bool>     failed {false};
 
-                    if (primitive.attributes.find("TEXCOORD_0") != primitive.attributes.end())
-                    {
-                        const tinygltf::Accessor& texCoordAccessor =
-                            gltfModel.accessors[primitive.attributes.find("TEXCOORD_0")->second];
-                        const tinygltf::BufferView& texCoordBufferView =
-                            gltfModel.bufferViews[texCoordAccessor.bufferView];
-                        const tinygltf::Buffer& texCoordBuffer = gltfModel.buffers[texCoordBufferView.buffer];
+            // Uploads wait for the last prepared primitive when baking, the cache takes the CPU data
+            bool                               bake {false};
+            std::atomic<uint32_t>              numUnbakedPrimitives {0};
+            std::vector<std::filesystem::path> texturePaths;
+            std::vector<std::filesystem::path> dependencies; // See bakeModel
 
-                        for (size_t i = 0; i < texCoordAccessor.count; ++i)
-                        {
-                            const float* texCoords = reinterpret_cast<const float*>(texCoordBuffer.data.data() +
-                                                                                    texCoordBufferView.byteOffset +
-                                                                                    texCoordAccessor.byteOffset);
+            void completeStep()
+            {
+                if (++numCompletedSteps == numSteps.load())
+                    promise.set_value(!failed);
+            }
+            bool isDone() const { return numCompletedSteps.load() == numSteps.load(); }
+        };
 
-                            meshPrimitive.record.texcoords.push_back({texCoords[2 * i + 0], texCoords[2 * i + 1]});
-                        }
+        ModelLoader::ModelLoader(uint32_t numThreads) : m_Pool {numThreads} {}
 
-                        vertexFormatBuilder.setAttribute(
-                            renderer::AttributeLocation::eTexCoords,
-                            {.vertType = vgfw::renderer::VertexAttribute::Type::eFloat2, .offset = attributeOffset});
-                        attributeOffset += sizeof(float) * 2;
-                    }
+        std::future<bool> ModelLoader::loadModelAsync(const std::filesystem::path& modelPath,
+                                                      resource::Model&             model,
+                                                      const glm::vec3&             scale)
+        {
+            auto job   = std::make_shared<Job>();
+            job->path  = modelPath;
+            job->model = &model;
+            job->scale = scale;
 
-                    if (primitive.attributes.find("TANGENT") != primitive.attributes.end())
-                    {
-                        const tinygltf::Accessor& tangentAccessor =
-                            gltfModel.accessors[primitive.attributes.find("TANGENT")->second];
-                        const tinygltf::BufferView& tangentBufferView =
-                            gltfModel.bufferViews[tangentAccessor.bufferView];
-                        const tinygltf::Buffer& tangentBuffer = gltfModel.buffers[tangentBufferView.buffer];
+            auto future = job->promise.get_future();
+            m_Jobs.push_back(job);
 
-                        for (size_t i = 0; i < tangentAccessor.count; ++i)
-                        {
-                            const float* tangents = reinterpret_cast<const float*>(
-                                tangentBuffer.data.data() + tangentBufferView.byteOffset + tangentAccessor.byteOffset);
-                            meshPrimitive.record.tangents.push_back(
-                                {tangents[4 * i + 0], tangents[4 * i + 1], tangents[4 * i + 2], tangents[4 * i + 3]});
-                        }
+            submitTask(job, [this, job] {
+                if (auto baked = openBakedModel(job->path, *job->model))
+                {
+                    loadBakedAsync(job, std::move(baked));
+                    return;
+                }
+                job->bake = !g_ModelCacheDirectory.empty();
 
-                        vertexFormatBuilder.setAttribute(
-                            renderer::AttributeLocation::eTangent,
-                            {.vertType = vgfw::renderer::VertexAttribute::Type::eFloat4, .offset = attributeOffset});
-                        attributeOffset += sizeof(float) * 4;
-                    }
+                const auto& ext = job->path.extension();
+                if (ext == ".obj")
+                    loadOBJAsync(job);
+                else if (ext == ".gltf" || ext == ".glb")
+                    loadGLTFAsync(job);
+                else
+                    throw std::runtime_error("Unsupported model format: " + job->path.generic_string());
+            });
 
-                    // TODO: Additional attributes such as joint indices and weights can be added here
+            return future;
+        }
 
-                    meshPrimitive.materialIndex = primitive.material;
-                    meshPrimitive.vertexCount   = positionAccessor.count;
+        void ModelLoader::update(renderer::RenderContext& rc, time::Duration budget)
+        {
+            VGFW_PROFILE_FUNCTION
 
-                    const auto& material = model.materials[meshPrimitive.materialIndex];
+            const auto deadline = time::Clock::now() + std::chrono::duration_cast<time::Clock::duration>(budget);
+            do
+            {
+                std::pair<std::shared_ptr<Job>, Upload> upload;
+                {
+                    std::lock_guard lock {m_UploadMutex};
+                    if (m_Uploads.empty())
+                        break;
 
-                    uint32_t textureIndex = 0;
+                    upload = std::move(m_Uploads.front());
+                    m_Uploads.pop();
+                }
 
-                    if (material.baseColorTextureIndex != -1)
+                auto& [job, fn] = upload;
+                if (!job->failed)
+                {
+                    try
                     {
-                        meshPrimitive.material.baseColorTextureIndex = textureIndex++;
-                        meshPrimitive.textureIndices.push_back(material.baseColorTextureIndex);
+                        fn(rc);
                     }
-
-                    if (material.metallicRoughnessTextureIndex != -1)
+                    catch (const std::exception& e)
                     {
-                        meshPrimitive.material.metallicRoughnessTextureIndex = textureIndex++;
-                        meshPrimitive.textureIndices.push_back(material.metallicRoughnessTextureIndex);
+                        VGFW_ERROR("[IO] {0}", e.what());
+                        job->failed = true;
                     }
+                }
+                job->completeStep();
+            } while (time::Clock::now() < deadline);
 
-                    if (material.normalTextureIndex != -1)
-                    {
-                        meshPrimitive.material.normalTextureIndex = textureIndex++;
-                        meshPrimitive.textureIndices.push_back(material.normalTextureIndex);
-                    }
+            std::erase_if(m_Jobs, [](const auto& job) { return job->isDone(); });
+        }
+
+        float ModelLoader::getProgress() const
+        {
+            uint32_t numSteps {0}, numCompletedSteps {0};
+            for (const auto& job : m_Jobs)
+            {
+                numSteps += job->numSteps;
+                numCompletedSteps += job->numCompletedSteps;
+            }
+            return numSteps > 0 ? static_cast<float>(numCompletedSteps) / numSteps : 1.0f;
+        }
+
+        bool ModelLoader::isBusy() const
+        {
+            return std::any_of(m_Jobs.cbegin(), m_Jobs.cend(), [](const auto& job) { return !job->isDone(); });
+        }
 
-                    if (material.occlusionTextureIndex != -1)
+        void ModelLoader::submitTask(const std::shared_ptr<Job>& job, std::function<void()> task)
+        {
+            ++job->numSteps;
+            m_Pool.submit([job, task = std::move(task)] {
+                if (!job->failed)
+                {
+                    try
                     {
-                        meshPrimitive.material.occlusionTextureIndex = textureIndex++;
-                        meshPrimitive.textureIndices.push_back(material.occlusionTextureIndex);
+                        task();
                     }
-
-                    if (material.emissiveTextureIndex != -1)
+                    catch (const std::exception& e)
                     {
-                        meshPrimitive.material.emissiveTextureIndex = textureIndex++;
-                        meshPrimitive.textureIndices.push_back(material.emissiveTextureIndex);
+                        VGFW_ERROR("[IO] {0}", e.what());
+                        job->failed = true;
                     }
-
-                    meshPrimitive.ownerModel        = &model;
-                    meshPrimitive.indexInOwnerModel = model.meshPrimitives.size() - 1;
-                    meshPrimitive.modelMatrix       = glm::scale(glm::mat4(1.0), scale);
-                    meshPrimitive.build(vertexFormatBuilder, rc);
                 }
+                job->completeStep();
+            });
+        }
+
+        void ModelLoader::postUpload(const std::shared_ptr<Job>& job, Upload upload)
+        {
+            ++job->numSteps;
+
+            std::lock_guard lock {m_UploadMutex};
+            m_Uploads.emplace(job, std::move(upload));
+        }
+
+        void ModelLoader::loadOBJAsync(const std::shared_ptr<Job>& job)
+        {
+            auto reader = std::make_shared<tinyobj::ObjReader>();
+            if (!parseOBJ(job->path, *reader))
+                throw std::runtime_error("Failed to load OBJ model: " + job->path.generic_string());
+
+            // Sized up front, primitives are filled concurrently
+            const auto& shapes = reader->GetShapes();
+            job->model->meshPrimitives.resize(shapes.size());
+            job->numUnbakedPrimitives = static_cast<uint32_t>(shapes.size());
+
+            for (uint32_t i = 0; i < shapes.size(); ++i)
+            {
+                submitTask(job, [this, job, reader, i] {
+                    auto& meshPrimitive = job->model->meshPrimitives[i];
+
+                    auto vertexFormatBuilder = renderer::VertexFormat::Builder {};
+                    convertOBJShape(reader->GetAttrib(), reader->GetShapes()[i], meshPrimitive, vertexFormatBuilder);
+
+                    setupMeshPrimitive(*job->model, i, job->scale);
+                    meshPrimitive.prepare(vertexFormatBuilder);
+
+                    onPrimitivePrepared(job, i);
+                });
             }
+        }
 
-            return true;
+        void ModelLoader::loadGLTFAsync(const std::shared_ptr<Job>& job)
+        {
+            auto gltfModel = std::make_shared<tinygltf::Model>();
+            if (!parseGLTF(job->path, *gltfModel))
+                throw std::runtime_error("Failed to load GLTF model: " + job->path.generic_string());
+
+            auto& model = *job->model;
+            loadGLTFMaterials(*gltfModel, model);
+
+            job->texturePaths = getGLTFTexturePaths(*gltfModel);
+            job->dependencies = getGLTFDependencies(*gltfModel);
+            loadTexturesAsync(job, job->texturePaths);
+
+            std::vector<std::pair<const tinygltf::Mesh*, const tinygltf::Primitive*>> primitives;
+            for (const auto& mesh : gltfModel->meshes)
+                for (const auto& primitive : mesh.primitives)
+                    if (primitive.indices >= 0)
+                        primitives.emplace_back(&mesh, &primitive);
+
+            // Sized up front, primitives are filled concurrently
+            model.meshPrimitives.resize(primitives.size());
+            job->numUnbakedPrimitives = static_cast<uint32_t>(primitives.size());
+
+            for (uint32_t i = 0; i < primitives.size(); ++i)
+            {
+                const auto [mesh, primitive] = primitives[i];
+                submitTask(job, [this, job, gltfModel, mesh, primitive, i] {
+                    auto& meshPrimitive = job->model->meshPrimitives[i];
+
+                    auto vertexFormatBuilder = renderer::VertexFormat::Builder {};
+                    convertGLTFPrimitive(
+                        *gltfModel, *mesh, *primitive, *job->model, meshPrimitive, vertexFormatBuilder);
+
+                    setupMeshPrimitive(*job->model, i, job->scale);
+                    meshPrimitive.prepare(vertexFormatBuilder);
+
+                    onPrimitivePrepared(job, i);
+                });
+            }
         }
 
-        bool loadModel(const std::filesystem::path& modelPath,
-                       resource::Model&             model,
-                       renderer::RenderContext&     rc,
-                       const glm::vec3&             scale)
+        void ModelLoader::loadBakedAsync(const std::shared_ptr<Job>& job, std::shared_ptr<const BakedModel> baked)
         {
-            const auto& ext = modelPath.extension();
-            if (ext == ".obj")
+            applyBakedModel(*baked, *job->model, job->scale);
+
+            loadTexturesAsync(job, {baked->texturePaths.cbegin(), baked->texturePaths.cend()});
+
+            // Straight from the mapped file, the last upload unmaps it
+            for (uint32_t i = 0; i < baked->primitives.size(); ++i)
             {
-                return loadOBJ(modelPath, model, rc, scale);
+                postUpload(job, [job, baked, i](renderer::RenderContext& rc) {
+                    uploadBakedPrimitive(*baked, *job->model, i, rc);
+                });
             }
-            else if (ext == ".gltf" || ext == ".glb")
+        }
+
+        void ModelLoader::loadTexturesAsync(const std::shared_ptr<Job>&               job,
+                                            const std::vector<std::filesystem::path>& texturePaths)
+        {
+            // The texture cache lives on the GL thread, only decode what is not cached yet
+            job->model->textures.resize(texturePaths.size());
+            for (uint32_t i = 0; i < texturePaths.size(); ++i)
             {
-                return loadGLTF(modelPath, model, rc, scale);
+                if (texturePaths[i].empty())
+                    continue;
+
+                const auto texturePath = job->path.parent_path() / texturePaths[i];
+                submitTask(job, [this, job, i, texturePath] {
+                    // Lookups are thread safe, only what is not loaded yet goes through the GL thread
+                    if (auto texture = getTextureManager().find(texturePath))
+                    {
+                        job->model->textures[i] = std::move(texture);
+                        return;
+                    }
+
+                    const auto upload = [&](auto image) {
+                        postUpload(job, [job, i, texturePath, image](renderer::RenderContext& rc) {
+                            job->model->textures[i] = createTexture(texturePath, *image, rc);
+                        });
+                    };
+                    if (isCompressedImage(texturePath))
+                        upload(std::make_shared<CompressedImage>(readCompressedImage(texturePath)));
+                    else
+                        upload(std::make_shared<DecodedImage>(decodeImage(texturePath, false)));
+                });
             }
+        }
 
-            return false;
+        void ModelLoader::onPrimitivePrepared(const std::shared_ptr<Job>& job, uint32_t index)
+        {
+            const auto upload = [this, &job](uint32_t i) {
+                postUpload(job, [job, i](renderer::RenderContext& rc) { job->model->meshPrimitives[i].upload(rc); });
+            };
+
+            if (!job->bake)
+            {
+                upload(index);
+                return;
+            }
+
+            // The last one bakes, nothing has been uploaded (and freed) yet
+            if (--job->numUnbakedPrimitives == 0)
+            {
+                bakeModel(job->path, *job->model, job->texturePaths, job->dependencies);
+                for (uint32_t i = 0; i < job->model->meshPrimitives.size(); ++i)
+                    upload(i);
+            }
         }
     } // namespace io
 
@@ -4057,6 +10360,8 @@ namespace vgfw
     {
         if (renderer::isLoaded())
         {
+            // Models (and their handles) may still be around, the textures go with the context
+            io::getTextureManager().clear(renderer::getRenderContext());
             renderer::shutdown();
         }
 
@@ -12,6 +12,10 @@ option("examples") -- build examples?
     set_default(true)
 option_end()
 
+option("benchmarks") -- build benchmarks? (they need a GPU to run)
+    set_default(false)
+option_end()
+
 -- if build on windows
 if is_plat("windows") then
     add_cxxflags("/EHsc")
@@ -58,7 +62,7 @@ rule("imguiconfig")
 rule_end()
 
 rule("preprocess_shaders")
-    set_extensions(".vert", ".frag", ".geom", ".glsl")
+    set_extensions(".vert", ".frag", ".geom", ".comp", ".glsl")
 
     on_build_file(function (target, sourcefile, opt) end)
 
@@ -116,3 +120,8 @@ target("vgfw")
 if has_config("examples") then
     includes("examples")
 end
+
+-- if build benchmarks, then include benchmarks
+if has_config("benchmarks") then
+    includes("benchmarks")
+end